@@ -0,0 +1,100 @@
+/**
+ * @file cull_bench.cpp
+ * @brief Micro-benchmark: SIMD frustum culling of bounding spheres vs. the scalar per-sphere test.
+ *
+ * Usage: ./cull-bench
+ * Scatters 1k, 100k and 1M spheres (an asteroid belt around a camera looking along it), then
+ * prints time per frame and per sphere for both paths, the visible fraction, and the number of
+ * spheres on which the two paths disagree (only possible for spheres exactly touching a plane).
+ */
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustum.h"
+
+#include <algorithm> // For std::min
+#include <chrono>    // For timing
+#include <cmath>     // For cos, sin
+#include <cstdio>    // For printf
+#include <random>    // For generating spheres
+#include <vector>
+
+/**
+ * @brief Runs @p fn repeatedly for at least ~0.5 s and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    auto start = clock::now();
+    int runs = 0;
+    while (runs < 5 || std::chrono::duration<double>(clock::now() - start).count() < 0.5)
+    {
+        auto t0 = clock::now();
+        fn(runs);
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        ++runs;
+    }
+    return best;
+}
+
+int main()
+{
+    std::printf("Cull kernel backend: %s\n", cullKernelBackend());
+    std::printf("%10s %16s %16s %14s %14s %9s %9s %10s\n",
+                "spheres", "scalar ms/frame", "simd ms/frame", "scalar ns/obj", "simd ns/obj", "speedup", "visible", "mismatch");
+
+    // Camera inside the belt, looking along it, with the application's projection
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(30.0f, 2.0f, 0.0f), glm::vec3(30.0f, 0.0f, 30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::fromMatrix(projection * view);
+
+    for (size_t count : {size_t(1000), size_t(100000), size_t(1000000)})
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f), belt(25.0f, 40.0f), height(-1.0f, 1.0f), size(0.01f, 0.2f);
+        std::vector<glm::vec4> spheres(count); // Center, radius (AoS, as the scalar path would read them)
+        SphereBatch batch;
+        batch.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float a = angle(rng), r = belt(rng);
+            spheres[i] = glm::vec4(r * std::cos(a), height(rng), r * std::sin(a), size(rng));
+            batch.set(i, glm::vec3(spheres[i]), spheres[i].w);
+        }
+
+        std::vector<unsigned int> scalarVisible, simdVisible;
+        scalarVisible.reserve(count);
+        simdVisible.reserve(count);
+        double scalarMs = timeBest([&](int)
+                                   {
+                                       scalarVisible.clear();
+                                       for (size_t i = 0; i < count; ++i)
+                                       {
+                                           if (frustum.intersects(glm::vec3(spheres[i]), spheres[i].w))
+                                               scalarVisible.push_back(static_cast<unsigned int>(i));
+                                       } });
+        double simdMs = timeBest([&](int)
+                                 { cullSphereBatch(frustum, batch, simdVisible); });
+
+        // Both lists are ascending: count the indices in only one of them
+        size_t mismatch = 0;
+        for (size_t a = 0, b = 0; a < scalarVisible.size() || b < simdVisible.size();)
+        {
+            if (b == simdVisible.size() || (a < scalarVisible.size() && scalarVisible[a] < simdVisible[b]))
+                ++a, ++mismatch;
+            else if (a == scalarVisible.size() || simdVisible[b] < scalarVisible[a])
+                ++b, ++mismatch;
+            else
+                ++a, ++b;
+        }
+
+        std::printf("%10zu %16.3f %16.3f %14.2f %14.2f %8.2fx %8.1f%% %10zu\n",
+                    count, scalarMs, simdMs, scalarMs * 1e6 / count, simdMs * 1e6 / count, scalarMs / simdMs,
+                    100.0 * simdVisible.size() / count, mismatch);
+    }
+    return 0;
+}
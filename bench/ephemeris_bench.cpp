@@ -0,0 +1,321 @@
+/**
+ * @file ephemeris_bench.cpp
+ * @brief Micro-benchmark: batched SPK ephemeris evaluation for the ephemeris scenario's bodies.
+ *
+ * Usage: ./ephemeris-bench [file.bsp | --check]
+ * Without a file, writes a synthetic DE-like SPK file (type 2 segments for the planets, the
+ * Earth-Moon system and the Sun, fitted to known circular orbits), checks the evaluated positions
+ * against the exact orbits, and removes the file again. With a file, only timings are printed.
+ * Times one evaluate() of all bodies per "frame" (time advancing by one day per second at 60 fps)
+ * and with random times (a segment search and cold record on every call). Also checks that the
+ * Earth's ephemeris orbit, mapped into the scene as the hierarchy does, turns the same way as a
+ * prograde Kepler orbit and a circular orbit (exits with an error otherwise). With --check, the
+ * synthetic file is used and the timings are skipped (registered with CTest).
+ */
+
+#include "ephemeris.h"
+#include "kepler.h"
+#include "orbit_kernel.h"
+#include "scene_frame.h"
+#include "spk_file.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm> // For std::min, std::max
+#include <chrono>    // For timing
+#include <cmath>     // For sin, cos, sqrt
+#include <cstdint>   // For std::int32_t
+#include <cstdio>    // For printf, fopen
+#include <cstring>   // For std::memcpy, strcmp
+#include <random>    // For random times
+#include <vector>
+
+static const double PI = 3.14159265358979323846;
+static const double DAY = 86400.0;
+static const size_t COEFFICIENTS = 14; // Per coordinate, as for most bodies in DE440
+
+/** @brief A synthetic circular orbit of @p target around @p center. */
+struct SyntheticOrbit
+{
+    int target, center;
+    double radius;       // km
+    double periodDays;   // Orbital period
+    double inclination;  // Radians, about the X axis
+    double intervalDays; // Record length
+};
+
+static const SyntheticOrbit ORBITS[] = {
+    {1, 0, 5.79e7, 87.97, 0.12, 8.0},      // Mercury barycenter
+    {2, 0, 1.082e8, 224.7, 0.06, 16.0},    // Venus barycenter
+    {3, 0, 1.496e8, 365.25, 0.41, 16.0},   // Earth-Moon barycenter (equatorial frame: tilted ecliptic)
+    {4, 0, 2.279e8, 687.0, 0.43, 32.0},    // Mars barycenter
+    {5, 0, 7.785e8, 4332.6, 0.42, 32.0},   // Jupiter barycenter
+    {6, 0, 1.4335e9, 10759.2, 0.44, 32.0}, // Saturn barycenter
+    {7, 0, 2.8725e9, 30688.5, 0.41, 32.0}, // Uranus barycenter
+    {8, 0, 4.4951e9, 60182.0, 0.42, 32.0}, // Neptune barycenter
+    {10, 0, 1.0e6, 4332.6, 0.1, 16.0},     // Sun around the solar system barycenter
+    {199, 1, 0.0, 1.0, 0.0, 8.0},          // Mercury at its barycenter
+    {299, 2, 0.0, 1.0, 0.0, 16.0},         // Venus at its barycenter
+    {399, 3, 4.67e3, 27.32, 0.45, 4.0},    // Earth around the Earth-Moon barycenter
+    {301, 3, -3.797e5, 27.32, 0.45, 4.0},  // Moon, opposite the Earth
+};
+
+/** @brief Position of one synthetic orbit at @p et (seconds past J2000). */
+static void orbitPosition(const SyntheticOrbit &orbit, double et, double p[3])
+{
+    const double angle = 2.0 * PI * et / (orbit.periodDays * DAY);
+    p[0] = orbit.radius * std::cos(angle);
+    p[1] = orbit.radius * std::sin(angle) * std::cos(orbit.inclination);
+    p[2] = orbit.radius * std::sin(angle) * std::sin(orbit.inclination);
+}
+
+/** @brief Position of @p id relative to the solar system barycenter (0). */
+static void absolutePosition(int id, double et, double p[3])
+{
+    p[0] = p[1] = p[2] = 0.0;
+    while (id != 0)
+    {
+        for (const SyntheticOrbit &orbit : ORBITS)
+        {
+            if (orbit.target == id)
+            {
+                double q[3];
+                orbitPosition(orbit, et, q);
+                p[0] += q[0];
+                p[1] += q[1];
+                p[2] += q[2];
+                id = orbit.center;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Writes a DAF/SPK file with one type 2 segment per synthetic orbit covering
+ * [start, end], each record a Chebyshev interpolant through the exact orbit.
+ */
+static bool writeSyntheticSpk(const char *path, double start, double end)
+{
+    const std::uint16_t probe = 1;
+    const bool littleEndian = *reinterpret_cast<const unsigned char *>(&probe) == 1;
+    const size_t recordDoubles = 128;
+    const size_t orbitCount = sizeof(ORBITS) / sizeof(ORBITS[0]);
+
+    // Segment data, starting after the file, summary and name records (word 385)
+    std::vector<double> words;
+    std::vector<double> summaries;
+    for (const SyntheticOrbit &orbit : ORBITS)
+    {
+        const double interval = orbit.intervalDays * DAY;
+        const size_t records = static_cast<size_t>(std::ceil((end - start) / interval));
+        const size_t recordSize = 2 + 3 * COEFFICIENTS;
+        const size_t begin = 3 * recordDoubles + words.size() + 1;
+        for (size_t r = 0; r < records; ++r)
+        {
+            const double mid = start + (r + 0.5) * interval, radius = 0.5 * interval;
+            words.push_back(mid);
+            words.push_back(radius);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (size_t k = 0; k < COEFFICIENTS; ++k)
+                {
+                    double c = 0.0;
+                    for (size_t j = 0; j < COEFFICIENTS; ++j)
+                    {
+                        const double theta = PI * (j + 0.5) / COEFFICIENTS;
+                        double p[3];
+                        orbitPosition(orbit, mid + radius * std::cos(theta), p);
+                        c += p[axis] * std::cos(k * theta);
+                    }
+                    words.push_back(c * (k == 0 ? 1.0 : 2.0) / COEFFICIENTS);
+                }
+            }
+        }
+        words.push_back(start);
+        words.push_back(interval);
+        words.push_back(static_cast<double>(recordSize));
+        words.push_back(static_cast<double>(records));
+        const size_t last = 3 * recordDoubles + words.size();
+
+        std::int32_t ints[6] = {orbit.target, orbit.center, 1, 2, static_cast<std::int32_t>(begin), static_cast<std::int32_t>(last)};
+        double packed[3];
+        std::memcpy(packed, ints, sizeof(ints));
+        summaries.insert(summaries.end(), {start, end, packed[0], packed[1], packed[2]});
+    }
+
+    std::vector<double> file(3 * recordDoubles, 0.0);
+    unsigned char *header = reinterpret_cast<unsigned char *>(file.data());
+    const std::int32_t nd = 2, ni = 6, forward = 2, backward = 2;
+    const std::int32_t freeWord = static_cast<std::int32_t>(3 * recordDoubles + words.size() + 1);
+    std::memcpy(header, "DAF/SPK ", 8);
+    std::memcpy(header + 8, &nd, 4);
+    std::memcpy(header + 12, &ni, 4);
+    std::memset(header + 16, ' ', 60);
+    std::memcpy(header + 76, &forward, 4);
+    std::memcpy(header + 80, &backward, 4);
+    std::memcpy(header + 84, &freeWord, 4);
+    std::memcpy(header + 88, littleEndian ? "LTL-IEEE" : "BIG-IEEE", 8);
+    file[recordDoubles + 2] = static_cast<double>(orbitCount); // Summary record: next 0, previous 0, count
+    std::copy(summaries.begin(), summaries.end(), file.begin() + recordDoubles + 3);
+    std::memset(header + 2 * recordDoubles * sizeof(double), ' ', recordDoubles * sizeof(double)); // Name record
+    file.insert(file.end(), words.begin(), words.end());
+    file.resize((file.size() + recordDoubles - 1) / recordDoubles * recordDoubles, 0.0);
+
+    std::FILE *out = std::fopen(path, "wb");
+    if (!out)
+        return false;
+    const bool ok = std::fwrite(file.data(), sizeof(double), file.size(), out) == file.size();
+    return std::fclose(out) == 0 && ok;
+}
+
+/**
+ * @brief Y component of @p a x @p b: positive if the motion from @p a to @p b turns
+ * counterclockwise seen from +Y (prograde in the scene).
+ */
+static double turnAboutY(const glm::dvec3 &a, const glm::dvec3 &b)
+{
+    return a.z * b.x - a.x * b.z;
+}
+
+/**
+ * @brief Runs @p fn repeatedly for at least ~0.5 s and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    auto start = clock::now();
+    int runs = 0;
+    while (runs < 5 || std::chrono::duration<double>(clock::now() - start).count() < 0.5)
+    {
+        auto t0 = clock::now();
+        fn(runs);
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        ++runs;
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const char *syntheticPath = "ephemeris_bench.bsp";
+    const double start = -10.0 * 365.25 * DAY, end = 10.0 * 365.25 * DAY; // 1990 - 2010
+    const bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+    const bool synthetic = argc < 2 || checkOnly;
+    if (synthetic && !writeSyntheticSpk(syntheticPath, start, end))
+    {
+        std::printf("Cannot write %s\n", syntheticPath);
+        return 1;
+    }
+    auto file = std::make_shared<const SpkFile>(synthetic ? syntheticPath : argv[1]);
+    if (!file->isOpen())
+        return 1;
+
+    // The bodies of the ephemeris scenario, relative to their scene parents
+    const int pairs[][2] = {{199, 10}, {299, 10}, {399, 10}, {301, 399}, {4, 10}, {5, 10}, {6, 10}, {7, 10}, {8, 10}};
+    EphemerisBatch batch(file);
+    std::vector<int> targets, centers;
+    for (const auto &pair : pairs)
+    {
+        if (batch.add(pair[0], pair[1]))
+        {
+            targets.push_back(pair[0]);
+            centers.push_back(pair[1]);
+        }
+    }
+    const size_t bodies = batch.size();
+    std::printf("%zu segments, %zu bodies\n", file->segments().size(), bodies);
+    if (bodies == 0)
+        return 1;
+    std::vector<double> x(bodies), y(bodies), z(bodies);
+
+    // Random times across the whole coverage
+    const int frames = 10000;
+    std::mt19937 rng(3);
+    const double coverageStart = file->segments().front().startTime, coverageEnd = file->segments().front().endTime;
+    std::uniform_real_distribution<double> anyTime(coverageStart, coverageEnd);
+    std::vector<double> times(frames);
+    for (double &t : times)
+        t = anyTime(rng);
+
+    if (!checkOnly)
+    {
+        // Sequential frames: one day per second at 60 fps, as in the scenario
+        const double frameStep = DAY / 60.0;
+        double frameMs = timeBest([&](int run)
+                                  {
+                                      double et = run * frames * frameStep;
+                                      for (int f = 0; f < frames; ++f, et += frameStep)
+                                          batch.evaluate(et, x.data(), y.data(), z.data()); });
+        std::printf("Per frame:   %.1f ns/evaluate, %.1f ns/body\n", frameMs * 1e6 / frames, frameMs * 1e6 / frames / bodies);
+
+        double randomMs = timeBest([&](int)
+                                   {
+                                       for (int f = 0; f < frames; ++f)
+                                           batch.evaluate(times[f], x.data(), y.data(), z.data()); });
+        std::printf("Random time: %.1f ns/evaluate, %.1f ns/body\n", randomMs * 1e6 / frames, randomMs * 1e6 / frames / bodies);
+    }
+
+    // Sense of rotation of the three orbit paths over a short step, in scene coordinates
+    const auto earth = std::find(targets.begin(), targets.end(), 399);
+    if (earth != targets.end())
+    {
+        const size_t b = static_cast<size_t>(earth - targets.begin());
+        const double et = 0.5 * (coverageStart + coverageEnd);
+        batch.evaluate(et, x.data(), y.data(), z.data());
+        const glm::dvec3 before = equatorialToScene(x[b], y[b], z[b]);
+        batch.evaluate(et + DAY, x.data(), y.data(), z.data());
+        const glm::dvec3 after = equatorialToScene(x[b], y[b], z[b]);
+
+        KeplerElements elements;
+        elements.semiMajorAxis = 10.0f;
+        elements.meanMotion = 0.5f;
+        double position[3], velocity[3];
+        keplerStateAt(elements, elements.meanMotion, 0.0, position, velocity);
+        const glm::dvec3 keplerPosition(position[0], position[1], position[2]);
+        const glm::dvec3 keplerVelocity(velocity[0], velocity[1], velocity[2]);
+
+        OrbitBatch circular;
+        circular.resize(1);
+        circular.set(0, 10.0f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f);
+        float start[16], step[16];
+        evaluateOrbitBatch(circular, 0, start);
+        evaluateOrbitBatch(circular, SimClock::TICKS_PER_SECOND, step);
+
+        const double turns[3] = {turnAboutY(before, after), turnAboutY(keplerPosition, keplerPosition + keplerVelocity),
+                                 turnAboutY(glm::dvec3(start[12], start[13], start[14]), glm::dvec3(step[12], step[13], step[14]))};
+        std::printf("Orbit direction about +Y: ephemeris %s, Kepler %s, circular %s\n", turns[0] > 0.0 ? "prograde" : "retrograde",
+                    turns[1] > 0.0 ? "prograde" : "retrograde", turns[2] > 0.0 ? "prograde" : "retrograde");
+        if (!(turns[0] > 0.0 && turns[1] > 0.0 && turns[2] > 0.0))
+        {
+            if (synthetic)
+                std::remove(syntheticPath);
+            return 1;
+        }
+    }
+
+    if (synthetic)
+    {
+        // Interpolation error against the exact orbits, relative to each body's distance
+        double maxError = 0.0;
+        for (double et : times)
+        {
+            batch.evaluate(et, x.data(), y.data(), z.data());
+            for (size_t b = 0; b < bodies; ++b)
+            {
+                double t[3], c[3];
+                absolutePosition(targets[b], et, t);
+                absolutePosition(centers[b], et, c);
+                const double dx = x[b] - (t[0] - c[0]), dy = y[b] - (t[1] - c[1]), dz = z[b] - (t[2] - c[2]);
+                const double distance = std::sqrt((t[0] - c[0]) * (t[0] - c[0]) + (t[1] - c[1]) * (t[1] - c[1]) + (t[2] - c[2]) * (t[2] - c[2]));
+                maxError = std::max(maxError, std::sqrt(dx * dx + dy * dy + dz * dz) / distance);
+            }
+        }
+        std::printf("Max relative position error: %.3g\n", maxError);
+        std::remove(syntheticPath);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file kepler_bench.cpp
+ * @brief Micro-benchmark: batched Kepler solver vs. a scalar double-precision reference.
+ *
+ * Usage: ./kepler-bench
+ * For several eccentricity ranges, prints solves per second for the batch solver and for a
+ * conventional scalar Newton loop, the largest eccentric-anomaly and position errors against a
+ * fully converged double-precision solve, and the throughput of full position propagation.
+ */
+
+#include "kepler.h"
+
+#include <algorithm> // For std::max, std::min
+#include <chrono>    // For timing
+#include <cmath>     // For sin, cos, fabs, hypot
+#include <cstdio>    // For printf
+#include <random>    // For generating orbits
+#include <vector>
+
+/**
+ * @brief Reference solver: Newton's method in double precision until the step stops shrinking
+ * (the usual data-dependent loop the batch solver replaces).
+ */
+static double solveKeplerReference(double M, double e)
+{
+    double E = M + 0.85 * e * (M < 0.0 ? -1.0 : 1.0);
+    for (int iter = 0; iter < 50; ++iter)
+    {
+        double step = (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+        E -= step;
+        if (std::fabs(step) < 1e-15)
+            break;
+    }
+    return E;
+}
+
+/**
+ * @brief Runs @p fn repeatedly for at least ~0.5 s and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    auto start = clock::now();
+    int runs = 0;
+    while (runs < 5 || std::chrono::duration<double>(clock::now() - start).count() < 0.5)
+    {
+        auto t0 = clock::now();
+        fn(runs);
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        ++runs;
+    }
+    return best;
+}
+
+int main()
+{
+    const size_t count = 1000000;
+    std::printf("Kepler solver: %d Halley iterations, %zu solves per run\n", KEPLER_ITERATIONS, count);
+    std::printf("%10s %16s %16s %12s %14s\n",
+                "e range", "batch Msolves/s", "scalar Msolves/s", "max |dE|", "max |dr|/a");
+
+    for (float maxE : {0.1f, 0.5f, 0.9f, KeplerBatch::MAX_ECCENTRICITY})
+    {
+        // Uniform mean anomalies; eccentricities up to maxE, with a share exactly at maxE and
+        // near periapsis, where the solve is hardest
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<float> M(count), e(count), E(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            M[i] = (2.0f * unit(rng) - 1.0f) * 3.14159265f;
+            e[i] = i % 4 == 0 ? maxE : maxE * unit(rng);
+            if (i % 16 == 0)
+                M[i] *= 1e-3f;
+        }
+
+        double batchMs = timeBest([&](int)
+                                  { solveKeplerBatch(M.data(), e.data(), E.data(), count); });
+        std::vector<double> reference(count);
+        double scalarMs = timeBest([&](int)
+                                   {
+                                       for (size_t i = 0; i < count; ++i)
+                                           reference[i] = solveKeplerReference(M[i], e[i]); });
+
+        // Errors against the converged reference; position error in units of a (perifocal plane)
+        double maxAnomalyErr = 0.0, maxPositionErr = 0.0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double ecc = e[i], b = std::sqrt(1.0 - ecc * ecc);
+            double dx = (std::cos(E[i]) - ecc) - (std::cos(reference[i]) - ecc);
+            double dy = b * (std::sin(E[i]) - std::sin(reference[i]));
+            maxAnomalyErr = std::max(maxAnomalyErr, std::fabs(E[i] - reference[i]));
+            maxPositionErr = std::max(maxPositionErr, std::hypot(dx, dy));
+        }
+
+        std::printf("  0..%-5.2f %16.1f %16.1f %12.3g %14.3g\n", maxE,
+                    count / batchMs * 1e-3, count / scalarMs * 1e-3, maxAnomalyErr, maxPositionErr);
+    }
+
+    // Full propagation (fixed-point mean anomaly + solve + orientation) for an asteroid belt
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        KeplerBatch batch;
+        batch.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            KeplerElements el;
+            el.semiMajorAxis = 18.0f + 6.0f * unit(rng);
+            el.eccentricity = 0.3f * unit(rng);
+            el.inclination = 0.3f * unit(rng);
+            el.ascendingNode = 6.2831853f * unit(rng);
+            el.argumentOfPeriapsis = 6.2831853f * unit(rng);
+            el.meanAnomalyAtEpoch = 6.2831853f * unit(rng);
+            el.meanMotion = 0.1f + 0.2f * unit(rng);
+            batch.set(i, el);
+        }
+        std::vector<float> x(batch.paddedSize()), y(batch.paddedSize()), z(batch.paddedSize());
+        const SimClock::Ticks frameTicks = SimClock::toTicks(0.016);
+        double propagateMs = timeBest([&](int run)
+                                      { evaluateKeplerBatchRange(batch, run * frameTicks, x.data(), y.data(), z.data(), 0, count); });
+        std::printf("Propagation: %zu orbits in %.3f ms (%.2f ns/orbit)\n", count, propagateMs, propagateMs * 1e6 / count);
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file lod_bench.cpp
+ * @brief Micro-benchmark: BodyRenderer::prepareFrame() (culling, level selection, ordering and
+ * uploads), with a check that the indirect draw commands follow every level change.
+ *
+ * Usage: ./lod-bench [bodies | --check]
+ * Runs without a display through the headless EGL context (see headless_context.h); needs an
+ * OpenGL 4.3 context for the indirect path. First zooms the camera from far away onto a single
+ * body and back out again, reading the command buffer back after every frame: the one drawn
+ * instance must be in the command of the body's current level. Then times prepareFrame() for
+ * 1,000 bodies (by default) scattered around a moving camera. Prints the level changes seen,
+ * the number of frames whose commands did not match, and microseconds per frame. With --check,
+ * only the zoom runs (registered with CTest); the exit code is 1 if any frame did not match.
+ */
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "body_renderer.h"
+#include "gl_indirect.h"
+#include "headless_context.h"
+#include "stream_buffer.h"
+
+#include <algorithm> // For std::min, std::max
+#include <chrono>    // For timing
+#include <cmath>     // For cos, sin
+#include <cstdio>    // For printf
+#include <cstdlib>   // For atoi
+#include <cstring>   // For strcmp
+#include <random>    // For scattering the bodies
+#include <vector>
+
+/**
+ * @brief Runs @p fn repeatedly for at least ~0.5 s and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    auto start = clock::now();
+    int runs = 0;
+    while (runs < 5 || std::chrono::duration<double>(clock::now() - start).count() < 0.5)
+    {
+        auto t0 = clock::now();
+        fn(runs);
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        ++runs;
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+    const int bodies = argc > 1 && !checkOnly ? std::max(1, std::atoi(argv[1])) : 1000;
+
+    HeadlessContext context;
+    if (!context.create(4, 3))
+    {
+        std::printf("Cannot create an OpenGL 4.3 context\n");
+        return 1;
+    }
+    const GLADloadproc load = (GLADloadproc)HeadlessContext::getProcAddress;
+    if (!gladLoadGLLoader(load) || !loadIndirectDraw(load))
+    {
+        std::printf("Cannot load OpenGL 4.3\n");
+        return 1;
+    }
+    loadBufferStorage(load);
+
+    // A 1080p view along -Z; the eye is placed by moving the bodies (camera-relative rendering)
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::fromMatrix(projection * view);
+    const float pixelScale = projection[1][1] * 0.5f * 1080.0f;
+    const std::vector<unsigned int> chain = Planet::lodChain(8, 256);
+
+    // Zoom check: one body of radius 1, from 5000 units down to 1.2 and back
+    {
+        BodyRenderer renderer(chain, true, 0.5f);
+        renderer.setInstances({{0, 0, false}});
+        renderer.updateTransforms({glm::mat4(1.0f)}, {glm::dvec3(0.0)});
+        std::vector<double> distances;
+        for (double d = 5000.0; d > 1.2; d *= 0.9)
+            distances.push_back(d);
+        for (size_t i = distances.size(); i-- > 0;)
+            distances.push_back(distances[i]);
+
+        int frames = 0, mismatches = 0, levelChanges = 0;
+        size_t lastLevel = chain.size();
+        for (double d : distances)
+        {
+            renderer.prepareFrame(frustum, glm::dvec3(0.0, 0.0, d), pixelScale);
+            const std::vector<DrawElementsIndirectCommand> commands = renderer.writtenCommands();
+            size_t drawn = 0, level = chain.size();
+            for (size_t l = 0; l < commands.size(); ++l)
+            {
+                drawn += commands[l].instanceCount;
+                if (commands[l].instanceCount > 0)
+                    level = l;
+            }
+            // Exactly one instance, in slot 0, with the triangles the renderer counted for it
+            const bool match = drawn == 1 && level < commands.size() && commands[level].baseInstance == 0 &&
+                               commands[level].count / 3 == renderer.triangleCount();
+            mismatches += match ? 0 : 1;
+            if (match && level != lastLevel)
+            {
+                levelChanges += lastLevel < chain.size() ? 1 : 0;
+                lastLevel = level;
+            }
+            ++frames;
+        }
+        std::printf("Zoom: %d frames, %d level changes, %d frames with stale commands\n", frames, levelChanges, mismatches);
+        if (mismatches > 0 || levelChanges == 0)
+            return 1;
+    }
+    if (checkOnly)
+        return 0;
+
+    // Timing: bodies scattered in a belt around the camera, which moves every frame (full upload)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f), distance(20.0f, 400.0f), height(-10.0f, 10.0f), size(0.1f, 5.0f);
+        std::vector<BodyInstance> instances;
+        std::vector<glm::mat4> worlds;
+        std::vector<glm::dvec3> positions;
+        for (int b = 0; b < bodies; ++b)
+        {
+            const float a = angle(rng), r = distance(rng);
+            instances.push_back({b, 0, false});
+            worlds.push_back(glm::scale(glm::mat4(1.0f), glm::vec3(size(rng))));
+            positions.push_back(glm::dvec3(r * std::cos(a), height(rng), r * std::sin(a)));
+        }
+        BodyRenderer renderer(chain, true, 0.5f);
+        renderer.setInstances(instances);
+        renderer.updateTransforms(worlds, positions);
+        const double ms = timeBest([&](int run)
+                                   { renderer.prepareFrame(frustum, glm::dvec3(0.0, 0.0, 0.01 * run), pixelScale); });
+        std::printf("prepareFrame: %d bodies, %zu visible, %zu triangles, %.1f us/frame\n", bodies,
+                    renderer.visibleCount(), renderer.triangleCount(), ms * 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file nbody_bench.cpp
+ * @brief Micro-benchmark: Barnes-Hut tree build and force evaluation for a particle belt.
+ *
+ * Usage: ./nbody-bench [particles] [threads]
+ * For several opening angles, prints the tree build time, the force evaluation time and the
+ * relative force error against a direct pairwise sum over a sample of particles.
+ * Defaults: 1,000,000 particles, one thread per hardware thread.
+ */
+
+#include "barnes_hut.h"
+#include "thread_pool.h"
+
+#include <algorithm> // For std::min, std::max
+#include <chrono>    // For timing
+#include <cmath>     // For sin, cos, sqrt
+#include <cstdio>    // For printf
+#include <cstdlib>   // For atoi
+#include <random>    // For generating the belt
+#include <vector>
+
+/**
+ * @brief Runs @p fn a few times and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn, int runs = 3)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    for (int run = 0; run < runs; ++run)
+    {
+        auto t0 = clock::now();
+        fn();
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(std::max(1, std::atoi(argv[1]))) : 1000000;
+    ThreadPool pool(argc > 2 ? static_cast<unsigned int>(std::max(0, std::atoi(argv[2]))) : 0);
+    const double softening = 0.01;
+
+    // A flat belt like the asteroid_belt scenario (a = 17..22, thin in Y), equal masses
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> x(count), y(count), z(count), m(count, 250e-6 / count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        double r = 17.0 + 5.0 * unit(rng), angle = 6.283185307 * unit(rng);
+        x[i] = r * std::cos(angle);
+        y[i] = 1.5 * (unit(rng) - 0.5);
+        z[i] = r * std::sin(angle);
+    }
+    std::vector<double> ax(count), ay(count), az(count);
+
+    // Direct-sum reference for ~500 sampled particles
+    const size_t stride = count / 500 + 1;
+    std::vector<double> refX, refY, refZ;
+    for (size_t i = 0; i < count; i += stride)
+    {
+        double sx = 0.0, sy = 0.0, sz = 0.0;
+        for (size_t j = 0; j < count; ++j)
+        {
+            double dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+            double r2 = dx * dx + dy * dy + dz * dz + softening * softening;
+            double f = j == i ? 0.0 : m[j] / (r2 * std::sqrt(r2));
+            sx += f * dx;
+            sy += f * dy;
+            sz += f * dz;
+        }
+        refX.push_back(sx);
+        refY.push_back(sy);
+        refZ.push_back(sz);
+    }
+
+    std::printf("Barnes-Hut: %zu particles, %u threads\n", count, pool.threadCount());
+    std::printf("%6s %10s %10s %10s %12s %12s\n", "theta", "nodes", "build ms", "force ms", "mean error", "max error");
+    for (double theta : {0.3, 0.5, 0.6, 0.8})
+    {
+        BarnesHutTree tree(theta, softening, 32);
+        double buildMs = timeBest([&]
+                                  { tree.build(x.data(), y.data(), z.data(), m.data(), count, &pool); });
+        double forceMs = timeBest([&]
+                                  { tree.accelerations(ax.data(), ay.data(), az.data(), &pool); });
+
+        double sumError = 0.0, maxError = 0.0;
+        for (size_t s = 0; s < refX.size(); ++s)
+        {
+            size_t i = s * stride;
+            double dx = ax[i] - refX[s], dy = ay[i] - refY[s], dz = az[i] - refZ[s];
+            double error = std::sqrt(dx * dx + dy * dy + dz * dz) /
+                           std::sqrt(refX[s] * refX[s] + refY[s] * refY[s] + refZ[s] * refZ[s]);
+            sumError += error;
+            maxError = std::max(maxError, error);
+        }
+        std::printf("%6.2f %10zu %10.2f %10.2f %12.3g %12.3g\n", theta, tree.nodeCount(), buildMs, forceMs,
+                    sumError / refX.size(), maxError);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file orbit_bench.cpp
+ * @brief Micro-benchmark: batch orbit kernel vs. the per-body glm translate/rotate/scale path.
+ *
+ * Usage: ./orbit-bench
+ * Prints time per frame and per body for 1k, 100k and 1M bodies, plus the largest
+ * element-wise difference between the two paths.
+ */
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "orbit_kernel.h"
+
+#include <algorithm> // For std::max, std::min
+#include <chrono>    // For timing
+#include <cmath>     // For cos, sin, fabs
+#include <cstdio>    // For printf
+#include <random>    // For generating bodies
+#include <vector>
+
+/**
+ * @struct BodyParams
+ * @brief AoS body parameters, as the original render loop reads them from CelestialBody.
+ */
+struct BodyParams
+{
+    float orbitRadius;
+    float orbitSpeed;
+    float rotationSpeed;
+    glm::vec3 rotationAxis;
+    float radius;
+};
+
+/**
+ * @brief Reference path: the per-body glm code the render loop used before the batch kernel
+ * (with the orbit direction of scene_frame.h).
+ */
+static void evaluateGlm(const std::vector<BodyParams> &bodies, float simTime, std::vector<glm::mat4> &out)
+{
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        const BodyParams &body = bodies[i];
+        glm::mat4 orbitTranslation = glm::mat4(1.0f);
+        if (body.orbitRadius > 0.0f)
+        {
+            float orbitAngle = simTime * body.orbitSpeed;
+            orbitTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(cos(orbitAngle) * body.orbitRadius, 0.0f, -sin(orbitAngle) * body.orbitRadius));
+        }
+        glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), simTime * body.rotationSpeed, glm::normalize(body.rotationAxis));
+        glm::vec3 position = glm::vec3(orbitTranslation * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+        model = model * rotation;
+        model = glm::scale(model, glm::vec3(body.radius));
+        out[i] = model;
+    }
+}
+
+/**
+ * @brief Runs @p fn repeatedly for at least ~0.5 s and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    auto start = clock::now();
+    int runs = 0;
+    while (runs < 5 || std::chrono::duration<double>(clock::now() - start).count() < 0.5)
+    {
+        auto t0 = clock::now();
+        fn(runs);
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        ++runs;
+    }
+    return best;
+}
+
+int main()
+{
+    std::printf("Orbit kernel backend: %s\n", orbitKernelBackend());
+    std::printf("%10s %14s %14s %12s %12s %9s %12s\n",
+                "bodies", "glm ms/frame", "simd ms/frame", "glm ns/body", "simd ns/body", "speedup", "max |diff|");
+
+    for (size_t count : {size_t(1000), size_t(100000), size_t(1000000)})
+    {
+        // Random but plausible parameters (same distribution for both paths)
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<BodyParams> bodies(count);
+        OrbitBatch batch;
+        batch.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            BodyParams &b = bodies[i];
+            b.orbitRadius = 1.0f + 50.0f * std::fabs(unit(rng));
+            b.orbitSpeed = unit(rng);
+            b.rotationSpeed = 3.0f * unit(rng);
+            b.rotationAxis = glm::vec3(0.2f * unit(rng), 1.0f, 0.2f * unit(rng));
+            b.radius = 0.05f + std::fabs(unit(rng));
+            batch.set(i, b.orbitRadius, b.orbitSpeed, b.rotationSpeed,
+                      b.rotationAxis.x, b.rotationAxis.y, b.rotationAxis.z, b.radius);
+        }
+
+        std::vector<glm::mat4> glmOut(count), simdOut(count);
+        const float baseTime = 100.0f;
+        const SimClock::Ticks baseTicks = SimClock::toTicks(baseTime);
+        const SimClock::Ticks frameTicks = SimClock::toTicks(0.016);
+        double glmMs = timeBest([&](int run)
+                                { evaluateGlm(bodies, baseTime + run * 0.016f, glmOut); });
+        double simdMs = timeBest([&](int run)
+                                 { evaluateOrbitBatch(batch, baseTicks + run * frameTicks, &simdOut[0][0][0]); });
+
+        // Accuracy check at a common time
+        evaluateGlm(bodies, baseTime, glmOut);
+        evaluateOrbitBatch(batch, baseTicks, &simdOut[0][0][0]);
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+            for (int c = 0; c < 4; ++c)
+                for (int r = 0; r < 4; ++r)
+                    maxDiff = std::max(maxDiff, std::fabs(glmOut[i][c][r] - simdOut[i][c][r]));
+
+        std::printf("%10zu %14.3f %14.3f %12.2f %12.2f %8.2fx %12.3g\n",
+                    count, glmMs, simdMs, glmMs * 1e6 / count, simdMs * 1e6 / count, glmMs / simdMs, maxDiff);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file sim_bench.cpp
+ * @brief Benchmark: whole-simulation throughput through the headless core library (no window or GL).
+ *
+ * Usage: ./sim-bench [scenario] [belt particles] [threads], or ./sim-bench --check
+ * Loads a scenario ("solar_system" or "asteroid_belt", default asteroid_belt with 20,000 belt
+ * particles), then times Simulation::step() at the default 120 ticks per second for several
+ * time warps, and Simulation::seek() to random times. Prints milliseconds per call and the
+ * N-body energy drift at the end of each run. First checks that TransformHierarchy::positionsAt()
+ * (the N-body attractors' double-precision path) agrees with update() for every node; exits
+ * with 1 if it does not. With --check, only that check runs, for both scenarios (registered
+ * with CTest).
+ */
+
+#include "simulation.h"
+#include "hierarchy.h"
+#include "scenario.h"
+
+#include <algorithm> // For std::max
+#include <chrono>    // For timing
+#include <cstdio>    // For printf
+#include <cstdlib>   // For atoi
+#include <cstring>   // For strcmp
+#include <random>    // For the seek targets
+#include <string>
+#include <vector>
+
+/**
+ * @brief Partial evaluation of every node against the full update, at times far from the origin
+ * too; update() sums float local offsets, so the two agree to float precision.
+ */
+static bool partialEvaluationMatches(const Scenario &scenario)
+{
+    TransformHierarchy transforms(scenario);
+    std::vector<int> nodes(transforms.size());
+    for (size_t n = 0; n < nodes.size(); ++n)
+        nodes[n] = static_cast<int>(n);
+    TransformHierarchy::Selection all = transforms.select(nodes);
+    double worst = 0.0;
+    for (double seconds : {0.0, 12.5, -3.0e4, 7.0e6})
+    {
+        transforms.update(SimClock::toTicks(seconds));
+        transforms.positionsAt(SimClock::toTicks(seconds), all);
+        for (size_t n = 0; n < nodes.size(); ++n)
+        {
+            const glm::dvec3 &exact = all.position(n);
+            const double scale = std::max(1.0, glm::length(exact));
+            worst = std::max(worst, glm::length(exact - transforms.worldPositions()[n]) / scale);
+        }
+    }
+    std::printf("positionsAt vs update: max relative difference %.2e\n", worst);
+    return worst <= 1e-5;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--check") == 0)
+        return partialEvaluationMatches(loadScenario_SolarSystemBasic()) && partialEvaluationMatches(loadScenario_AsteroidBelt(0)) ? 0 : 1;
+
+    const std::string name = argc > 1 ? argv[1] : "asteroid_belt";
+    const size_t particles = argc > 2 ? static_cast<size_t>(std::max(0, std::atoi(argv[2]))) : 20000;
+    SimulationSettings settings;
+    settings.workerThreads = argc > 3 ? static_cast<unsigned int>(std::max(0, std::atoi(argv[3]))) : 0;
+
+    Scenario scenario = name == "solar_system" ? loadScenario_SolarSystemBasic() : loadScenario_AsteroidBelt(particles);
+
+    if (!partialEvaluationMatches(scenario))
+        return 1;
+
+    Simulation simulation(scenario, settings);
+    std::printf("%s: %zu bodies, %zu particles\n", name.c_str(), simulation.hierarchy().size(), simulation.particlePositions().size());
+    std::printf("%10s %10s %12s %12s %14s\n", "warp", "steps", "ms/step", "steps/s", "energy drift");
+
+    using clock = std::chrono::steady_clock;
+    const double tickInterval = 1.0 / 120.0;
+    const int steps = 600; // Five wall-clock seconds of ticks
+    for (double warp : {1.0, 10.0, 100.0, 1000.0})
+    {
+        simulation.seek(0.0);
+        simulation.setWarp(warp);
+        const auto start = clock::now();
+        for (int s = 0; s < steps; ++s)
+        {
+            simulation.step(tickInterval);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        std::printf("%10.0f %10d %12.3f %12.0f %14.2e\n", warp, steps, ms / steps, steps * 1000.0 / ms,
+                    simulation.nbodyStats().energyDrift);
+    }
+
+    // Seeks: analytic bodies are O(1) at any time; N-body state restarts at the target
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> anyTime(-1e6, 1e6);
+    const int seeks = 100;
+    const auto start = clock::now();
+    for (int s = 0; s < seeks; ++s)
+    {
+        simulation.seek(anyTime(rng));
+    }
+    const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::printf("seek: %.3f ms/call\n", ms / seeks);
+    return 0;
+}
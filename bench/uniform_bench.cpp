@@ -0,0 +1,133 @@
+/**
+ * @file uniform_bench.cpp
+ * @brief Micro-benchmark: CPU cost of setting uniforms per frame, with a location query per call
+ * (the former Shader setters), with the cached name lookup and with typed Uniform handles.
+ *
+ * Usage: ./uniform-bench [bodies]
+ * Needs a display (creates a hidden window for the GL context) and the shaders/ directory next
+ * to the executable, as copied by the solar-system build. Each "body" sets six uniforms, as many
+ * as the former per-body draw loop, on the ring shader (one mat3, two vec3, three float).
+ * Prints microseconds per frame and nanoseconds per set.
+ */
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+#include <algorithm> // For std::min, std::max
+#include <chrono>    // For timing
+#include <cstdio>    // For printf
+#include <cstdlib>   // For atoi
+
+/**
+ * @brief Runs @p fn repeatedly for at least ~0.5 s and returns the best time per call in milliseconds.
+ */
+template <typename Fn>
+static double timeBest(Fn fn)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e30;
+    auto start = clock::now();
+    int runs = 0;
+    while (runs < 5 || std::chrono::duration<double>(clock::now() - start).count() < 0.5)
+    {
+        auto t0 = clock::now();
+        fn();
+        auto t1 = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        ++runs;
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const int bodies = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow *window = glfwCreateWindow(64, 64, "uniform-bench", NULL, NULL);
+    if (!window)
+    {
+        std::printf("Cannot create an OpenGL 3.3 context\n");
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::printf("Cannot load OpenGL\n");
+        return 1;
+    }
+
+    Shader shader("shaders/ring.vert", "shaders/particle.frag");
+    shader.use();
+    const glm::mat3 basis(1.0f);
+    const glm::vec3 vector(0.5f);
+    const unsigned int id = shader.ID;
+
+    // Before: every set asks the driver for the location by name
+    const double queryMs = timeBest([&]
+                                    {
+                                        for (int b = 0; b < bodies; ++b)
+                                        {
+                                            glUniformMatrix3fv(glGetUniformLocation(id, "basis"), 1, GL_FALSE, &basis[0][0]);
+                                            glUniform3fv(glGetUniformLocation(id, "center"), 1, &vector[0]);
+                                            glUniform3fv(glGetUniformLocation(id, "color"), 1, &vector[0]);
+                                            glUniform1f(glGetUniformLocation(id, "innerRadius"), 1.0f);
+                                            glUniform1f(glGetUniformLocation(id, "outerRadius"), 2.0f);
+                                            glUniform1f(glGetUniformLocation(id, "pointSize"), 1.0f);
+                                        }
+                                        glFinish(); });
+
+    // Name-based setters: cached location, but a string and a hash lookup per set
+    const double cachedMs = timeBest([&]
+                                     {
+                                         for (int b = 0; b < bodies; ++b)
+                                         {
+                                             shader.setMat3("basis", basis);
+                                             shader.setVec3("center", vector);
+                                             shader.setVec3("color", vector);
+                                             shader.setFloat("innerRadius", 1.0f);
+                                             shader.setFloat("outerRadius", 2.0f);
+                                             shader.setFloat("pointSize", 1.0f);
+                                         }
+                                         glFinish(); });
+
+    // Typed handles: no string work at all
+    const Uniform<glm::mat3> basisHandle = shader.uniform<glm::mat3>("basis");
+    const Uniform<glm::vec3> center = shader.uniform<glm::vec3>("center");
+    const Uniform<glm::vec3> color = shader.uniform<glm::vec3>("color");
+    const Uniform<float> innerRadius = shader.uniform<float>("innerRadius");
+    const Uniform<float> outerRadius = shader.uniform<float>("outerRadius");
+    const Uniform<float> pointSize = shader.uniform<float>("pointSize");
+    const double handleMs = timeBest([&]
+                                     {
+                                         for (int b = 0; b < bodies; ++b)
+                                         {
+                                             shader.set(basisHandle, basis);
+                                             shader.set(center, vector);
+                                             shader.set(color, vector);
+                                             shader.set(innerRadius, 1.0f);
+                                             shader.set(outerRadius, 2.0f);
+                                             shader.set(pointSize, 1.0f);
+                                         }
+                                         glFinish(); });
+
+    const double sets = 6.0 * bodies;
+    std::printf("%d bodies, 6 uniforms each\n", bodies);
+    std::printf("%-28s %12s %12s\n", "", "us/frame", "ns/set");
+    std::printf("%-28s %12.1f %12.1f\n", "glGetUniformLocation + set", queryMs * 1e3, queryMs * 1e6 / sets);
+    std::printf("%-28s %12.1f %12.1f\n", "cached name lookup", cachedMs * 1e3, cachedMs * 1e6 / sets);
+    std::printf("%-28s %12.1f %12.1f\n", "typed handle", handleMs * 1e3, handleMs * 1e6 / sets);
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
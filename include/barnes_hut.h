@@ -0,0 +1,116 @@
+/**
+ * @file barnes_hut.h
+ * @brief Defines the BarnesHutTree class, a linear octree rebuilt every step from Morton-sorted
+ * particles and used to approximate mutual gravity in O(N log N).
+ */
+
+#ifndef BARNES_HUT_H
+#define BARNES_HUT_H
+
+#include <cstddef> // For size_t
+#include <cstdint> // For fixed-width integers
+#include <vector>  // For the node and particle arrays
+
+class ThreadPool; // Forward declaration (full definition in thread_pool.h)
+
+/**
+ * @class BarnesHutTree
+ * @brief Octree over a set of point masses, stored as one flat array in depth-first order.
+ *
+ * build() computes a 48-bit Morton code per particle (16 bits per axis inside the bounding cube),
+ * radix-sorts the particles by code, and creates the octree top-down from the sorted array: every
+ * node covers a contiguous range of sorted particles, and its children are the sub-ranges that
+ * share the next 3 code bits. Each node stores its subtree size, so traversal needs no stack or
+ * child pointers (skip a subtree by jumping ahead by its size).
+ *
+ * accelerations() walks the tree once per leaf, treating a node as a single point mass at its
+ * centre of mass when all of the leaf's particles are outside the node's opening radius
+ * (cell size / theta + distance between the centre of mass and the cell centre), and sums the
+ * resulting interaction list for each of the leaf's particles with SIMD.
+ * Masses are gravitational parameters (G*M), so G does not appear.
+ * Sorting, construction below the top levels and force evaluation all run on the ThreadPool.
+ */
+class BarnesHutTree
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param theta Opening angle in [0, 1]; smaller is more accurate and slower (0 = exact direct sum).
+     * @param softening Plummer softening length, avoids singular forces in close encounters.
+     * @param leafSize Maximum particles per leaf (leaves are summed directly).
+     */
+    explicit BarnesHutTree(double theta = 0.6, double softening = 0.01, size_t leafSize = 16);
+
+    /**
+     * @brief Rebuilds the tree for @p count particles given as parallel arrays.
+     * The arrays are copied (in Morton order); they are not referenced afterwards.
+     * @param pool Optional worker pool (nullptr = single-threaded).
+     */
+    void build(const double *x, const double *y, const double *z, const double *mass, size_t count, ThreadPool *pool);
+
+    /**
+     * @brief Computes the gravitational acceleration on the particles of the last build().
+     * Results are written in the original (unsorted) particle order.
+     * @param ax, ay, az Destination arrays with one entry per particle (overwritten for active particles).
+     * @param pool Optional worker pool (nullptr = single-threaded).
+     * @param active Optional per-particle flags (original order); only particles with a non-zero
+     *               flag are evaluated and written. nullptr = all particles.
+     * @param potential Optional destination for the (softened) gravitational potential per particle.
+     */
+    void accelerations(double *ax, double *ay, double *az, ThreadPool *pool,
+                       const std::uint8_t *active = nullptr, double *potential = nullptr) const;
+
+    /** @brief Number of particles in the last build(). */
+    size_t size() const { return order.size(); }
+
+    /** @brief Number of tree nodes in the last build(). */
+    size_t nodeCount() const { return nodes.size(); }
+
+private:
+    static constexpr int MAX_LEVEL = 16;  // Morton bits per axis; cells at this depth are always leaves
+    static constexpr int SPLIT_LEVEL = 2; // Depth whose (up to 64) subtrees are built in parallel
+
+    /** @brief One octree cell. Float is plenty for the approximation and halves the memory traffic. */
+    struct Node
+    {
+        float comX, comY, comZ;    // Centre of mass
+        float mass;                // Total mass (G*M) of the subtree
+        float openRadius2;         // Squared distance beyond which the node is treated as one mass
+        std::uint32_t subtreeSize; // Nodes in this subtree including itself (next sibling = index + subtreeSize)
+        std::uint32_t begin;       // First sorted particle
+        std::uint32_t count;       // Number of particles; leaves are nodes with subtreeSize == 1
+    };
+
+    /** @brief Subtrees built in parallel below SPLIT_LEVEL, spliced in by the sequential top-level build. */
+    struct Prebuilt
+    {
+        std::vector<size_t> begins;              // First sorted particle of each subtree (ascending)
+        std::vector<std::vector<Node>> subtrees; // The subtrees, in the same order
+    };
+
+    void sortByMortonCode(ThreadPool *pool);
+    void buildTopLevels(ThreadPool *pool);
+    void buildNode(std::vector<Node> &out, size_t begin, size_t end, int level, const Prebuilt *prebuilt) const;
+
+    double theta;
+    double softening2;
+    size_t leafSize;
+
+    // --- Bounding cube of the last build ---
+    double originX = 0.0, originY = 0.0, originZ = 0.0;
+    double cubeSize = 1.0;
+
+    // --- Particles in Morton order ---
+    std::vector<std::uint64_t> codes;  // Sorted Morton codes
+    std::vector<std::uint32_t> order;  // Sorted position -> original particle index
+    std::vector<float> px, py, pz, pm; // Sorted positions and masses
+
+    // --- Sort scratch (kept between builds to avoid reallocation) ---
+    std::vector<std::uint64_t> codeScratch;
+    std::vector<std::uint32_t> orderScratch;
+
+    std::vector<Node> nodes;            // Depth-first (pre-order) octree
+    std::vector<std::uint32_t> leaves; // Indices of the leaf nodes, in Morton order
+};
+
+#endif // BARNES_HUT_H
@@ -0,0 +1,208 @@
+/**
+ * @file body_renderer.h
+ * @brief Defines the BodyRenderer class, which draws every body as an instance of a shared
+ * level-of-detail chain of unit-sphere meshes.
+ */
+
+#ifndef BODY_RENDERER_H
+#define BODY_RENDERER_H
+
+#include <glad/glad.h> // OpenGL types
+#include <glm/glm.hpp> // Matrix types
+
+#include "frustum.h"       // For the bounding spheres and the culling kernel
+#include "gl_indirect.h"   // For the indirect command layout
+#include "planet.h"        // The shared sphere meshes
+#include "stream_buffer.h" // For the per-frame instance and command uploads
+
+#include <vector> // For the instance arrays
+
+class RenderQueue; // Forward declaration (full definition in render_queue.h)
+
+/**
+ * @struct BodyInstance
+ * @brief What BodyRenderer needs to know about one body.
+ */
+struct BodyInstance
+{
+    int node;           // Hierarchy node (index into the world matrices)
+    unsigned int layer; // Layer of the body texture array
+    bool emissive;      // Unlit (the Sun) instead of lit by it
+};
+
+/**
+ * @class BodyRenderer
+ * @brief Owns a level-of-detail chain of unit spheres (in shared buffers) and the per-instance
+ * buffer (model matrix and material, interleaved).
+ *
+ * Every body is a unit sphere scaled by its world matrix and every body texture is a layer of
+ * one array texture, so bodies differ only in per-instance data and the sphere they use.
+ * Each frame the bodies' bounding spheres are culled against the view frustum, and every
+ * visible body gets the coarsest level whose silhouette stays within the pixel error on screen.
+ * The visible instances are written to the instance buffer grouped by level, each group ordered
+ * from nearest to farthest, so the depth test rejects the hidden fragments of farther bodies
+ * before they are shaded. Each group is one draw command: with a GL 4.3 context the commands
+ * live in an indirect buffer and all bodies, lit and emissive, of every level go out with one
+ * glMultiDrawElementsIndirect; on GL 3.3 each group is one glDrawElementsInstanced and goes into
+ * the RenderQueue with the depth of its nearest body. shaders/lighting.vert reads the model
+ * matrix as vertex attributes 3-6, the material as attribute 7 and the normal matrix as
+ * attributes 8-10. The normal matrices are only computed while some body is scaled
+ * non-uniformly; otherwise the UNIFORM_SCALE variant of the shader derives the normals from the
+ * model matrix and the attributes are left unread. Rendering is camera-relative: each model
+ * matrix gets the body's double-precision world position minus the eye as its translation, so
+ * the instance data stays small floats however far the bodies are from the world origin.
+ *
+ * A body switches to a finer level as soon as its current one exceeds the error, but back to a
+ * coarser one only once that is well within it (LOD_HYSTERESIS), so a body at the boundary does
+ * not pop between two levels from frame to frame.
+ */
+class BodyRenderer
+{
+public:
+    static constexpr GLuint MODEL_ATTRIBUTE = 3;    // First per-instance matrix attribute location (one per column)
+    static constexpr GLuint MATERIAL_ATTRIBUTE = 7; // Per-instance texture layer and emissive flag
+    static constexpr GLuint NORMAL_ATTRIBUTE = 8;   // First per-instance normal matrix attribute location (one per column)
+    static constexpr float LOD_HYSTERESIS = 0.5f;   // A coarser level must be within this fraction of the error to be chosen
+
+    /**
+     * @brief Creates the shared spheres and the (empty) instance buffer.
+     * @param lodDetails Rings and sectors of each level, coarsest first (see Planet::lodChain()).
+     * @param indirect Use multi-draw-indirect (requires loadIndirectDraw() to have succeeded).
+     * @param pixelError Largest on-screen distance, in pixels, between a level and the true sphere.
+     */
+    BodyRenderer(const std::vector<unsigned int> &lodDetails, bool indirect, float pixelError);
+
+    /**
+     * @brief Destructor that cleans up the instance buffer (the spheres clean up after themselves).
+     */
+    ~BodyRenderer();
+
+    BodyRenderer(const BodyRenderer &) = delete;            // No copying
+    BodyRenderer &operator=(const BodyRenderer &) = delete; // No copying
+
+    /**
+     * @brief Sets the bodies to draw. Call once at load time.
+     */
+    void setInstances(const std::vector<BodyInstance> &bodies);
+
+    /**
+     * @brief Gathers the instances' model matrices and world positions (hierarchy node order).
+     * Only needed when the transforms changed; the upload happens in prepareFrame().
+     * @param worlds World matrix per node (rotation and scale; the translation is not used).
+     * @param positions World position per node in double precision.
+     */
+    void updateTransforms(const std::vector<glm::mat4> &worlds, const std::vector<glm::dvec3> &positions);
+
+    /**
+     * @brief Places the instances relative to @p eye, culls them against @p frustum, picks each
+     * visible instance's level, orders each level's instances front to back, and uploads them
+     * if the eye, the transforms or the visible order changed. Call once per frame, before enqueue().
+     * @param frustum Planes of the current projection * view (camera-relative view).
+     * @param eye Camera position in world space.
+     * @param pixelScale Pixels covered by a radius of one unit at a distance of one unit
+     *                   (projection[1][1] * viewport height / 2).
+     */
+    void prepareFrame(const Frustum &frustum, const glm::dvec3 &eye, float pixelScale);
+
+    /**
+     * @brief Adds the body draws to @p queue: one item on the indirect path, one per group
+     * otherwise. The renderer must outlive the queue's execute().
+     * @param queue Queue of the current frame.
+     * @param program The body shader (its per-frame uniforms come from the FrameData block).
+     * @param textures The body texture array.
+     */
+    void enqueue(RenderQueue &queue, unsigned int program, unsigned int textures) const;
+
+    /** @brief Number of instances. */
+    size_t instanceCount() const { return instanceNodes.size(); }
+
+    /** @brief Instances that passed the last prepareFrame()'s culling. */
+    size_t visibleCount() const { return order.size(); }
+
+    /** @brief Triangles drawn this frame. */
+    size_t triangleCount() const;
+
+    /** @brief Draw calls issued this frame. */
+    size_t drawCalls() const;
+
+    /**
+     * @brief True if every body is scaled uniformly (as of the last updateTransforms()), so it
+     * can be drawn with the UNIFORM_SCALE variant of shaders/lighting.vert.
+     */
+    bool uniformScale() const { return allUniform; }
+
+    /**
+     * @brief The draw commands the last prepareFrame() left in the command buffer, one per level
+     * (indirect path only, else empty). Reads GPU memory back; meant for checks, not per frame.
+     */
+    std::vector<DrawElementsIndirectCommand> writtenCommands() const;
+
+    /** @brief True if the bodies are drawn with multi-draw-indirect. */
+    bool usesIndirect() const { return indirect; }
+
+private:
+    /** @brief This frame's visible instances of one level, in consecutive buffer slots. */
+    struct Group
+    {
+        size_t slot = 0;      // First buffer slot
+        size_t visible = 0;   // Number of instances, from slot on
+        float nearest = 0.0f; // Distance from the eye to the nearest surface
+    };
+
+    /** @brief Layout of one instance in the instance buffer. */
+    struct InstanceData
+    {
+        glm::mat4 model;        // Attributes 3-6
+        glm::uvec2 material;    // Attribute 7: texture layer, emissive flag
+        glm::mat3 normalMatrix; // Attributes 8-10 (identity while every body is scaled uniformly)
+    };
+
+    /**
+     * @brief Level for a body covering @p pixelRadius pixels that used @p current last frame.
+     */
+    unsigned int selectLevel(unsigned int current, float pixelRadius) const;
+
+    /**
+     * @brief Uploads one DrawElementsIndirectCommand per group for this frame's slots and counts.
+     */
+    void uploadCommands();
+
+    /**
+     * @brief Issues the draws of the groups (all of them on the indirect path, else group
+     * @p group only). The spheres' VAO, the shader and the texture array must be bound.
+     */
+    void drawGroups(size_t group) const;
+
+    /**
+     * @brief Points the per-instance attributes at instance @p first of the latest instance
+     * region (GL 3.3 has no base instance). The spheres' VAO must be bound.
+     */
+    void pointInstanceAttributes(size_t first) const;
+
+    Planet spheres;                        // Shared unit spheres, one mesh per level, coarsest first
+    bool indirect;                         // Draw with glMultiDrawElementsIndirect
+    float pixelError;                      // Largest on-screen error of the chosen level, in pixels
+    std::vector<float> chordError;         // Per level: largest distance to the unit sphere
+    StreamBuffer instances;                // Per region: InstanceData per visible instance (attributes 3-10)
+    StreamBuffer commands;                 // Per region: one DrawElementsIndirectCommand per level (indirect path only)
+    std::vector<int> instanceNodes;        // Hierarchy node per instance
+    std::vector<glm::uvec2> materials;     // Texture layer and emissive flag per instance
+    std::vector<glm::mat4> models;         // Model matrix per instance (gathered by updateTransforms())
+    std::vector<glm::dvec3> positions;     // World position per instance (gathered by updateTransforms())
+    std::vector<float> radii;              // Bounding sphere radius per instance (longest model column)
+    std::vector<glm::mat3> normalMatrices; // Normal matrix per instance (only while allUniform is false)
+    bool allUniform = true;                // Every model matrix scales uniformly
+    std::vector<unsigned int> levels;      // Level per instance (kept between frames for the hysteresis)
+    SphereBatch bounds;                    // Camera-relative bounding sphere per instance
+    std::vector<Group> groups;             // This frame's draw groups, one per level
+    std::vector<Group> previousGroups;     // Scratch: last frame's groups (the commands are rewritten when they differ)
+    std::vector<unsigned int> visible;     // Scratch: instances that passed culling, ascending
+    std::vector<size_t> order;             // Visible instance at each buffer slot (by level, front to back within one)
+    std::vector<size_t> previousOrder;     // Scratch: last frame's order
+    std::vector<size_t> nextSlots;         // Scratch: next free buffer slot per level while ordering
+    std::vector<float> distances;          // Scratch: distance per instance for the sort
+    bool transformsDirty = true;           // Models changed since the last upload
+    glm::dvec3 lastEye = glm::dvec3(0.0);  // Eye of the last upload
+};
+
+#endif // BODY_RENDERER_H
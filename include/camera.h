@@ -37,16 +37,18 @@ const float ZOOM = 45.0f;       // Default Field of View (FOV) in degrees
  * An abstract camera class that processes input (keyboard, mouse movement, scroll)
  * and calculates the corresponding Euler Angles, direction vectors (Front, Up, Right),
  * and the View Matrix for use in OpenGL rendering. Also manages Field of View (Zoom).
+ * The position is kept in double precision and rendering is camera-relative: the view matrix
+ * only rotates, and everything drawn is positioned relative to Position on the CPU.
  */
 class Camera
 {
 public:
     // --- Camera Attributes ---
-    glm::vec3 Position; // Camera's world space position
-    glm::vec3 Front;    // Direction camera is facing (normalized)
-    glm::vec3 Up;       // Camera's local up direction (normalized)
-    glm::vec3 Right;    // Camera's local right direction (normalized)
-    glm::vec3 WorldUp;  // Global up direction (usually 0,1,0)
+    glm::dvec3 Position; // Camera's world space position (double precision)
+    glm::vec3 Front;     // Direction camera is facing (normalized)
+    glm::vec3 Up;        // Camera's local up direction (normalized)
+    glm::vec3 Right;     // Camera's local right direction (normalized)
+    glm::vec3 WorldUp;   // Global up direction (usually 0,1,0)
 
     // --- Euler Angles ---
     float Yaw;   // Horizontal rotation angle
@@ -76,9 +78,9 @@ public:
     // --- Core Functions ---
 
     /**
-     * @brief Calculates and returns the view matrix using the current camera position and orientation.
-     * Uses Euler Angles and the LookAt Matrix.
-     * @return The 4x4 view matrix.
+     * @brief Calculates and returns the camera-relative view matrix: the orientation only, with
+     * the camera at the origin. Uses Euler Angles and the LookAt Matrix.
+     * @return The 4x4 view matrix, for positions given relative to Position.
      */
     glm::mat4 GetViewMatrix();
 
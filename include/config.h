@@ -6,7 +6,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <string> // For std::string
+#include <optional> // For the options that may be unset
+#include <string>   // For std::string
 
 /**
  * @struct Config
@@ -18,6 +19,32 @@ struct Config
     int width = 800;              // Default window width
     int height = 600;             // Default window height
     bool startFullscreen = false; // Default to starting in windowed mode
+
+    // Render settings
+    bool multiDrawIndirect = true; // Try a GL 4.3 context and draw all bodies with one multi-draw-indirect call
+    float lodPixelError = 0.5f;    // Largest on-screen deviation (pixels) of a body's sphere mesh from the true sphere
+    bool reverseZ = false;         // 32-bit float depth with an infinite far plane (reverse-Z, else logarithmic depth)
+
+    // Simulation settings
+    int workerThreads = 0;                 // Threads for the transform update (0 = one per hardware thread)
+    double tickRate = 120.0;               // Fixed simulation ticks per second (independent of the frame rate)
+    double startTime = 0.0;                // Simulation time (seconds) at startup and after Home is pressed
+    std::string scenario = "solar_system"; // Scene to load: "solar_system", "asteroid_belt" or "ephemeris"
+
+    // N-body settings (used by scenarios with N-body bodies or particle belts)
+    int beltParticles = 20000;                // Particles in the asteroid belt scenario
+    std::string nbodyIntegrator = "leapfrog"; // "leapfrog" (2nd order) or "yoshida4" (4th order, 3x the force evaluations)
+    double nbodyTimestep = 0.1;               // Largest (base) integration step, in simulation seconds
+    int nbodyMaxSubsteps = 64;                // Most base steps per simulation tick
+    int nbodyMaxLevels = 6;                   // Most halvings of the base step for bodies in close encounters
+    double nbodyAccuracy = 0.05;              // Largest step as a fraction of each body's dynamical time
+    double nbodyTheta = 0.6;                  // Barnes-Hut opening angle (smaller = more accurate, slower)
+    double nbodySoftening = 0.01;             // Gravitational softening length, in scene units
+
+    // Ephemeris settings (used by the "ephemeris" scenario)
+    std::string ephemerisFile = "de440s.bsp"; // JPL SPK file (DE4xx planetary ephemeris)
+    double ephemerisStartDays = 0.0;          // Date shown at simulation time 0, in days past J2000 (2000-01-01 12:00 TDB)
+    double ephemerisDaysPerSecond = 1.0;      // Ephemeris days per simulation second (before time warp)
 };
 
 /**
@@ -28,4 +55,27 @@ struct Config
  */
 Config loadConfig(const std::string &filename);
 
+/**
+ * @struct LaunchOptions
+ * @brief Command-line options; they select the headless mode and override config.ini for one run.
+ */
+struct LaunchOptions
+{
+    bool headless = false;      // Render into an off-screen framebuffer without a window (--headless)
+    int width = 0;              // Render size in pixels (--size WxH; 0 = from config.ini)
+    int height = 0;             // Render size in pixels
+    int frames = 0;             // Frames to render before exiting (--frames N; 0 = no limit)
+    double duration = 0.0;      // Wall-clock seconds to run before exiting (--duration S; 0 = no limit)
+    std::optional<double> warp; // Initial time warp (--warp X; negative runs backwards; unset = the default)
+    std::string lockBody;       // Body the camera starts locked to (--lock Name; empty = free camera)
+    std::string outputFile;     // PPM image of the last frame, headless only (--output file.ppm)
+};
+
+/**
+ * @brief Parses the command line into @p options. Headless runs without --frames or
+ * --duration are limited to 300 frames.
+ * @return False (after printing the usage to std::cerr) on an unknown or malformed option.
+ */
+bool parseCommandLine(int argc, char **argv, LaunchOptions &options);
+
 #endif // CONFIG_H
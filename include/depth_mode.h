@@ -0,0 +1,76 @@
+/**
+ * @file depth_mode.h
+ * @brief Depth buffer setups. The standard one uses the default 24-bit depth buffer and a far
+ * plane; the other two render into a 32-bit float depth buffer (see SceneFramebuffer) with no
+ * far plane, so true-scale distances fit in one pass: reverse-Z through glClipControl, or,
+ * where that is missing, a logarithmic depth written by the shaders.
+ */
+
+#ifndef DEPTH_MODE_H
+#define DEPTH_MODE_H
+
+#include <glad/glad.h> // OpenGL types and GLADloadproc
+#include <glm/glm.hpp> // Matrix types
+
+#include <string> // For the shader defines
+
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
+
+// glClipControl (GL 4.5 / GL_ARB_clip_control) is not part of the bundled GL 3.3 loader
+typedef void(APIENTRYP PFNGLCLIPCONTROLPROC)(GLenum origin, GLenum depth);
+extern PFNGLCLIPCONTROLPROC solar_glClipControl;
+#define glClipControl solar_glClipControl
+
+/**
+ * @brief How depth is stored and compared.
+ */
+enum class DepthMode
+{
+    Standard,   // 24-bit fixed point, near and far plane, GL_LESS
+    ReverseZ,   // 32-bit float, infinite far plane mapped to 0 and the near plane to 1, GL_GREATER
+    Logarithmic // 32-bit float, infinite far plane, depth = log2(1 + w) / log2(1 + LOG_DEPTH_FAR), GL_LESS
+};
+
+const float LOG_DEPTH_FAR = 1e15f; // Distance mapped to depth 1 in the Logarithmic mode
+
+/**
+ * @brief Loads glClipControl if the context is GL 4.5 or newer or has GL_ARB_clip_control.
+ * Call after gladLoadGLLoader().
+ * @param load The loader passed to GLAD (e.g. glfwGetProcAddress).
+ * @return True if DepthMode::ReverseZ can be used.
+ */
+bool loadClipControl(GLADloadproc load);
+
+/**
+ * @brief Projection matrix for @p mode.
+ * @param fovy Vertical field of view in radians.
+ * @param aspect Viewport width / height.
+ * @param zNear Near plane distance.
+ * @param zFar Far plane distance (DepthMode::Standard only; the others have none).
+ */
+glm::mat4 depthProjection(DepthMode mode, float fovy, float aspect, float zNear, float zFar);
+
+/**
+ * @brief Sets the clip control, clear depth and depth function of @p mode. Call once, after
+ * loadClipControl() and with depth testing enabled.
+ */
+void applyDepthMode(DepthMode mode);
+
+/** @brief Depth function of the scene's draws (GL_LESS, or GL_GREATER for reverse-Z). */
+GLenum sceneDepthFunc(DepthMode mode);
+
+/** @brief Depth function of the skybox, which lies on the farthest depth (GL_LEQUAL or GL_GEQUAL). */
+GLenum skyDepthFunc(DepthMode mode);
+
+/**
+ * @brief Defines selecting the mode's code path in the shaders ("REVERSE_Z", or "LOG_DEPTH" and
+ * its scale); empty for DepthMode::Standard. Pass to the Shader constructor.
+ */
+std::string depthShaderDefines(DepthMode mode);
+
+/** @brief Human-readable name of @p mode, for the overlay. */
+const char *depthModeName(DepthMode mode);
+
+#endif // DEPTH_MODE_H
@@ -0,0 +1,81 @@
+/**
+ * @file ephemeris.h
+ * @brief Defines the EphemerisBatch class, which evaluates the positions of many bodies from an
+ * SpkFile in one allocation-free pass.
+ */
+
+#ifndef EPHEMERIS_H
+#define EPHEMERIS_H
+
+#include "spk_file.h" // For SpkFile::Segment
+
+#include <cstddef> // For size_t
+#include <memory>  // For std::shared_ptr
+#include <vector>  // For the SoA arrays
+
+/**
+ * @class EphemerisBatch
+ * @brief Positions of a fixed list of (target, center) pairs, evaluated together.
+ *
+ * SPK segments are chained: the Moon is given relative to the Earth-Moon barycenter, which is
+ * given relative to the solar system barycenter, and so on. add() resolves each requested pair
+ * into signed "links" (target -> center segment series) once, dropping the links the two
+ * chains share; links used by several bodies are evaluated only once.
+ *
+ * evaluate() then finds each link's record in O(1) (records cover equal intervals) and runs
+ * Clenshaw's recurrence for every link in lockstep: the degree loop is outermost and each step
+ * is one straight loop over structure-of-arrays link data, which the compiler vectorizes.
+ * Links with fewer coefficients just see zeros until their own degree. Double precision is
+ * required (positions are up to ~10^10 km), so the float SIMD backend is not used here.
+ * All scratch space is sized by add(), so evaluate() never allocates.
+ */
+class EphemerisBatch
+{
+public:
+    /**
+     * @brief Creates an empty batch reading from @p file.
+     */
+    explicit EphemerisBatch(std::shared_ptr<const SpkFile> file = nullptr);
+
+    /**
+     * @brief Appends a body: the position of NAIF ID @p target relative to NAIF ID @p center.
+     * @return false (and nothing is added) if the file does not connect the two bodies.
+     */
+    bool add(int target, int center);
+
+    /** @brief Number of bodies added. */
+    size_t size() const { return termStarts.size() - 1; }
+
+    /**
+     * @brief Evaluates every body at ephemeris time @p et (TDB seconds past J2000).
+     * Outside a link's coverage its nearest segment edge is used (positions are held, not extrapolated).
+     * @param x, y, z Receive one position per body, in km, in the file's frame (J2000 for DE files).
+     */
+    void evaluate(double et, double *x, double *y, double *z);
+
+private:
+    int linkFor(int target, int center);
+
+    std::shared_ptr<const SpkFile> spk;
+
+    // --- Links (one per distinct target -> center series) ---
+    std::vector<int> linkTargets, linkCenters; // NAIF IDs of each link's series
+    std::vector<size_t> linkSegmentStarts;     // Segments of link l are linkSegments[linkSegmentStarts[l] .. [l + 1])
+    std::vector<size_t> linkSegments;          // Indices into spk->segments(), sorted by start time
+    std::vector<size_t> cachedSegments;        // Index into linkSegments used by the previous evaluate(), per link
+
+    // --- Per-link scratch for evaluate() (SoA) ---
+    std::vector<const double *> coefficients; // Record coefficients of each link (after midpoint and radius)
+    std::vector<size_t> coefficientCounts;    // Coefficients per coordinate
+    std::vector<double> twoS;                 // 2 * normalized time in [-1, 1]
+    std::vector<double> b1x, b1y, b1z;        // Clenshaw b(k+1)
+    std::vector<double> b2x, b2y, b2z;        // Clenshaw b(k+2)
+    size_t maxCoefficients = 0;               // Largest coefficientCount of any segment in use
+
+    // --- Bodies: signed sums of links ---
+    std::vector<size_t> termStarts{0}; // Terms of body b are [termStarts[b], termStarts[b + 1])
+    std::vector<size_t> termLinks;     // Link of each term
+    std::vector<double> termSigns;     // +1 or -1
+};
+
+#endif // EPHEMERIS_H
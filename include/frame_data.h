@@ -0,0 +1,58 @@
+/**
+ * @file frame_data.h
+ * @brief Defines the FrameData block and the FrameDataBuffer class, which shares the per-frame
+ * camera and light values with every shader through one uniform buffer.
+ */
+
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <glad/glad.h> // OpenGL types
+#include <glm/glm.hpp> // Vector/matrix types
+
+#include "stream_buffer.h" // For the per-frame uploads
+
+/**
+ * @struct FrameData
+ * @brief Values that are constant for a frame, in std140 layout. Must match the "FrameData"
+ * uniform block declared in the shaders (vec3 values are padded to vec4, as std140 does anyway).
+ */
+struct FrameData
+{
+    glm::mat4 projection; // Camera projection
+    glm::mat4 view;       // Camera view (the skybox removes the translation itself)
+    glm::vec4 lightPos;   // xyz = light source (Sun) position in world space
+    glm::vec4 viewPos;    // xyz = camera position in world space
+    glm::vec4 lightColor; // rgb = light color
+};
+static_assert(sizeof(FrameData) == 2 * 64 + 3 * 16, "FrameData must match the std140 block layout");
+
+/**
+ * @class FrameDataBuffer
+ * @brief Owns the uniform buffer behind binding point BINDING. Shaders join by binding their
+ * "FrameData" block to it (Shader::bindUniformBlock); each frame's values go into the next
+ * region of a StreamBuffer, and that region is bound to BINDING.
+ */
+class FrameDataBuffer
+{
+public:
+    static constexpr GLuint BINDING = 0; // Uniform buffer binding point of the FrameData block
+
+    /**
+     * @brief Creates the stream buffer (loadBufferStorage() must have been called).
+     */
+    FrameDataBuffer();
+
+    FrameDataBuffer(const FrameDataBuffer &) = delete;            // No copying
+    FrameDataBuffer &operator=(const FrameDataBuffer &) = delete; // No copying
+
+    /**
+     * @brief Uploads this frame's values (one buffer update for every shader) and binds them to BINDING.
+     */
+    void update(const FrameData &data);
+
+private:
+    StreamBuffer stream; // One FrameData per region
+};
+
+#endif // FRAME_DATA_H
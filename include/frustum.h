@@ -0,0 +1,103 @@
+/**
+ * @file frustum.h
+ * @brief Defines the view frustum and the structure-of-arrays bounding spheres, and the batch
+ * kernel that culls many spheres against the frustum at once.
+ */
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp> // Vector/matrix types
+
+#include <cstddef> // For size_t
+#include <vector>  // For the SoA arrays and the visible list
+
+/**
+ * @struct Frustum
+ * @brief The six clip planes of a camera, normalized, with normals pointing inwards, so the
+ * plane equation gives the signed distance of a point in world units.
+ *
+ * Plane i comes from the i-th of the clip inequalities -w <= x, x <= w, -w <= y, y <= w,
+ * -w <= z, z <= w. The first four are the left, right, bottom and top planes in every depth
+ * mode (depth_mode.h). The last two depend on the projection: near and far for the standard
+ * one; near and a plane that every point in front of the camera passes for the infinite
+ * logarithmic-depth one; and the other way round for reverse-Z, whose -w <= z passes every
+ * point in front and whose z <= w is the near plane.
+ */
+struct Frustum
+{
+    glm::vec4 planes[6]; // (normal, offset) from -w <= x, x <= w, -w <= y, y <= w, -w <= z, z <= w
+
+    /**
+     * @brief Extracts the planes from a combined projection * view matrix (OpenGL clip space,
+     * -w <= x, y, z <= w), for any projection of depth_mode.h.
+     */
+    static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+    /**
+     * @brief True if the sphere is at least partly inside (or too close to a corner to tell).
+     * Scalar reference of cullSphereBatch().
+     */
+    bool intersects(const glm::vec3 &center, float radius) const;
+};
+
+/**
+ * @struct SphereBatch
+ * @brief World-space bounding spheres stored as parallel arrays (one entry per object).
+ *
+ * The arrays are padded with spheres that are never visible up to a multiple of
+ * SphereBatch::laneBlock, so the kernel never needs a scalar tail loop. Use resize() rather
+ * than resizing the arrays directly.
+ */
+struct SphereBatch
+{
+    static constexpr size_t laneBlock = 8; // Spheres processed per kernel iteration (AVX2 width)
+
+    std::vector<float> centerX; // Center, X component
+    std::vector<float> centerY; // Center, Y component
+    std::vector<float> centerZ; // Center, Z component
+    std::vector<float> radius;  // Radius (negative in the padding)
+
+    /** @brief Number of real spheres (excluding padding). */
+    size_t size() const { return count; }
+
+    /** @brief Number of entries including padding (a multiple of laneBlock). */
+    size_t paddedSize() const { return radius.size(); }
+
+    /**
+     * @brief Resizes all arrays to hold @p n spheres, padding with spheres that are never visible.
+     * Existing entries are preserved.
+     */
+    void resize(size_t n);
+
+    /** @brief Sets sphere @p i. */
+    void set(size_t i, const glm::vec3 &center, float sphereRadius)
+    {
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+        radius[i] = sphereRadius;
+    }
+
+private:
+    size_t count = 0;
+};
+
+/**
+ * @brief Tests every sphere of the batch against the six planes, Simd::width spheres per step.
+ *
+ * A sphere is culled if its center lies farther than its radius outside any plane. Like every
+ * sphere-against-planes test this is conservative: a sphere near a frustum corner may be kept
+ * although it is outside.
+ *
+ * @param frustum Planes from Frustum::fromMatrix().
+ * @param spheres The bounding spheres.
+ * @param visible Receives the indices of the visible spheres, ascending (cleared first).
+ * @return Number of visible spheres.
+ */
+size_t cullSphereBatch(const Frustum &frustum, const SphereBatch &spheres, std::vector<unsigned int> &visible);
+
+/** @brief Name of the SIMD backend the kernel was compiled with ("AVX2", "SSE4.1" or "scalar"). */
+const char *cullKernelBackend();
+
+#endif // FRUSTUM_H
@@ -0,0 +1,41 @@
+/**
+ * @file gl_indirect.h
+ * @brief Multi-draw-indirect support. The bundled GLAD loader is generated for GL 3.3, so the
+ * one GL 4.3 entry point the renderer uses is declared and loaded here when the context has it.
+ */
+
+#ifndef GL_INDIRECT_H
+#define GL_INDIRECT_H
+
+#include <glad/glad.h> // OpenGL types and GLADloadproc
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+/**
+ * @struct DrawElementsIndirectCommand
+ * @brief One draw of an indirect buffer, laid out as glMultiDrawElementsIndirect reads it.
+ */
+struct DrawElementsIndirectCommand
+{
+    GLuint count;         // Number of indices
+    GLuint instanceCount; // Number of instances
+    GLuint firstIndex;    // First index in the element buffer
+    GLint baseVertex;     // Added to every index
+    GLuint baseInstance;  // First instance (offsets every per-instance attribute)
+};
+
+typedef void(APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC solar_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect solar_glMultiDrawElementsIndirect
+
+/**
+ * @brief Loads glMultiDrawElementsIndirect if the current context is GL 4.3 or newer. Call after
+ * gladLoadGLLoader().
+ * @param load The loader passed to GLAD (e.g. glfwGetProcAddress).
+ * @return True if indirect multi-draws can be used.
+ */
+bool loadIndirectDraw(GLADloadproc load);
+
+#endif // GL_INDIRECT_H
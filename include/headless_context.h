@@ -0,0 +1,52 @@
+/**
+ * @file headless_context.h
+ * @brief Defines the HeadlessContext class, an OpenGL context without a window or display
+ * server (EGL surfaceless), used by the --headless mode.
+ */
+
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+/**
+ * @class HeadlessContext
+ * @brief An OpenGL core profile context current on the calling thread, with no surface at all.
+ *
+ * The display comes from EGL_MESA_platform_surfaceless where available (no X11, Wayland or
+ * GPU needed; Mesa's llvmpipe renders on the CPU), else from the default EGL display. The
+ * context has no default framebuffer, so everything must be drawn into a framebuffer object
+ * (see SceneFramebuffer). Only available when the application is built with EGL
+ * (SOLAR_HAS_EGL); otherwise create() reports an error.
+ */
+class HeadlessContext
+{
+public:
+    HeadlessContext() = default;
+
+    /**
+     * @brief Destructor that releases the context and the display.
+     */
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext &) = delete;            // No copying
+    HeadlessContext &operator=(const HeadlessContext &) = delete; // No copying
+
+    /**
+     * @brief Creates an OpenGL @p major.@p minor core profile context and makes it current.
+     * May be called again with a lower version after a failure.
+     * @return False if no such context can be created (display errors are reported on std::cerr).
+     */
+    bool create(int major, int minor);
+
+    /**
+     * @brief Looks up an OpenGL entry point; a GLADloadproc for gladLoadGLLoader and the
+     * extension loaders.
+     */
+    static void *getProcAddress(const char *name);
+
+private:
+    void *display = nullptr;  // EGLDisplay (kept opaque so EGL headers stay out of this header)
+    void *context = nullptr;  // EGLContext
+    bool unavailable = false; // Set once no display can provide the context (later calls fail silently)
+};
+
+#endif // HEADLESS_CONTEXT_H
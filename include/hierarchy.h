@@ -0,0 +1,199 @@
+/**
+ * @file hierarchy.h
+ * @brief Defines the TransformHierarchy class, a flattened, parent-indexed copy of a
+ * Scenario's body tree used to evaluate every world transform in one linear pass.
+ */
+
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include <glm/glm.hpp> // Vector/matrix types
+
+#include "orbit_kernel.h" // SoA animation parameters + batch kernel
+#include "kepler.h"       // SoA elliptical orbits + batch Kepler solver
+#include "ephemeris.h"    // Chebyshev ephemeris positions
+
+#include <string>        // For body names
+#include <vector>        // For the flat per-node arrays
+#include <unordered_map> // For the load-time name -> node lookup
+
+struct Scenario;  // Forward declaration (full definition in scenario.h)
+class ThreadPool; // Forward declaration (full definition in thread_pool.h)
+
+/**
+ * @class TransformHierarchy
+ * @brief Compiles a Scenario once at load time into a topologically sorted array of nodes.
+ *
+ * Nodes are ordered by depth (breadth-first from the root bodies), so every parent comes
+ * before its children and all bodies at the same depth form one contiguous level. Parents are
+ * referenced by integer node index instead of by name, the animation parameters are copied
+ * into an OrbitBatch (structure of arrays), elliptical orbits into a KeplerBatch, bodies with
+ * ephemeris data into an EphemerisBatch, and the resulting world matrices live in one
+ * contiguous vector, next to the world positions in double precision. Updating the whole
+ * system is one vectorized kernel call per batch followed by a single forward loop that adds
+ * each parent's position, with no string lookups.
+ */
+class TransformHierarchy
+{
+public:
+    static constexpr int NO_PARENT = -1; // Parent index used for root bodies
+
+    /**
+     * @struct Selection
+     * @brief A few nodes prepared by select() for positionsAt(): the nodes plus all of their
+     * ancestors in node order (parents first), each with the source of its local offset resolved.
+     */
+    struct Selection
+    {
+        std::vector<int> nodes;            // Selected nodes and their ancestors, in node order
+        std::vector<int> parentSlots;      // Per slot: slot of the node's parent, or NO_PARENT
+        std::vector<unsigned char> kinds;  // Per slot: where the local offset comes from (circular, Kepler, ephemeris, dynamic)
+        std::vector<size_t> sources;       // Per slot: node, Kepler entry, ephemeris entry or dynamic entry (by kind)
+        std::vector<size_t> selectedSlots; // Per selected node: its slot
+        std::vector<glm::dvec3> positions; // Per slot: world position from the last positionsAt()
+        bool ephemeris = false;            // Some slot is an ephemeris node
+
+        /** @brief World position of the @p i-th selected node after positionsAt(). */
+        const glm::dvec3 &position(size_t i) const { return positions[selectedSlots[i]]; }
+    };
+
+    /**
+     * @brief Builds the flattened hierarchy from the scenario's body list.
+     * Bodies whose parent cannot be found (or which are part of a parent cycle) are
+     * reported on std::cerr and treated as roots. N-body bodies are roots as well.
+     * @param scenario The scenario to compile. Only its bodies' parameters are copied;
+     *                 the scenario is not referenced after construction.
+     */
+    explicit TransformHierarchy(const Scenario &scenario);
+
+    /**
+     * @brief Recomputes every node's world matrix for the given simulation time.
+     * Bodies are evaluated analytically from the time, so the cost does not depend on how
+     * far the clock moved since the previous call. If @p simTime equals the previous call's,
+     * only the subtrees of dynamic nodes that were moved since then are updated (nothing at
+     * all while the clock is paused); see recomputedCount().
+     * @param simTime Simulation time in clock ticks (SimClock::ticks()).
+     * @param pool Optional worker pool. Levels are processed one after another, the nodes of
+     *             each level in parallel; the output is identical with or without a pool.
+     */
+    void update(SimClock::Ticks simTime, ThreadPool *pool = nullptr);
+
+    /**
+     * @brief Prepares @p nodes for positionsAt(). Intended for load time.
+     */
+    Selection select(const std::vector<int> &nodes) const;
+
+    /**
+     * @brief Evaluates the world positions of a Selection's nodes at @p simTime in double
+     * precision, leaving the stored matrices and positions untouched. Costs one scalar
+     * evaluation per selected node and ancestor (plus the ephemeris batch, if any slot uses it)
+     * instead of a whole update(), for the few nodes that are needed at many times, like the
+     * N-body attractors at every sub-step. Dynamic nodes are taken from their last
+     * setDynamicPosition().
+     */
+    void positionsAt(SimClock::Ticks simTime, Selection &selection);
+
+    /** @brief Number of nodes (equal to the number of bodies in the scenario). */
+    size_t size() const { return parents.size(); }
+
+    /**
+     * @brief Finds the node for a body name. Intended for load-time/input handling, not per-frame use.
+     * @return The node index, or -1 if no body has that name.
+     */
+    int findNode(const std::string &name) const;
+
+    /** @brief Parent node index, or NO_PARENT for roots. Always smaller than @p node. */
+    int parentOf(int node) const { return parents[node]; }
+
+    /** @brief Number of depth levels (roots are level 0). */
+    size_t levelCount() const { return levelStarts.size() - 1; }
+
+    /** @brief Nodes of a level are [levelBegin(level), levelBegin(level + 1)). */
+    size_t levelBegin(size_t level) const { return levelStarts[level]; }
+
+    /** @brief Index of the node's body in the original Scenario::bodies vector. */
+    size_t bodyIndexOf(int node) const { return bodyIndices[node]; }
+
+    /** @brief Current world matrix of a node (valid after update()). */
+    const glm::mat4 &worldMatrix(int node) const { return worlds[node]; }
+
+    /** @brief Contiguous world matrices of all nodes, in node order. */
+    const std::vector<glm::mat4> &worldMatrices() const { return worlds; }
+
+    /**
+     * @brief World position of every node in double precision, in node order (the matrices'
+     * translations are these, rounded to float). Renderers subtract the camera position from
+     * these, so positions stay exact far from the origin.
+     */
+    const std::vector<glm::dvec3> &worldPositions() const { return positions; }
+
+    /**
+     * @brief Nodes whose position is supplied from outside (bodies with Dynamics::NBody).
+     * They are roots of the hierarchy, since their positions are already in world space; analytic
+     * children still orbit them.
+     */
+    const std::vector<int> &dynamicNodes() const { return dynamicNodeList; }
+
+    /**
+     * @brief Sets the world position of dynamicNodes()[index], applied by the next update().
+     * Setting the position it already has does not mark anything for recomputation.
+     */
+    void setDynamicPosition(size_t index, const glm::dvec3 &worldPosition)
+    {
+        if (dynamicPositions[index] != worldPosition)
+        {
+            dynamicPositions[index] = worldPosition;
+            dynamicMoved = true;
+        }
+    }
+
+    /** @brief Number of node transforms the last update() recomputed (0 if nothing changed). */
+    size_t recomputedCount() const { return recomputed; }
+
+private:
+    void updateMovedSubtrees();
+
+    static constexpr size_t KERNEL_GRAIN = 4096;  // Entries per parallel kernel chunk (multiple of both batches' laneBlock)
+    static constexpr size_t COMPOSE_GRAIN = 8192; // Nodes per parallel composition chunk
+
+    // --- Topology ---
+    std::vector<size_t> bodyIndices; // Node -> index into Scenario::bodies
+    std::vector<int> parents;        // Node -> parent node (NO_PARENT for roots)
+    std::vector<size_t> levelStarts; // First node of each depth level, plus a final end sentinel
+
+    // --- Animation parameters (copied from CelestialBody, in node order) ---
+    OrbitBatch params;
+
+    // --- Elliptical orbits (only the nodes that have KeplerElements) ---
+    KeplerBatch keplerParams;                     // Entry k describes node keplerNodes[k]
+    std::vector<int> keplerNodes;                 // Kepler entry -> node
+    std::vector<float> keplerX, keplerY, keplerZ; // Positions from the last update (padded)
+
+    // --- Ephemeris orbits (nodes positioned from Scenario::ephemeris) ---
+    EphemerisBatch ephemerisParams;                         // Entry e describes node ephemerisNodes[e]
+    std::vector<int> ephemerisNodes;                        // Ephemeris entry -> node
+    std::vector<double> ephemerisScales;                    // Scene units per km, per entry
+    std::vector<double> ephemerisX, ephemerisY, ephemerisZ; // Positions from the last update (km, J2000)
+    double ephemerisEpoch = 0.0;                            // Ephemeris time at tick 0
+    double ephemerisTimeScale = 1.0;                        // Ephemeris seconds per simulation second
+
+    // --- Externally simulated nodes (Dynamics::NBody) ---
+    std::vector<int> dynamicNodeList;         // Dynamic entry -> node
+    std::vector<glm::dvec3> dynamicPositions; // World position per dynamic entry
+    bool dynamicMoved = false;                // A dynamic position changed since the last update()
+
+    // --- Change tracking ---
+    bool evaluated = false;             // update() has run at least once
+    SimClock::Ticks lastTime = 0;       // simTime of the last update()
+    size_t recomputed = 0;              // Transforms recomputed by the last update()
+    std::vector<glm::dvec3> moveDeltas; // Translation change per node (incremental updates only)
+    std::vector<unsigned char> moved;   // Node was moved by the current incremental update
+
+    // --- Results ---
+    std::vector<glm::mat4> worlds;     // World matrix per node, updated by update()
+    std::vector<glm::dvec3> positions; // World position per node in double precision, updated by update()
+
+    std::unordered_map<std::string, int> nodeByName; // Name -> node, built once
+};
+
+#endif // HIERARCHY_H
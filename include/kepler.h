@@ -0,0 +1,125 @@
+/**
+ * @file kepler.h
+ * @brief Defines Keplerian orbital elements, their structure-of-arrays batch form, and the
+ * vectorized Kepler-equation solver used to propagate many elliptical orbits at once.
+ */
+
+#ifndef KEPLER_H
+#define KEPLER_H
+
+#include "sim_clock.h" // For SimClock::Ticks and PhaseRate
+
+#include <cstddef> // For size_t
+#include <cstdint> // For std::uint64_t
+#include <vector>  // For the SoA arrays
+
+/**
+ * @struct KeplerElements
+ * @brief Classical elements of an elliptical orbit around the parent body.
+ *
+ * The reference plane is the scene's X-Z plane with +Y as its north pole, the reference
+ * direction is +X and 90 degrees ahead of it is -Z (see scene_frame.h). An orbit with e = 0
+ * and i = 0 moves exactly like the circular orbitRadius/orbitSpeed motion of CelestialBody.
+ * Angles are in radians.
+ */
+struct KeplerElements
+{
+    float semiMajorAxis = 0.0f;       // a, in scene units
+    float eccentricity = 0.0f;        // e, in [0, KeplerBatch::MAX_ECCENTRICITY]
+    float inclination = 0.0f;         // i, tilt of the orbital plane
+    float ascendingNode = 0.0f;       // Longitude of the ascending node (Omega)
+    float argumentOfPeriapsis = 0.0f; // omega, measured from the ascending node
+    float meanAnomalyAtEpoch = 0.0f;  // M0, mean anomaly at simulation time 0
+    float meanMotion = 0.0f;          // n, radians per simulation second (same units as orbitSpeed)
+};
+
+/**
+ * @struct KeplerBatch
+ * @brief Elements of many orbits stored as parallel arrays, reduced at set() time to what the
+ * propagator needs: the mean anomaly as a fixed-point phase, and the two in-plane basis
+ * vectors already scaled by the semi-axes.
+ *
+ * Like OrbitBatch, the arrays are padded with inert orbits up to a multiple of laneBlock.
+ */
+struct KeplerBatch
+{
+    static constexpr size_t laneBlock = 8;           // Orbits processed per kernel iteration (AVX2 width)
+    static constexpr float MAX_ECCENTRICITY = 0.99f; // Larger eccentricities are clamped (ellipses only)
+
+    std::vector<PhaseRate> meanMotion;           // n (fixed point, see PhaseRate)
+    std::vector<std::uint64_t> meanAnomalyStart; // M0 (fixed-point phase, see phaseFromAngle)
+    std::vector<float> eccentricity;             // e
+    std::vector<float> px, py, pz;               // a * unit vector towards periapsis
+    std::vector<float> qx, qy, qz;               // b * unit vector 90 degrees ahead of periapsis (b = a*sqrt(1-e^2))
+
+    /** @brief Number of real orbits (excluding padding). */
+    size_t size() const { return count; }
+
+    /** @brief Number of entries including padding (a multiple of laneBlock). */
+    size_t paddedSize() const { return eccentricity.size(); }
+
+    /**
+     * @brief Resizes all arrays to hold @p n orbits, padding with inert entries (position 0).
+     * Existing entries are preserved.
+     */
+    void resize(size_t n);
+
+    /** @brief Sets one orbit from its classical elements. */
+    void set(size_t i, const KeplerElements &elements);
+
+private:
+    size_t count = 0;
+};
+
+/** @brief Halley iterations per solve. Fixed, so the solver has no data-dependent branches. */
+constexpr int KEPLER_ITERATIONS = 4;
+
+/**
+ * @brief Solves Kepler's equation M = E - e*sin(E) for the eccentric anomaly E of many orbits.
+ *
+ * Starts from Danby's guess E0 = M + 0.85*e*sign(M) and applies KEPLER_ITERATIONS Halley steps,
+ * Simd::width lanes at a time. Positions are accurate to float precision for e up to MAX_ECCENTRICITY
+ * (E itself is ill-conditioned near periapsis of very eccentric orbits).
+ *
+ * @param meanAnomaly Mean anomalies in [-pi, pi).
+ * @param eccentricity Eccentricities in [0, KeplerBatch::MAX_ECCENTRICITY].
+ * @param eccentricAnomaly Receives one eccentric anomaly per input.
+ * @param count Number of values (any count; no padding needed).
+ */
+void solveKeplerBatch(const float *meanAnomaly, const float *eccentricity, float *eccentricAnomaly, size_t count);
+
+/**
+ * @brief Evaluates the position of every orbit at the given time, relative to its parent.
+ *
+ * M = M0 + n*t is taken from the fixed-point phase (exact at any time), E is found with the
+ * same solver as solveKeplerBatch(), and the position is P*(cos E - e) + Q*sin E.
+ *
+ * @param batch The SoA orbit parameters.
+ * @param simTime Simulation time in clock ticks.
+ * @param outX, outY, outZ Destination arrays with at least batch.paddedSize() entries each.
+ * @param first First orbit; must be a multiple of KeplerBatch::laneBlock.
+ * @param last One past the last orbit (clamped to batch.size()).
+ */
+void evaluateKeplerBatchRange(const KeplerBatch &batch, SimClock::Ticks simTime,
+                              float *outX, float *outY, float *outZ, size_t first, size_t last);
+
+/**
+ * @brief Scalar double-precision position and velocity on an orbit, relative to the parent.
+ * Used to set up initial conditions (e.g. for the N-body mode), not per frame.
+ * @param elements Orbit shape and orientation (elements.meanMotion is ignored).
+ * @param meanMotion Mean motion to use, in radians per simulation second (negative = retrograde).
+ * @param simSeconds Simulation time.
+ * @param position, velocity Receive the state in scene coordinates.
+ */
+void keplerStateAt(const KeplerElements &elements, double meanMotion, double simSeconds,
+                   double position[3], double velocity[3]);
+
+/**
+ * @brief Scalar double-precision counterpart of evaluateKeplerBatchRange() for orbit @p i of
+ * @p batch (same parameters, Kepler's equation solved to convergence). For orbits evaluated
+ * one at a time, e.g. the few nodes of a TransformHierarchy::Selection.
+ * @param position Receives the position relative to the parent, in scene coordinates.
+ */
+void keplerPositionAt(const KeplerBatch &batch, size_t i, SimClock::Ticks simTime, double position[3]);
+
+#endif // KEPLER_H
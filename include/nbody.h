@@ -0,0 +1,186 @@
+/**
+ * @file nbody.h
+ * @brief Defines the NBodySystem class, which integrates N-body bodies and particle belts under
+ * mutual gravity (Barnes-Hut) plus the pull of the analytic bodies.
+ */
+
+#ifndef NBODY_H
+#define NBODY_H
+
+#include <glm/glm.hpp> // Vector types
+
+#include "barnes_hut.h" // Tree gravity
+#include "hierarchy.h"  // For TransformHierarchy::Selection
+#include "kepler.h"     // For the initial orbits
+#include "sim_clock.h"  // For SimClock::Ticks
+
+#include <cstddef> // For size_t
+#include <cstdint> // For std::uint8_t
+#include <vector>  // For the state arrays
+
+struct Scenario;          // Forward declaration (full definition in scenario.h)
+class ThreadPool;         // Forward declaration (full definition in thread_pool.h)
+
+/**
+ * @enum Integrator
+ * @brief Symplectic scheme used for each block step (see NBodySystem).
+ */
+enum class Integrator
+{
+    Leapfrog, // Kick-drift-kick, 2nd order, one force evaluation per step
+    Yoshida4  // Yoshida's 4th-order composition of three leapfrog steps, three evaluations per step
+};
+
+/**
+ * @struct NBodySettings
+ * @brief Accuracy/performance parameters of the N-body mode (the [nbody] section of config.ini).
+ */
+struct NBodySettings
+{
+    Integrator integrator = Integrator::Leapfrog;
+    double timestep = 0.1;   // Largest (base) step, in simulation seconds
+    int maxSubsteps = 64;    // Most base steps per advanceTo(); beyond that the base step grows
+    int maxLevels = 6;       // Block levels below the base step (smallest step = base / 2^maxLevels)
+    double accuracy = 0.05;  // Each entry's step is at most accuracy * its dynamical time
+    double theta = 0.6;      // Barnes-Hut opening angle (0 = exact, slower)
+    double softening = 0.01; // Plummer softening length, in scene units
+};
+
+/**
+ * @struct NBodyStats
+ * @brief Cost and accuracy of the last advanceTo() call, for the overlay.
+ */
+struct NBodyStats
+{
+    size_t bodies = 0;        // Simulated CelestialBodies
+    size_t particles = 0;     // Belt particles
+    int substeps = 0;         // Base steps taken
+    int deepestLevel = 0;     // Finest block level used (a base step was split into up to 2^level steps)
+    int evaluations = 0;      // Force evaluations (full or partial)
+    double forceMs = 0.0;     // Average wall time of one force evaluation
+    double totalMs = 0.0;     // Wall time of the whole call
+    double energyDrift = 0.0; // (E - E0 - work done by moving analytic bodies) / |E0| since the last reset
+};
+
+/**
+ * @class NBodySystem
+ * @brief Integrates every Dynamics::NBody body and every belt particle of a scenario.
+ *
+ * Simulated bodies and particles ("entries") attract each other through a BarnesHutTree that is
+ * rebuilt at every force evaluation; analytic bodies with a mass pull on them as exact point
+ * masses at their scripted positions, but are not pulled back.
+ *
+ * Time steps are hierarchical: at the start of every base step each entry gets a block level L
+ * so that base / 2^L is below NBodySettings::accuracy times its dynamical time (sqrt(r^3 / GM)
+ * to the nearest massive body or analytic attractor). All entries drift together at the finest
+ * level in use, but an entry is kicked, and its force evaluated, only at the ends of its own
+ * steps, so a particle in a close encounter sub-steps while the rest of the belt takes the base
+ * step. Levels are fixed within a base step, which keeps each block step time-symmetric; the
+ * scheme (leapfrog or Yoshida-4) is symplectic for constant levels, so negative time warp simply
+ * runs the integration backwards.
+ *
+ * Initial conditions come from each entry's orbit (Kepler elements or circular radius) relative
+ * to its parent, with the speed given by the parent's mass rather than the scripted orbit speed.
+ * Unlike the analytic bodies, the state depends on its history: reset() (used for seeking)
+ * restarts every entry from its initial orbit evaluated at the new time.
+ */
+class NBodySystem
+{
+public:
+    /**
+     * @brief Collects the simulated bodies and generates the belt particles.
+     * @param scenario Scenario to simulate (not referenced after construction).
+     * @param hierarchy Hierarchy of the same scenario; provides the analytic bodies' positions and
+     *                  receives the simulated bodies' positions. Must outlive this object.
+     * @param settings Integration parameters.
+     */
+    NBodySystem(const Scenario &scenario, TransformHierarchy &hierarchy, const NBodySettings &settings);
+
+    /** @brief True if the scenario has nothing to simulate. */
+    bool empty() const { return entryCount() == 0; }
+
+    /** @brief Restarts every entry from its initial orbit at @p simTime (and the energy reference). */
+    void reset(SimClock::Ticks simTime, ThreadPool *pool);
+
+    /**
+     * @brief Integrates from the current time to @p simTime (forwards or backwards) in at most
+     * NBodySettings::maxSubsteps base steps, then hands the simulated bodies' positions to the hierarchy.
+     */
+    void advanceTo(SimClock::Ticks simTime, ThreadPool *pool);
+
+    /**
+     * @brief Positions of the belt particles after the last reset()/advanceTo(), relative to
+     * particleOrigin() (so they keep float precision however far the belts are from the origin).
+     */
+    const std::vector<glm::vec3> &particlePositions() const { return particlePositionsF; }
+
+    /** @brief World position the particlePositions() are relative to (changes with them). */
+    const glm::dvec3 &particleOrigin() const { return particleOriginD; }
+
+    /** @brief Per particle: RGB color and point size in pixels (from its ParticleBelt). */
+    const std::vector<glm::vec4> &particleStyles() const { return styles; }
+
+    /** @brief Cost and energy drift of the last advanceTo(). */
+    const NBodyStats &stats() const { return lastStats; }
+
+private:
+    /** @brief Where an entry starts: an orbit around an analytic node, another entry, or nothing. */
+    struct InitialOrbit
+    {
+        int parentNode = -1;     // Hierarchy node of an analytic parent, or -1
+        int parentEntry = -1;    // Entry of a simulated parent (always smaller than this entry), or -1
+        KeplerElements elements; // Orbit relative to the parent
+        double meanMotion = 0.0; // Radians per simulation second (from the parent's mass)
+    };
+
+    size_t entryCount() const { return mass.size(); }
+    void addEntry(const InitialOrbit &orbit, double entryMass);
+    int assignLevels(double stepSeconds);
+    void blockStep(double h, int deepest, double &offset, bool withPotential, ThreadPool *pool);
+    void computeAccelerations(double offset, bool everyone, bool withPotential, ThreadPool *pool);
+    double energyWeight(size_t i) const { return selfGravity ? mass[i] : 1.0; }
+    double totalEnergy() const;
+    void pushBodyPositions();
+    void publish(ThreadPool *pool);
+
+    TransformHierarchy &hierarchy;
+    NBodySettings settings;
+    BarnesHutTree tree;
+
+    // --- Entries: simulated bodies first (parents before children), then particles ---
+    size_t bodyCount = 0;
+    std::vector<size_t> dynamicIndex; // Body entry -> index into hierarchy.dynamicNodes()
+    std::vector<InitialOrbit> initialOrbits;
+    std::vector<double> x, y, z;    // Positions
+    std::vector<double> vx, vy, vz; // Velocities
+    std::vector<double> ax, ay, az; // Accelerations at each entry's last evaluation
+    std::vector<double> mass;       // G*M per entry
+    bool selfGravity = false;       // Whether any entry has mass (otherwise the tree is skipped)
+
+    // --- Block time steps ---
+    std::vector<double> dynamicalTime2; // Smallest r^3 / GM to a massive body or attractor, per entry
+    std::vector<std::uint8_t> levels;   // Block level per entry for the current base step
+    std::vector<std::uint8_t> active;   // Entries evaluated by the current force evaluation
+
+    // --- Analytic bodies that attract the entries ---
+    std::vector<int> attractorNodes;
+    std::vector<double> attractorMass;
+    TransformHierarchy::Selection attractorSelection; // Attractors and their ancestors, evaluated at every force evaluation
+    std::vector<double> attractorPositions;           // Per attractor: x, y, z at the current evaluation
+    std::vector<double> chunkForces;                  // Per entry chunk and attractor: force from the chunk's entries
+
+    // --- Energy diagnostic ---
+    std::vector<double> mutualPotential;   // Potential from the other entries (after an evaluation withPotential)
+    std::vector<double> externalPotential; // Potential from the attractors (same)
+    std::vector<double> attractorState;    // Per attractor: position, then force from the entries, at the last evaluation
+    double initialEnergy = 0.0;            // Energy at the last reset()
+    double attractorWork = 0.0;            // Energy moved into the entries by moving attractors since then
+
+    SimClock::Ticks time = 0;                     // Time at the start of the current base step
+    std::vector<glm::vec3> particlePositionsF;    // Render copy of the particle positions, relative to particleOriginD
+    glm::dvec3 particleOriginD = glm::dvec3(0.0); // Anchor of the render copy: the first particle's position
+    std::vector<glm::vec4> styles;                // Per particle color + size
+    NBodyStats lastStats;
+};
+
+#endif // NBODY_H
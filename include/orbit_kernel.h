@@ -0,0 +1,86 @@
+/**
+ * @file orbit_kernel.h
+ * @brief Defines the structure-of-arrays orbit/rotation parameters and the batch kernel
+ * that turns them into model matrices for many bodies at once.
+ */
+
+#ifndef ORBIT_KERNEL_H
+#define ORBIT_KERNEL_H
+
+#include "sim_clock.h" // For SimClock::Ticks and PhaseRate
+
+#include <cstddef> // For size_t
+#include <vector>  // For the SoA arrays
+
+/**
+ * @struct OrbitBatch
+ * @brief Animation parameters of many bodies stored as parallel arrays (one entry per body).
+ *
+ * The arrays are padded with inert bodies up to a multiple of OrbitBatch::laneBlock so the
+ * kernel never needs a scalar tail loop. Use resize() rather than resizing the arrays directly.
+ */
+struct OrbitBatch
+{
+    static constexpr size_t laneBlock = 8; // Bodies processed per kernel iteration (AVX2 width)
+
+    std::vector<float> orbitRadius;      // Distance from the parent's center (0 = no orbit)
+    std::vector<PhaseRate> orbitRate;    // Orbital angular speed (fixed point, see PhaseRate)
+    std::vector<PhaseRate> rotationRate; // Spin angular speed (fixed point, see PhaseRate)
+    std::vector<float> axisX;            // Normalized rotation axis, X component
+    std::vector<float> axisY;            // Normalized rotation axis, Y component
+    std::vector<float> axisZ;            // Normalized rotation axis, Z component
+    std::vector<float> scale;            // Uniform scale (body radius)
+
+    /** @brief Number of real bodies (excluding padding). */
+    size_t size() const { return count; }
+
+    /** @brief Number of entries including padding (a multiple of laneBlock). */
+    size_t paddedSize() const { return orbitRadius.size(); }
+
+    /**
+     * @brief Resizes all arrays to hold @p n bodies, padding with inert entries.
+     * Existing entries are preserved.
+     */
+    void resize(size_t n);
+
+    /**
+     * @brief Sets the parameters of one body. The axis does not need to be normalized.
+     * Speeds are in radians per simulation second.
+     */
+    void set(size_t i, float orbitRad, float orbitSpd, float rotationSpd,
+             float ax, float ay, float az, float bodyScale);
+
+private:
+    size_t count = 0;
+};
+
+/**
+ * @brief Evaluates the local model matrix of every body in the batch.
+ *
+ * For each body this computes translate(orbitOffset) * rotate(angle, axis) * scale(radius),
+ * where orbitOffset = (cos(t * orbitSpeed), 0, -sin(t * orbitSpeed)) * orbitRadius and
+ * angle = t * rotationSpeed. The parent's position is NOT added; callers compose the hierarchy.
+ * This matches the glm::translate/rotate/scale path element for element (to float rounding).
+ * Angles are evaluated from the tick count with fixed-point phase arithmetic (see PhaseRate),
+ * so the cost and the accuracy are the same at any simulation time.
+ *
+ * @param batch The SoA body parameters.
+ * @param simTime Simulation time in clock ticks.
+ * @param outMatrices Destination for batch.size() column-major 4x4 matrices (16 floats each,
+ *                    layout-compatible with an array of glm::mat4).
+ */
+void evaluateOrbitBatch(const OrbitBatch &batch, SimClock::Ticks simTime, float *outMatrices);
+
+/**
+ * @brief Same as evaluateOrbitBatch(), restricted to bodies [first, last).
+ * Used to split one batch across threads; each call writes only its own matrices.
+ * @param first First body; must be a multiple of OrbitBatch::laneBlock.
+ * @param last One past the last body (clamped to batch.size()).
+ */
+void evaluateOrbitBatchRange(const OrbitBatch &batch, SimClock::Ticks simTime, float *outMatrices,
+                             size_t first, size_t last);
+
+/** @brief Name of the SIMD backend the kernel was compiled with ("AVX2", "SSE4.1" or "scalar"). */
+const char *orbitKernelBackend();
+
+#endif // ORBIT_KERNEL_H
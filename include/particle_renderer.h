@@ -0,0 +1,86 @@
+/**
+ * @file particle_renderer.h
+ * @brief Defines the ParticleRenderer class, which draws N-body belt particles as point sprites.
+ */
+
+#ifndef PARTICLE_RENDERER_H
+#define PARTICLE_RENDERER_H
+
+#include <glad/glad.h> // OpenGL types
+#include <glm/glm.hpp> // Vector types
+
+#include "stream_buffer.h" // For the per-tick position uploads
+
+#include <vector> // For the particle arrays
+
+/**
+ * @class ParticleRenderer
+ * @brief Owns the GPU buffers for a fixed set of particles and draws them with one glDrawArrays call.
+ *
+ * Positions of the two most recent simulation ticks are blended in the vertex shader
+ * (shaders/particle.vert), so particles are interpolated like the bodies without touching every
+ * particle on the CPU each frame. Both are written into one region of a StreamBuffer, and only
+ * when a new tick arrives. Each tick's positions are float offsets from a double-precision
+ * origin, so the shader only needs the camera's offset from each origin, which the CPU forms
+ * in double (see offsets()); particles far from the scene origin keep their precision.
+ */
+class ParticleRenderer
+{
+public:
+    /**
+     * @brief Creates the buffers and uploads the per-particle styles.
+     * @param styles One entry per particle: RGB color and point size in pixels.
+     */
+    explicit ParticleRenderer(const std::vector<glm::vec4> &styles);
+
+    /**
+     * @brief Destructor that cleans up the OpenGL buffer objects.
+     */
+    ~ParticleRenderer();
+
+    ParticleRenderer(const ParticleRenderer &) = delete;            // No copying
+    ParticleRenderer &operator=(const ParticleRenderer &) = delete; // No copying
+
+    /**
+     * @brief Uploads the positions of a new simulation tick.
+     * @param previous Positions at the previous tick, relative to @p previousOrigin.
+     * @param current Positions at the new tick, relative to @p currentOrigin. Both must have
+     *                one entry per particle.
+     */
+    void upload(const std::vector<glm::vec3> &previous, const glm::dvec3 &previousOrigin,
+                const std::vector<glm::vec3> &current, const glm::dvec3 &currentOrigin);
+
+    /**
+     * @brief The uploaded ticks' origins relative to the camera at @p eye, for the shader's
+     * "previousOrigin" and "currentOrigin" uniforms (subtracted in double, then rounded).
+     */
+    void offsets(const glm::dvec3 &eye, glm::vec3 &previousOffset, glm::vec3 &currentOffset) const
+    {
+        previousOffset = glm::vec3(previousOrigin - eye);
+        currentOffset = glm::vec3(currentOrigin - eye);
+    }
+
+    /**
+     * @brief Draws all particles. vertexArray() must be bound and the particle shader active,
+     * with its "alpha" uniform set to the blend factor between the two uploaded ticks and its
+     * origin uniforms from offsets().
+     */
+    void draw() const;
+
+    /** @brief The particles' Vertex Array Object. */
+    unsigned int vertexArray() const { return VAO; }
+
+    /** @brief Number of particles. */
+    size_t size() const { return count; }
+
+private:
+    unsigned int VAO = 0;           // Vertex Array Object ID
+    StreamBuffer positions;         // Per region: previous tick (attribute 0), then current tick (attribute 1)
+    bool uploaded = false;          // positions holds a tick
+    glm::dvec3 previousOrigin{0.0}; // World position the uploaded previous tick is relative to
+    glm::dvec3 currentOrigin{0.0};  // World position the uploaded current tick is relative to
+    unsigned int styleVBO = 0;      // Color + point size (attribute 2), static
+    size_t count = 0;               // Number of particles
+};
+
+#endif // PARTICLE_RENDERER_H
@@ -13,13 +13,28 @@
 
 /**
  * @class Planet
- * @brief Generates vertex data for a UV sphere and manages the corresponding
+ * @brief Generates vertex data for UV spheres and manages the corresponding
  * OpenGL Vertex Array Object (VAO), Vertex Buffer Object (VBO), and
  * Element Buffer Object (EBO) for rendering.
+ *
+ * Several spheres of different detail can share the buffers: each is a Mesh (an index range
+ * and base vertex), so instanced and indirect draws can pick one without switching VAOs. This
+ * is how the level-of-detail chain (lodChain()) is stored.
  */
 class Planet
 {
 public:
+    /**
+     * @struct Mesh
+     * @brief Where one sphere lives in the shared buffers (the fields of an indirect draw command).
+     */
+    struct Mesh
+    {
+        GLsizei indexCount; // Number of indices to draw
+        GLuint firstIndex;  // Offset of the first index in the EBO, in indices
+        GLint baseVertex;   // Added to every index (the sphere's first vertex in the VBO)
+    };
+
     /**
      * @brief Constructor that generates sphere vertex data and uploads it to the GPU.
      * @param radius The radius of the sphere.
@@ -28,21 +43,58 @@ public:
      */
     Planet(float radius, unsigned int rings, unsigned int sectors);
 
+    /**
+     * @brief Constructor that generates one sphere per entry of @p details (rings = sectors =
+     * detail) into the same buffers. Mesh i has details[i].
+     */
+    Planet(float radius, const std::vector<unsigned int> &details);
+
     /**
      * @brief Destructor that cleans up the OpenGL buffer objects.
      */
     ~Planet();
 
     /**
-     * @brief Renders the sphere mesh by binding its VAO and calling glDrawElements.
+     * @brief Details of a level-of-detail chain: @p coarsest, doubling up to @p finest
+     * (e.g. 8, 16, 32, 64, 128, 256). Pass the result to the multi-mesh constructor, so mesh i
+     * is level i, coarsest first.
+     */
+    static std::vector<unsigned int> lodChain(unsigned int coarsest, unsigned int finest);
+
+    Planet(const Planet &) = delete;            // No copying (owns GL objects)
+    Planet &operator=(const Planet &) = delete; // No copying
+
+    /**
+     * @brief Renders @p instanceCount copies of mesh @p mesh with one instanced draw call.
+     * vertexArray() must be bound, with the per-instance attributes set up (see BodyRenderer).
      */
-    void draw();
+    void drawInstanced(GLsizei instanceCount, size_t mesh = 0) const;
+
+    /** @brief The mesh's Vertex Array Object (attributes 0-2: position, normal, texture coordinates). */
+    unsigned int vertexArray() const { return VAO; }
+
+    /** @brief Number of spheres in the buffers. */
+    size_t meshCount() const { return meshes.size(); }
+
+    /** @brief Index range and base vertex of sphere @p index. */
+    const Mesh &mesh(size_t index) const { return meshes[index]; }
 
 private:
-    unsigned int VAO;        // Vertex Array Object ID
-    unsigned int VBO;        // Vertex Buffer Object ID
-    unsigned int EBO;        // Element Buffer Object ID (for indices)
-    unsigned int indexCount; // Number of indices to draw
+    /**
+     * @brief Appends one sphere's interleaved vertices and (sphere-local) indices.
+     */
+    void appendSphere(float radius, unsigned int rings, unsigned int sectors,
+                      std::vector<float> &data, std::vector<unsigned int> &indices);
+
+    /**
+     * @brief Uploads the vertex and index data and configures the VAO.
+     */
+    void upload(const std::vector<float> &data, const std::vector<unsigned int> &indices);
+
+    unsigned int VAO;         // Vertex Array Object ID
+    unsigned int VBO;         // Vertex Buffer Object ID
+    unsigned int EBO;         // Element Buffer Object ID (for indices)
+    std::vector<Mesh> meshes; // Spheres in the buffers
 };
 
 #endif // PLANET_H
@@ -0,0 +1,108 @@
+/**
+ * @file render_queue.h
+ * @brief Defines the RenderQueue class, which collects a frame's draws, sorts them by a packed
+ * 64-bit state key and issues them with as few program, texture and vertex array changes as possible.
+ */
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h> // OpenGL types
+
+#include <cstdint>    // For std::uint64_t
+#include <functional> // For std::function
+#include <vector>     // For the item list
+
+/**
+ * @enum RenderPass
+ * @brief Coarse draw order; the most significant field of the sort key.
+ */
+enum class RenderPass : unsigned int
+{
+    Opaque = 0, // Depth-tested, depth-writing geometry, sorted front to back
+    Sky = 1     // Drawn last, only where nothing else was drawn
+};
+
+/**
+ * @struct RenderStats
+ * @brief State changes of the last execute(), and what submission order would have cost.
+ */
+struct RenderStats
+{
+    size_t items = 0;                    // Draw items executed
+    size_t programChanges = 0;           // glUseProgram calls
+    size_t textureBinds = 0;             // glBindTexture calls
+    size_t vertexArrayBinds = 0;         // glBindVertexArray calls
+    size_t unsortedProgramChanges = 0;   // The same, had the items run in submission order
+    size_t unsortedTextureBinds = 0;     // ...
+    size_t unsortedVertexArrayBinds = 0; // ...
+};
+
+/**
+ * @class RenderQueue
+ * @brief Per-frame list of draw items, each carrying the state it needs and a draw callback.
+ *
+ * Key layout, most significant first: pass (4 bits) | program (10) | texture (12) | mesh (14) |
+ * depth (24). The mesh field is the vertex array's low 8 bits above the draw range's low 6
+ * bits, so draws of one vertex array stay together. Program, texture and vertex array names
+ * and draw ranges are truncated to their fields, so two objects can share a key value; that
+ * only costs sort quality, as execute() compares the real state of every item before changing
+ * it. Depth is the distance from the camera, quantized over [0, far]: opaque items sort front to
+ * back within equal state, so early depth testing rejects hidden fragments.
+ */
+class RenderQueue
+{
+public:
+    /**
+     * @brief Starts a new frame: drops last frame's items.
+     * @param farDistance Distance that maps to the largest depth key (the projection's far plane).
+     */
+    void begin(float farDistance);
+
+    /**
+     * @brief Adds a draw item.
+     * @param pass Draw pass.
+     * @param program Shader program the draw needs.
+     * @param textureTarget Target of the texture bound to unit 0 (0 = no texture needed).
+     * @param texture Texture bound to unit 0.
+     * @param vertexArray Vertex array the draw needs.
+     * @param mesh Draw range within the vertex array (sorts draws of one vertex array together).
+     * @param depth Distance from the camera to the nearest point of the item.
+     * @param draw Issues the draw; called with program, texture and vertex array bound.
+     */
+    void submit(RenderPass pass, unsigned int program, GLenum textureTarget, unsigned int texture,
+                unsigned int vertexArray, unsigned int mesh, float depth, std::function<void()> draw);
+
+    /**
+     * @brief Sorts the items by key and issues them, changing state only where it differs.
+     * Texture unit 0 is made active; the vertex array is unbound at the end.
+     */
+    void execute();
+
+    /** @brief State changes of the last execute(). */
+    const RenderStats &stats() const { return lastStats; }
+
+private:
+    /** @brief One submitted draw. */
+    struct Item
+    {
+        std::uint64_t key;          // Sort key
+        unsigned int program;       // Shader program
+        GLenum textureTarget;       // Texture target (0 = none)
+        unsigned int texture;       // Texture name
+        unsigned int vertexArray;   // Vertex array name
+        std::function<void()> draw; // Draw callback
+    };
+
+    /**
+     * @brief Counts the state changes of running @p items in the given order.
+     */
+    static void countChanges(const std::vector<const Item *> &items, size_t &programs, size_t &textures, size_t &vertexArrays);
+
+    std::vector<Item> items;           // This frame's items, in submission order until execute()
+    std::vector<const Item *> ordered; // Scratch: items in execution order
+    float depthScale = 0.0f;           // Depth key units per scene unit
+    RenderStats lastStats;             // Counts of the last execute()
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,103 @@
+/**
+ * @file ring_renderer.h
+ * @brief Defines the RingRenderer class, which draws a planetary ring as a particle field that is
+ * generated entirely in the vertex shader.
+ */
+
+#ifndef RING_RENDERER_H
+#define RING_RENDERER_H
+
+#include <glad/glad.h> // OpenGL types
+#include <glm/glm.hpp> // Vector/matrix types
+
+#include "shader.h"    // For Shader and Uniform handles
+#include "sim_clock.h" // For SimClock::Ticks and PhaseRate
+
+struct ParticleRing; // Forward declaration (full definition in scenario.h)
+
+/**
+ * @class RingRenderer
+ * @brief Draws every particle of a ParticleRing with one instanced draw call and no vertex data.
+ *
+ * The vertex shader (shaders/ring.vert) derives each particle's radius, starting phase, height and
+ * brightness from a hash of its index (gl_InstanceID * BATCH + gl_VertexID), so nothing is stored
+ * or uploaded per particle. Orbital motion is exact at any simulation time: particle speeds are
+ * quantized to integer multiples of one base rate, the CPU evaluates the base phase in fixed point
+ * (see PhaseRate), and the shader multiplies it by each particle's multiple in 32-bit unsigned
+ * arithmetic, which wraps exactly once per revolution.
+ */
+class RingRenderer
+{
+public:
+    static constexpr unsigned int BATCH = 64;        // Points per instance (one instance per point would waste GPU lanes)
+    static constexpr unsigned int RATE_STEPS = 1024; // Base-rate multiples at the outer edge (speed resolution ~0.1%)
+
+    /**
+     * @struct Uniforms
+     * @brief Handles to the ring shader's per-ring uniforms, looked up once per shader.
+     */
+    struct Uniforms
+    {
+        explicit Uniforms(const Shader &shader);
+
+        Uniform<glm::vec3> center;
+        Uniform<glm::mat3> basis;
+        Uniform<float> innerRadius;
+        Uniform<float> outerRadius;
+        Uniform<float> thickness;
+        Uniform<float> rateSteps;
+        Uniform<unsigned int> basePhase;
+        Uniform<unsigned int> seed;
+        Uniform<unsigned int> count;
+        Uniform<glm::vec3> color;
+        Uniform<float> pointSize;
+    };
+
+    /**
+     * @brief Creates the (attribute-less) vertex array and precomputes the ring's frame and rates.
+     * @param ring Ring description (copied; not referenced after construction).
+     * @param normal Ring plane normal in world space (the parent's rotation axis).
+     */
+    RingRenderer(const ParticleRing &ring, const glm::vec3 &normal);
+
+    /**
+     * @brief Destructor that cleans up the OpenGL vertex array.
+     */
+    ~RingRenderer();
+
+    RingRenderer(const RingRenderer &) = delete;            // No copying
+    RingRenderer &operator=(const RingRenderer &) = delete; // No copying
+
+    /**
+     * @brief Draws the ring. vertexArray() must be bound and the ring shader active, with its
+     * FrameData block bound.
+     * @param shader The ring shader (receives the per-ring uniforms).
+     * @param uniforms Handles to @p shader's per-ring uniforms.
+     * @param center Position of the parent body relative to the camera (interpolated like the bodies).
+     * @param simTime Simulation time to draw the particles at (SimSnapshot::interpolatedTicks()).
+     */
+    void draw(const Shader &shader, const Uniforms &uniforms, const glm::vec3 &center, SimClock::Ticks simTime) const;
+
+    /** @brief Number of particles. */
+    size_t size() const { return count; }
+
+    /** @brief Distance from the center to the outer edge. */
+    float radius() const { return outerRadius; }
+
+    /** @brief The (empty) Vertex Array Object the draw needs. */
+    unsigned int vertexArray() const { return VAO; }
+
+private:
+    unsigned int VAO = 0;           // Empty Vertex Array Object (required by core profile draws)
+    size_t count = 0;               // Number of particles
+    glm::mat3 basis = glm::mat3(1); // Ring frame: columns are in-plane X, normal, in-plane Z
+    float innerRadius = 0.0f;       // Inner edge
+    float outerRadius = 0.0f;       // Outer edge
+    float thickness = 0.0f;         // Full vertical extent
+    unsigned int seed = 0;          // Hash seed
+    glm::vec3 color = glm::vec3(1); // Base color
+    float pointSize = 1.0f;         // Point size in pixels
+    PhaseRate baseRate = 0;         // Angular speed at the outer edge / RATE_STEPS
+};
+
+#endif // RING_RENDERER_H
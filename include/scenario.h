@@ -9,13 +9,22 @@
 #include <string>
 #include <vector>
 #include <optional>    // For optional parent name
-#include <memory>      // For std::unique_ptr
+#include <memory>      // For std::shared_ptr
 #include <glm/glm.hpp> // Vector types
 
-// Forward declaration of Planet class to avoid circular dependency
-// Include the full "planet.h" in scenario.cpp where unique_ptr needs the definition.
-class Planet;
-class Shader; // Forward declaration
+#include "kepler.h" // For KeplerElements
+
+class SpkFile; // Forward declaration (full definition in spk_file.h)
+
+/**
+ * @enum Dynamics
+ * @brief How a body's position is computed.
+ */
+enum class Dynamics
+{
+    Analytic, // Scripted: circular orbit or Kepler elements, evaluated in closed form at any time
+    NBody     // Integrated under the gravity of every massive body (see NBodySystem)
+};
 
 /**
  * @struct CelestialBody
@@ -34,14 +43,24 @@ struct CelestialBody
     float orbitSpeed;       // Speed of orbit around the parent (relative units)
     float rotationSpeed;    // Speed of rotation on its own axis (relative units)
     glm::vec3 rotationAxis; // Axis of rotation
+    // Optional elliptical orbit. When set, it replaces orbitRadius/orbitSpeed for the body's position.
+    std::optional<KeplerElements> orbitElements;
+    // Optional NAIF ID (e.g. 399 = Earth). When the scenario has an ephemeris that connects this body
+    // and its parent, their real relative position replaces the orbit above (see Scenario::ephemeris).
+    std::optional<int> ephemerisId;
+
+    // Gravity
+    float mass = 0.0f;                      // Gravitational parameter G*M in scene units (0 = exerts no gravity)
+    Dynamics dynamics = Dynamics::Analytic; // N-body bodies start on the orbit above, at the speed the parent's mass gives it
 
     // Hierarchy
     std::optional<std::string> parentName; // Name of the parent body, if any
 
-    // Rendering data (initialized later)
-    unsigned int textureID = 0;                     // OpenGL texture ID
-    glm::mat4 currentModelMatrix = glm::mat4(1.0f); // Current world transform matrix, updated each frame
-    std::unique_ptr<Planet> mesh = nullptr;         // The sphere mesh (using unique_ptr for ownership and RAII)
+    // Rendering data. Scenarios describe no mesh: the renderer draws every body from one chain
+    // of unit spheres, picking the detail from its size on screen (scenarios are part of the
+    // display-independent core and never touch OpenGL).
+    unsigned int textureLayer = 0; // Layer of the renderer's body texture array (set by the renderer)
+    // Note: World transforms are not stored per body; see TransformHierarchy (hierarchy.h)
 
     /**
      * @brief Parameterized constructor.
@@ -55,13 +74,45 @@ struct CelestialBody
 
     // Explicitly default the default constructor (needed due to other constructors)
     CelestialBody() = default;
+};
 
-    // Explicitly define/default special member functions because we have unique_ptr
-    ~CelestialBody();                                         // Defined in .cpp
-    CelestialBody(const CelestialBody &) = delete;            // No copying
-    CelestialBody &operator=(const CelestialBody &) = delete; // No copying
-    CelestialBody(CelestialBody &&) = default;                // Default move constructor
-    CelestialBody &operator=(CelestialBody &&) = default;     // Default move assignment
+/**
+ * @struct ParticleBelt
+ * @brief A ring of small N-body particles (asteroids, ring debris) around one body.
+ * Particles are rendered as points and are always simulated with Dynamics::NBody.
+ */
+struct ParticleBelt
+{
+    std::string parentName;                         // Body the particles orbit
+    size_t count = 0;                               // Number of particles
+    float innerRadius = 0.0f;                       // Smallest semi-major axis
+    float outerRadius = 0.0f;                       // Largest semi-major axis
+    float maxEccentricity = 0.0f;                   // Eccentricities are uniform in [0, maxEccentricity]
+    float maxInclination = 0.0f;                    // Inclinations (radians) are uniform in [0, maxInclination]
+    float totalMass = 0.0f;                         // Combined G*M of all particles, shared equally
+    unsigned int seed = 1;                          // Random seed for the orbital elements
+    glm::vec3 color = glm::vec3(0.6f, 0.55f, 0.5f); // Point color
+    float pointSize = 2.0f;                         // Point size in pixels
+};
+
+/**
+ * @struct ParticleRing
+ * @brief A planetary ring drawn as a particle field generated entirely on the GPU (see RingRenderer).
+ * Particles are not stored or simulated on the CPU: each one's radius, phase and height are hashed
+ * from its index in the vertex shader, and it orbits at the Keplerian rate for its radius. Rings
+ * are purely visual (no mass, not part of the N-body mode).
+ */
+struct ParticleRing
+{
+    std::string parentName;                          // Body the ring is centred on; the ring lies in its equatorial plane
+    size_t count = 0;                                // Number of particles
+    float innerRadius = 0.0f;                        // Inner edge, in scene units
+    float outerRadius = 0.0f;                        // Outer edge, in scene units
+    float thickness = 0.0f;                          // Full vertical extent, in scene units
+    float innerSpeed = 0.0f;                         // Angular speed at the inner edge (radians per second); falls off as r^-1.5
+    unsigned int seed = 1;                           // Hash seed (different seeds give different particle layouts)
+    glm::vec3 color = glm::vec3(0.8f, 0.75f, 0.65f); // Base particle color (varied per particle)
+    float pointSize = 1.5f;                          // Point size in pixels
 };
 
 /**
@@ -71,9 +122,18 @@ struct CelestialBody
 struct Scenario
 {
     std::vector<CelestialBody> bodies; // List of all celestial bodies in the scene
+    std::vector<ParticleBelt> belts;   // Particle belts (simulated by the N-body mode, if any)
+    std::vector<ParticleRing> rings;   // Planetary rings (GPU-generated, purely visual)
     glm::vec3 initialCameraPos;        // Starting position for the camera
     glm::vec3 lightPos;                // Position of the primary light source (usually the Sun)
     glm::vec3 lightColor;              // Color of the primary light source
+
+    // Optional ephemeris. Bodies with an ephemerisId (and a parent that has one) take their offset
+    // from the parent from this file, rescaled so the distance at the epoch matches their scenario
+    // orbit radius: directions, eccentricities and phases are real, distances stay compressed.
+    std::shared_ptr<const SpkFile> ephemeris; // Memory-mapped SPK file, or null
+    double ephemerisEpoch = 0.0;              // Ephemeris time (TDB seconds past J2000) at simulation time 0
+    double ephemerisTimeScale = 1.0;          // Ephemeris seconds per simulation second
 };
 
 /**
@@ -82,4 +142,20 @@ struct Scenario
  */
 Scenario loadScenario_SolarSystemBasic();
 
+/**
+ * @brief Loads the basic solar system with masses and an N-body asteroid belt between Mars and
+ * Jupiter. The planets stay analytic and pull on the belt; the belt particles also attract each other.
+ * @param particleCount Number of belt particles.
+ */
+Scenario loadScenario_AsteroidBelt(size_t particleCount);
+
+/**
+ * @brief Loads the basic solar system with the planets and the Moon positioned from a JPL SPK
+ * ephemeris (e.g. de440s.bsp). If the file cannot be used, the scripted orbits are kept.
+ * @param path Path to the SPK file.
+ * @param epochDays Date shown at simulation time 0, in TDB days past J2000 (2000-01-01 12:00).
+ * @param daysPerSecond Ephemeris days per simulation second.
+ */
+Scenario loadScenario_Ephemeris(const std::string &path, double epochDays, double daysPerSecond);
+
 #endif // SCENARIO_H
@@ -0,0 +1,37 @@
+/**
+ * @file scene_frame.h
+ * @brief The mapping from astronomical reference frames into scene coordinates, shared by every
+ * orbit path (circular orbits, Kepler orbits, belt particles, rings and ephemeris bodies).
+ */
+
+#ifndef SCENE_FRAME_H
+#define SCENE_FRAME_H
+
+#include <glm/glm.hpp> // Vector types
+
+/**
+ * @brief Scene coordinates of a vector given in a reference plane's coordinates (x: reference
+ * direction, y: 90 degrees ahead of it in the plane, north: the plane's north pole).
+ *
+ * The scene is Y-up and right-handed: x -> X, y -> -Z, north -> Y is a proper rotation, so
+ * prograde motion (counterclockwise seen from north) turns counterclockwise seen from +Y, the
+ * same way as a positive glm::rotate() about +Y spins a body. A circular orbit at phase angle a
+ * is therefore at (cos a, 0, -sin a); the orbit kernel and shaders/ring.vert follow this too.
+ */
+inline glm::dvec3 referenceToScene(double x, double y, double north)
+{
+    return glm::dvec3(x, north, -y);
+}
+
+/**
+ * @brief Scene coordinates of a vector in the J2000 equatorial frame (as SPK files store
+ * positions): rotated about the vernal equinox by the J2000 obliquity into the ecliptic, whose
+ * north becomes scene +Y, then mapped like any reference plane.
+ */
+inline glm::dvec3 equatorialToScene(double x, double y, double z)
+{
+    const double cosObliquity = 0.9174820620691818, sinObliquity = 0.3977771559319137; // J2000 obliquity, 23.439 deg
+    return referenceToScene(x, cosObliquity * y + sinObliquity * z, -sinObliquity * y + cosObliquity * z);
+}
+
+#endif // SCENE_FRAME_H
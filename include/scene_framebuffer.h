@@ -0,0 +1,73 @@
+/**
+ * @file scene_framebuffer.h
+ * @brief Defines the SceneFramebuffer class, the off-screen target with a 32-bit float depth
+ * buffer used by the reverse-Z and logarithmic depth modes (see depth_mode.h).
+ */
+
+#ifndef SCENE_FRAMEBUFFER_H
+#define SCENE_FRAMEBUFFER_H
+
+#include <glad/glad.h> // OpenGL types
+
+#include <string> // For the image path
+
+/**
+ * @class SceneFramebuffer
+ * @brief A framebuffer object with an RGBA8 color and a GL_DEPTH_COMPONENT32F depth renderbuffer.
+ *
+ * The default framebuffer's depth format cannot be chosen portably (GLFW only asks for a bit
+ * count), so the scene is drawn here and its color copied to the window by present(); the
+ * overlay is drawn on top afterwards. A headless context has no window, so there the scene and
+ * overlay stay here and writePPM() reads the result back.
+ */
+class SceneFramebuffer
+{
+public:
+    SceneFramebuffer() = default;
+
+    /**
+     * @brief Destructor that cleans up the framebuffer and renderbuffers.
+     */
+    ~SceneFramebuffer();
+
+    SceneFramebuffer(const SceneFramebuffer &) = delete;            // No copying
+    SceneFramebuffer &operator=(const SceneFramebuffer &) = delete; // No copying
+
+    /**
+     * @brief (Re)creates the attachments at @p width x @p height pixels; nothing happens if the
+     * size is unchanged. Call every frame with the current framebuffer size.
+     * @return True if the framebuffer is complete (false e.g. while the window is minimized).
+     */
+    bool resize(int width, int height);
+
+    /**
+     * @brief Binds the framebuffer for drawing the scene.
+     */
+    void bind() const;
+
+    /**
+     * @brief Copies the color to the default framebuffer and binds that again.
+     */
+    void present() const;
+
+    /**
+     * @brief Writes the color attachment to @p path as a binary PPM (P6) image, top row first.
+     * @return False (with a message on std::cerr) if the file cannot be written.
+     */
+    bool writePPM(const std::string &path) const;
+
+private:
+    /**
+     * @brief Deletes the framebuffer and renderbuffers.
+     */
+    void release();
+
+    GLuint FBO = 0;        // Framebuffer Object ID
+    GLuint colorRBO = 0;   // RGBA8 color renderbuffer
+    GLuint depthRBO = 0;   // 32-bit float depth renderbuffer
+    int width = 0;         // Current size in pixels
+    int height = 0;        // Current size in pixels
+    bool complete = false; // Framebuffer status after the last resize
+};
+
+#endif // SCENE_FRAMEBUFFER_H
@@ -9,16 +9,78 @@
 #include <glad/glad.h> // OpenGL types
 #include <glm/glm.hpp> // Matrix/vector types
 
-#include <string>   // For file paths and uniform names
-#include <fstream>  // For file reading
-#include <sstream>  // For reading file into string
-#include <iostream> // For error reporting
+#include <string>        // For file paths and uniform names
+#include <fstream>       // For file reading
+#include <sstream>       // For reading file into string
+#include <iostream>      // For error reporting
+#include <unordered_map> // For the uniform location cache
+
+/**
+ * @struct Uniform
+ * @brief Typed handle to a uniform of one Shader: its location, looked up once with
+ * Shader::uniform(). Setting it with Shader::set() does no string work. A handle to a uniform
+ * the program does not have (location -1) is ignored by OpenGL, like glUniform* with -1.
+ */
+template <typename T>
+struct Uniform
+{
+    GLint location = -1; // Location in the program that created the handle
+};
+
+/**
+ * @struct UniformType
+ * @brief Which GLSL uniform types a Uniform<T> may refer to (checked when the handle is created).
+ */
+template <typename T>
+struct UniformType;
+template <>
+struct UniformType<bool>
+{
+    static bool matches(GLenum type) { return type == GL_BOOL; }
+};
+template <>
+struct UniformType<int>
+{
+    static bool matches(GLenum type) // Samplers are set to texture unit numbers
+    {
+        return type == GL_INT || type == GL_SAMPLER_2D || type == GL_SAMPLER_2D_ARRAY || type == GL_SAMPLER_CUBE;
+    }
+};
+template <>
+struct UniformType<unsigned int>
+{
+    static bool matches(GLenum type) { return type == GL_UNSIGNED_INT; }
+};
+template <>
+struct UniformType<float>
+{
+    static bool matches(GLenum type) { return type == GL_FLOAT; }
+};
+template <>
+struct UniformType<glm::vec3>
+{
+    static bool matches(GLenum type) { return type == GL_FLOAT_VEC3; }
+};
+template <>
+struct UniformType<glm::mat3>
+{
+    static bool matches(GLenum type) { return type == GL_FLOAT_MAT3; }
+};
+template <>
+struct UniformType<glm::mat4>
+{
+    static bool matches(GLenum type) { return type == GL_FLOAT_MAT4; }
+};
 
 /**
  * @class Shader
  * @brief Encapsulates loading GLSL shaders from files, compiling them,
  * linking them into a shader program, and providing utility functions
  * for activating the program and setting uniform variables.
+ *
+ * The active uniforms are reflected once after linking, so no setter queries the driver for a
+ * location. The name-based setters still hash the name on every call; per-frame code creates
+ * typed Uniform handles once and sets them with set().
  */
 class Shader
 {
@@ -30,21 +92,62 @@ public:
      * @brief Constructor that reads shader source from files, compiles, and links them.
      * @param vertexPath Path to the vertex shader source file (.vert).
      * @param fragmentPath Path to the fragment shader source file (.frag).
+     * @param defines Lines inserted into both sources after their #version line, to select a
+     *                variant (e.g. "#define UNIFORM_SCALE\n").
      */
-    Shader(const char *vertexPath, const char *fragmentPath);
+    Shader(const char *vertexPath, const char *fragmentPath, const std::string &defines = "");
 
     /**
      * @brief Activates this shader program for subsequent rendering calls.
      */
     void use();
 
+    /**
+     * @brief Connects the uniform block @p blockName to uniform buffer binding point @p binding
+     * (GLSL 3.30 cannot declare the binding in the shader).
+     * @return False if the program has no active block of that name.
+     */
+    bool bindUniformBlock(const char *blockName, GLuint binding) const;
+
+    /**
+     * @brief Returns a handle to the active uniform @p name (location -1 if the program has none,
+     * e.g. because the compiler removed it). Warns if its GLSL type does not fit T.
+     */
+    template <typename T>
+    Uniform<T> uniform(const std::string &name) const
+    {
+        auto it = uniforms.find(name);
+        if (it == uniforms.end())
+            return Uniform<T>();
+        if (!UniformType<T>::matches(it->second.type))
+            std::cerr << "Warning: Uniform '" << name << "' has a different GLSL type than its handle" << std::endl;
+        return Uniform<T>{it->second.location};
+    }
+
     // --- Utility functions for setting uniform variables ---
     // Note: The shader program must be active (use() called) before setting uniforms.
 
+    /** @brief Sets a boolean uniform through its handle. */
+    void set(Uniform<bool> uniform, bool value) const { glUniform1i(uniform.location, (int)value); }
+    /** @brief Sets an integer (or sampler) uniform through its handle. */
+    void set(Uniform<int> uniform, int value) const { glUniform1i(uniform.location, value); }
+    /** @brief Sets an unsigned integer uniform through its handle. */
+    void set(Uniform<unsigned int> uniform, unsigned int value) const { glUniform1ui(uniform.location, value); }
+    /** @brief Sets a float uniform through its handle. */
+    void set(Uniform<float> uniform, float value) const { glUniform1f(uniform.location, value); }
+    /** @brief Sets a vec3 uniform through its handle. */
+    void set(Uniform<glm::vec3> uniform, const glm::vec3 &value) const { glUniform3fv(uniform.location, 1, &value[0]); }
+    /** @brief Sets a mat3 uniform through its handle. */
+    void set(Uniform<glm::mat3> uniform, const glm::mat3 &mat) const { glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &mat[0][0]); }
+    /** @brief Sets a mat4 uniform through its handle. */
+    void set(Uniform<glm::mat4> uniform, const glm::mat4 &mat) const { glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]); }
+
     /** @brief Sets a boolean uniform. */
     void setBool(const std::string &name, bool value) const;
     /** @brief Sets an integer uniform. */
     void setInt(const std::string &name, int value) const;
+    /** @brief Sets an unsigned integer uniform. */
+    void setUint(const std::string &name, unsigned int value) const;
     /** @brief Sets a float uniform. */
     void setFloat(const std::string &name, float value) const;
     /** @brief Sets a vec3 uniform (using glm::vec3). */
@@ -57,6 +160,25 @@ public:
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
 private:
+    /** @brief An active uniform found when the program was linked. */
+    struct ActiveUniform
+    {
+        GLint location; // Uniform location
+        GLenum type;    // GLSL type (GL_FLOAT_MAT4, GL_SAMPLER_2D, ...)
+    };
+
+    std::unordered_map<std::string, ActiveUniform> uniforms; // Active uniforms by name
+
+    /**
+     * @brief Fills the uniform cache from the linked program (glGetActiveUniform).
+     */
+    void reflectUniforms();
+
+    /**
+     * @brief Cached location of @p name, or -1 if the program has no such active uniform.
+     */
+    GLint locationOf(const std::string &name) const;
+
     /**
      * @brief Utility function for checking shader compilation or program linking errors.
      * Prints errors to the console if any occur.
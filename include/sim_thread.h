@@ -0,0 +1,163 @@
+/**
+ * @file sim_thread.h
+ * @brief Defines the SimulationThread class, which advances the simulation at a fixed tick rate
+ * on its own thread and hands body transforms to the render loop through a triple buffer.
+ */
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <glm/glm.hpp> // Matrix types
+
+#include "triple_buffer.h" // Lock-free snapshot handoff
+#include "sim_clock.h"     // Fixed-point simulation clock
+#include "nbody.h"         // For NBodyStats
+
+#include <atomic> // For the warp / seek / run flags
+#include <thread> // For std::thread
+#include <vector> // For the transform arrays
+
+class Simulation; // Forward declaration (full definition in simulation.h)
+
+/**
+ * @struct SimSnapshot
+ * @brief Body transforms (and N-body particle positions) of the two most recent simulation
+ * ticks, as published to the renderer.
+ */
+struct SimSnapshot
+{
+    unsigned long long tick = 0;               // Tick number of 'current'
+    double simTime = 0.0;                      // Simulation time of 'current' (seconds, for display)
+    SimClock::Ticks previousTicks = 0;         // Simulation time of 'previous', in clock ticks
+    SimClock::Ticks currentTicks = 0;          // Simulation time of 'current', in clock ticks
+    double warp = 1.0;                         // Time warp factor in effect for 'current'
+    double tickTime = 0.0;                     // Wall-clock time (SimulationThread::clockSeconds()) 'current' was due
+    double tickInterval = 0.0;                 // Wall-clock seconds between ticks
+    std::vector<glm::mat4> previous;           // World matrices at tick - 1 (node order)
+    std::vector<glm::mat4> current;            // World matrices at tick (node order)
+    std::vector<glm::dvec3> previousPositions; // World positions at tick - 1, double precision (node order)
+    std::vector<glm::dvec3> currentPositions;  // World positions at tick, double precision (node order)
+    std::vector<glm::vec3> particlesPrevious;  // N-body particle positions at tick - 1, relative to particleOriginPrevious
+    std::vector<glm::vec3> particles;          // N-body particle positions at tick, relative to particleOrigin
+    glm::dvec3 particleOriginPrevious{0.0};    // World position 'particlesPrevious' are relative to
+    glm::dvec3 particleOrigin{0.0};            // World position 'particles' are relative to
+    NBodyStats nbodyStats;                     // Cost of the N-body step that produced 'current'
+    size_t transformsRecomputed = 0;           // Node transforms the hierarchy recomputed for 'current'
+
+    // Content versions: a version changes only when the data changes, so equal versions mean
+    // equal contents (used to skip copies, uploads and interpolation while nothing moves)
+    unsigned long long transformVersion = 0;         // Version of 'current'
+    unsigned long long previousTransformVersion = 0; // Version of 'previous'
+    unsigned long long particleVersion = 0;          // Version of 'particles' and 'particleOrigin'
+    unsigned long long previousParticleVersion = 0;  // Version of 'particlesPrevious' and 'particleOriginPrevious'
+
+    /** @brief True if previous == current, i.e. interpolate() returns 'current' at any time. */
+    bool settled() const { return previousTransformVersion == transformVersion; }
+
+    /**
+     * @brief Fraction of the way from previous to current that corresponds to @p now, in [0, 1].
+     * @param now Current wall-clock time (SimulationThread::clockSeconds()).
+     */
+    float blendFactor(double now) const;
+
+    /**
+     * @brief Simulation time matching interpolate(): previousTicks -> currentTicks by blendFactor().
+     * @param now Current wall-clock time (SimulationThread::clockSeconds()).
+     */
+    SimClock::Ticks interpolatedTicks(double now) const;
+
+    /**
+     * @brief Blends previous -> current according to how far @p now is into the next tick.
+     * The result lags the simulation by up to one tick, which keeps motion smooth when the
+     * render rate and the tick rate differ. Rotations are slerped, so the matrices keep their
+     * scale; a body that turned by more than 45 degrees within the tick is shown at current's
+     * orientation.
+     * @param now Current wall-clock time (SimulationThread::clockSeconds()).
+     * @param out Receives one interpolated matrix per node (resized as needed).
+     * @param positions Receives one interpolated world position per node, blended in double
+     *                  precision (resized as needed).
+     */
+    void interpolate(double now, std::vector<glm::mat4> &out, std::vector<glm::dvec3> &positions) const;
+};
+
+/**
+ * @class SimulationThread
+ * @brief Runs Simulation::step() at a fixed rate on a dedicated thread.
+ *
+ * The render loop never waits for the simulation: it calls acquireLatest() once per frame and
+ * interpolates the latest snapshot. The time warp can be changed, and the clock moved to any
+ * time, from any thread; both take effect at the next tick.
+ * While the thread runs it owns the Simulation; callers may still use its hierarchy's
+ * read-only topology queries (findNode, bodyIndexOf, ...).
+ */
+class SimulationThread
+{
+public:
+    /**
+     * @brief Constructor: Fills every snapshot slot with the simulation's current state.
+     * The thread is not started until start() is called.
+     * @param simulation Simulation to advance (must outlive this object).
+     * @param tickRate Simulation ticks per wall-clock second.
+     */
+    SimulationThread(Simulation &simulation, double tickRate);
+
+    /**
+     * @brief Destructor: Stops and joins the thread if it is running.
+     */
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread &) = delete;            // No copying
+    SimulationThread &operator=(const SimulationThread &) = delete; // No copying
+
+    /** @brief Starts ticking. */
+    void start();
+
+    /** @brief Stops ticking and joins the thread. */
+    void stop();
+
+    /** @brief Sets the time warp (sim seconds per wall-clock second, see SimClock::setWarp). */
+    void setWarp(double warp) { warpFactor.store(warp, std::memory_order_relaxed); }
+
+    /** @brief Requested time warp factor. */
+    double warp() const { return warpFactor.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Requests a jump to an absolute simulation time. Applied at the next tick;
+     * the snapshot published then is not interpolated with the state before the jump.
+     */
+    void seek(double simSeconds);
+
+    /**
+     * @brief Render side: picks up the most recent snapshot, if a new one was published.
+     * @return true if latest() changed.
+     */
+    bool acquireLatest() { return snapshots.acquire(); }
+
+    /** @brief Render side: the snapshot obtained by the last acquireLatest(). */
+    const SimSnapshot &latest() const { return snapshots.readBuffer(); }
+
+    /** @brief Monotonic wall-clock time in seconds used for tick scheduling and interpolation. */
+    static double clockSeconds();
+
+private:
+    void run();
+
+    Simulation &simulation;                  // Owned by the simulation thread once started
+    double tickInterval;                     // Wall-clock seconds per tick
+    std::vector<glm::mat4> lastTick;         // Transforms of the previous tick (simulation thread only)
+    std::vector<glm::dvec3> lastPositions;   // World positions of the previous tick (simulation thread only)
+    std::vector<glm::vec3> lastParticles;    // Particle positions of the previous tick (simulation thread only)
+    glm::dvec3 lastParticleOrigin{0.0};      // World position lastParticles are relative to (simulation thread only)
+    SimClock::Ticks lastTicks = 0;           // Simulation time of the previous tick (simulation thread only)
+    unsigned long long transformVersion = 0; // Version of the hierarchy's current transforms (and lastTick)
+    unsigned long long particleVersion = 0;  // Version of the current particle positions (and lastParticles)
+
+    std::atomic<double> warpFactor{1.0};
+    std::atomic<double> seekTarget{0.0};
+    std::atomic<bool> seekPending{false};
+    std::atomic<bool> running{false};
+    std::thread thread;
+    TripleBuffer<SimSnapshot> snapshots;
+};
+
+#endif // SIM_THREAD_H
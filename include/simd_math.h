@@ -0,0 +1,191 @@
+/**
+ * @file simd_math.h
+ * @brief Minimal SIMD abstraction (AVX2, SSE4.1 or scalar) and vectorized math used by the batch kernels.
+ *
+ * The backend is chosen at compile time from the instruction set the translation unit is built
+ * for (see SOLAR_SIMD in CMakeLists.txt). Kernels are written once against the Simd type and the
+ * free functions below, and process Simd::width lanes per iteration.
+ */
+
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cmath>   // For std::floor, std::sqrt (scalar backend)
+#include <cstdint> // For std::int32_t
+
+#if defined(__AVX2__) && defined(__FMA__)
+#define SOLAR_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#define SOLAR_SIMD_SSE4 1
+#include <smmintrin.h>
+#endif
+
+namespace simd
+{
+
+#if defined(SOLAR_SIMD_AVX2)
+
+/** @brief 8 packed floats (AVX2 + FMA backend). */
+struct Simd
+{
+    static constexpr int width = 8;
+    static constexpr const char *name = "AVX2";
+    __m256 v;
+    Simd() = default;
+    Simd(__m256 x) : v(x) {}
+};
+
+inline Simd set1(float x) { return _mm256_set1_ps(x); }
+inline Simd load(const float *p) { return _mm256_loadu_ps(p); }
+inline void store(float *p, Simd a) { _mm256_storeu_ps(p, a.v); }
+inline Simd operator+(Simd a, Simd b) { return _mm256_add_ps(a.v, b.v); }
+inline Simd operator-(Simd a, Simd b) { return _mm256_sub_ps(a.v, b.v); }
+inline Simd operator*(Simd a, Simd b) { return _mm256_mul_ps(a.v, b.v); }
+inline Simd operator/(Simd a, Simd b) { return _mm256_div_ps(a.v, b.v); }
+inline Simd fmadd(Simd a, Simd b, Simd c) { return _mm256_fmadd_ps(a.v, b.v, c.v); } // a * b + c
+inline Simd fnmadd(Simd a, Simd b, Simd c) { return _mm256_fnmadd_ps(a.v, b.v, c.v); } // c - a * b
+inline Simd min(Simd a, Simd b) { return _mm256_min_ps(a.v, b.v); }
+inline Simd max(Simd a, Simd b) { return _mm256_max_ps(a.v, b.v); }
+inline Simd sqrt(Simd a) { return _mm256_sqrt_ps(a.v); }
+inline Simd rsqrtEstimate(Simd a) { return _mm256_rsqrt_ps(a.v); } // ~12 bits
+inline Simd round(Simd a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline Simd floor(Simd a) { return _mm256_floor_ps(a.v); }
+inline Simd select(Simd mask, Simd a, Simd b) { return _mm256_blendv_ps(b.v, a.v, mask.v); } // mask ? a : b
+inline Simd cmplt(Simd a, Simd b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline Simd operator&(Simd a, Simd b) { return _mm256_and_ps(a.v, b.v); }
+inline Simd operator^(Simd a, Simd b) { return _mm256_xor_ps(a.v, b.v); }
+inline int movemask(Simd mask) { return _mm256_movemask_ps(mask.v); } // Bit l set where lane l is set
+/** @brief Lane-wise test of bit 0 / bit 1 of the rounded integer value of @p q (q is integral). */
+inline Simd quadrantBit(Simd q, int bit)
+{
+    __m256i qi = _mm256_cvtps_epi32(q.v);
+    __m256i b = _mm256_and_si256(qi, _mm256_set1_epi32(1 << bit));
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(b, _mm256_set1_epi32(1 << bit)));
+}
+
+#elif defined(SOLAR_SIMD_SSE4)
+
+/** @brief 4 packed floats (SSE4.1 backend). */
+struct Simd
+{
+    static constexpr int width = 4;
+    static constexpr const char *name = "SSE4.1";
+    __m128 v;
+    Simd() = default;
+    Simd(__m128 x) : v(x) {}
+};
+
+inline Simd set1(float x) { return _mm_set1_ps(x); }
+inline Simd load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, Simd a) { _mm_storeu_ps(p, a.v); }
+inline Simd operator+(Simd a, Simd b) { return _mm_add_ps(a.v, b.v); }
+inline Simd operator-(Simd a, Simd b) { return _mm_sub_ps(a.v, b.v); }
+inline Simd operator*(Simd a, Simd b) { return _mm_mul_ps(a.v, b.v); }
+inline Simd operator/(Simd a, Simd b) { return _mm_div_ps(a.v, b.v); }
+inline Simd fmadd(Simd a, Simd b, Simd c) { return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v); }
+inline Simd fnmadd(Simd a, Simd b, Simd c) { return _mm_sub_ps(c.v, _mm_mul_ps(a.v, b.v)); }
+inline Simd min(Simd a, Simd b) { return _mm_min_ps(a.v, b.v); }
+inline Simd max(Simd a, Simd b) { return _mm_max_ps(a.v, b.v); }
+inline Simd sqrt(Simd a) { return _mm_sqrt_ps(a.v); }
+inline Simd rsqrtEstimate(Simd a) { return _mm_rsqrt_ps(a.v); } // ~12 bits
+inline Simd round(Simd a) { return _mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline Simd floor(Simd a) { return _mm_floor_ps(a.v); }
+inline Simd select(Simd mask, Simd a, Simd b) { return _mm_blendv_ps(b.v, a.v, mask.v); }
+inline Simd cmplt(Simd a, Simd b) { return _mm_cmplt_ps(a.v, b.v); }
+inline Simd operator&(Simd a, Simd b) { return _mm_and_ps(a.v, b.v); }
+inline Simd operator^(Simd a, Simd b) { return _mm_xor_ps(a.v, b.v); }
+inline int movemask(Simd mask) { return _mm_movemask_ps(mask.v); }
+inline Simd quadrantBit(Simd q, int bit)
+{
+    __m128i qi = _mm_cvtps_epi32(q.v);
+    __m128i b = _mm_and_si128(qi, _mm_set1_epi32(1 << bit));
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(b, _mm_set1_epi32(1 << bit)));
+}
+
+#else
+
+/** @brief Single float (portable scalar fallback). Masks are 0.0f / non-zero. */
+struct Simd
+{
+    static constexpr int width = 1;
+    static constexpr const char *name = "scalar";
+    float v;
+    Simd() = default;
+    Simd(float x) : v(x) {}
+};
+
+inline Simd set1(float x) { return x; }
+inline Simd load(const float *p) { return *p; }
+inline void store(float *p, Simd a) { *p = a.v; }
+inline Simd operator+(Simd a, Simd b) { return a.v + b.v; }
+inline Simd operator-(Simd a, Simd b) { return a.v - b.v; }
+inline Simd operator*(Simd a, Simd b) { return a.v * b.v; }
+inline Simd operator/(Simd a, Simd b) { return a.v / b.v; }
+inline Simd fmadd(Simd a, Simd b, Simd c) { return a.v * b.v + c.v; }
+inline Simd fnmadd(Simd a, Simd b, Simd c) { return c.v - a.v * b.v; }
+inline Simd min(Simd a, Simd b) { return a.v < b.v ? a.v : b.v; }
+inline Simd max(Simd a, Simd b) { return a.v > b.v ? a.v : b.v; }
+inline Simd sqrt(Simd a) { return std::sqrt(a.v); }
+inline Simd rsqrtEstimate(Simd a) { return 1.0f / std::sqrt(a.v); }
+inline Simd round(Simd a) { return std::nearbyint(a.v); }
+inline Simd floor(Simd a) { return std::floor(a.v); }
+inline Simd select(Simd mask, Simd a, Simd b) { return mask.v != 0.0f ? a : b; }
+inline Simd cmplt(Simd a, Simd b) { return a.v < b.v ? 1.0f : 0.0f; }
+inline Simd quadrantBit(Simd q, int bit) { return (static_cast<std::int32_t>(q.v) & (1 << bit)) ? 1.0f : 0.0f; }
+inline int movemask(Simd mask) { return mask.v != 0.0f ? 1 : 0; }
+/** @brief Negates @p a where @p mask is set (scalar stand-in for a sign-bit xor). */
+inline Simd negateIf(Simd mask, Simd a) { return mask.v != 0.0f ? -a.v : a.v; }
+
+#endif
+
+#if defined(SOLAR_SIMD_AVX2) || defined(SOLAR_SIMD_SSE4)
+/** @brief Negates the lanes of @p a where @p mask is set (flips the sign bit). */
+inline Simd negateIf(Simd mask, Simd a) { return a ^ (mask & set1(-0.0f)); }
+#endif
+
+/**
+ * @brief 1 / sqrt(a): hardware estimate refined by one Newton-Raphson step (~22 bits),
+ * much cheaper than a square root followed by a division. Returns +inf for a = 0.
+ */
+inline Simd rsqrt(Simd a)
+{
+    Simd y = rsqrtEstimate(a);
+    // y * (1.5 - 0.5 * a * y * y)
+    return y * fnmadd(set1(0.5f) * a, y * y, set1(1.5f));
+}
+
+/**
+ * @brief Computes sine and cosine of every lane at once.
+ * Cephes-style: Cody-Waite reduction by pi/2 followed by minimax polynomials on [-pi/4, pi/4].
+ * Max error is a few ulp for |x| up to ~1e5; accuracy degrades gracefully beyond that.
+ */
+inline void sincos(Simd x, Simd &s, Simd &c)
+{
+    // q = nearest integer to x / (pi/2); r = x - q * (pi/2) in three parts for extra precision
+    Simd q = round(x * set1(0.63661977236758134f));
+    Simd r = fnmadd(q, set1(1.5703125f), x);
+    r = fnmadd(q, set1(4.837512969970703125e-4f), r);
+    r = fnmadd(q, set1(7.54978995489188216e-8f), r);
+
+    Simd r2 = r * r;
+    // sin(r) on [-pi/4, pi/4]
+    Simd ps = fmadd(r2, set1(-1.9515295891e-4f), set1(8.3321608736e-3f));
+    ps = fmadd(ps, r2, set1(-1.6666654611e-1f));
+    ps = fmadd(ps * r2, r, r);
+    // cos(r) on [-pi/4, pi/4]
+    Simd pc = fmadd(r2, set1(2.443315711809948e-5f), set1(-1.388731625493765e-3f));
+    pc = fmadd(pc, r2, set1(4.166664568298827e-2f));
+    pc = fmadd(pc * r2, r2, fnmadd(set1(0.5f), r2, set1(1.0f)));
+
+    // Quadrant fix-up: odd quadrants swap sin/cos; quadrants 2,3 negate sin, 1,2 negate cos
+    Simd swap = quadrantBit(q, 0);
+    Simd sinBase = select(swap, pc, ps);
+    Simd cosBase = select(swap, ps, pc);
+    s = negateIf(quadrantBit(q, 1), sinBase);
+    c = negateIf(quadrantBit(q + set1(1.0f), 1), cosBase);
+}
+
+} // namespace simd
+
+#endif // SIMD_MATH_H
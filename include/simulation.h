@@ -0,0 +1,109 @@
+/**
+ * @file simulation.h
+ * @brief Defines the Simulation class, the display-independent core of the application: a
+ * compiled scenario, its N-body system, a worker pool and the simulation clock behind a
+ * step()/seek() API. Nothing in the core library depends on GLFW or OpenGL.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <glm/glm.hpp> // Vector/matrix types
+
+#include "hierarchy.h"   // For the compiled transform hierarchy
+#include "nbody.h"       // For the N-body system and its settings
+#include "sim_clock.h"   // Fixed-point simulation clock
+#include "thread_pool.h" // Worker pool for the updates
+
+#include <vector> // For the read-only views
+
+struct Scenario; // Forward declaration (full definition in scenario.h)
+
+/**
+ * @struct SimulationSettings
+ * @brief Construction-time settings of a Simulation.
+ */
+struct SimulationSettings
+{
+    unsigned int workerThreads = 0; // Threads for the updates, including the caller (0 = one per hardware thread)
+    double startTime = 0.0;         // Simulation time (seconds) of the initial state
+    NBodySettings nbody;            // Integrator settings (used only if the scenario has N-body bodies or belts)
+};
+
+/**
+ * @class Simulation
+ * @brief Advances one scenario in time and exposes the results as read-only views.
+ *
+ * step() moves the clock by a wall-clock interval at the current time warp; seek() jumps to an
+ * absolute time. Either way every analytic body is evaluated directly at the new time, the
+ * N-body state is integrated up to it (or restarted after a seek), and the world matrices are
+ * valid when the call returns. The object is not thread-safe: SimulationThread drives one from
+ * its own thread, benchmarks and tools call it directly.
+ */
+class Simulation
+{
+public:
+    /**
+     * @brief Compiles @p scenario and evaluates the state at settings.startTime.
+     * @param scenario Scenario to simulate (not referenced after construction).
+     * @param settings Worker, start time and N-body settings.
+     */
+    explicit Simulation(const Scenario &scenario, const SimulationSettings &settings = SimulationSettings());
+
+    Simulation(const Simulation &) = delete;            // No copying (the N-body system references the hierarchy)
+    Simulation &operator=(const Simulation &) = delete; // No copying
+
+    /**
+     * @brief Advances the clock by @p dt wall-clock seconds times the time warp and updates the state.
+     */
+    void step(double dt);
+
+    /**
+     * @brief Jumps to the absolute simulation time @p simSeconds and updates the state.
+     */
+    void seek(double simSeconds);
+
+    /** @brief Sets the time warp used by step() (see SimClock::setWarp). */
+    void setWarp(double warp) { clock.setWarp(warp); }
+
+    /** @brief Current time warp. */
+    double warp() const { return clock.warp(); }
+
+    /** @brief Current simulation time in seconds. */
+    double time() const { return clock.seconds(); }
+
+    /** @brief Current simulation time in clock ticks. */
+    SimClock::Ticks ticks() const { return clock.ticks(); }
+
+    /** @brief The compiled hierarchy (topology queries and the current world matrices). */
+    const TransformHierarchy &hierarchy() const { return transforms; }
+
+    /** @brief World matrix per hierarchy node at time(). */
+    const std::vector<glm::mat4> &worldMatrices() const { return transforms.worldMatrices(); }
+
+    /** @brief World position per hierarchy node at time(), in double precision. */
+    const std::vector<glm::dvec3> &worldPositions() const { return transforms.worldPositions(); }
+
+    /** @brief True if the scenario has N-body bodies or particles. */
+    bool hasNBody() const { return !nbodySystem.empty(); }
+
+    /** @brief N-body particle positions at time(), relative to particleOrigin() (empty without particle belts). */
+    const std::vector<glm::vec3> &particlePositions() const { return nbodySystem.particlePositions(); }
+
+    /** @brief World position the particlePositions() are relative to. */
+    const glm::dvec3 &particleOrigin() const { return nbodySystem.particleOrigin(); }
+
+    /** @brief Per-particle color and point size (fixed at construction). */
+    const std::vector<glm::vec4> &particleStyles() const { return nbodySystem.particleStyles(); }
+
+    /** @brief Cost and energy drift of the last N-body update. */
+    const NBodyStats &nbodyStats() const { return nbodySystem.stats(); }
+
+private:
+    ThreadPool pool;               // Workers for the hierarchy and N-body updates
+    TransformHierarchy transforms; // Compiled scenario
+    NBodySystem nbodySystem;       // Simulated bodies and particles (references transforms)
+    SimClock clock;                // Simulation time
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,82 @@
+/**
+ * @file spk_file.h
+ * @brief Defines the SpkFile class, a read-only, memory-mapped JPL SPK (.bsp) ephemeris file.
+ */
+
+#ifndef SPK_FILE_H
+#define SPK_FILE_H
+
+#include <cstddef> // For size_t
+#include <string>  // For the file path
+#include <vector>  // For the segment list
+
+/**
+ * @class SpkFile
+ * @brief Maps an SPK file into memory and indexes its Chebyshev segments (types 2 and 3).
+ *
+ * SPK files use NAIF's DAF container: a file record, a chain of summary records describing the
+ * segments, and the segment data as raw IEEE doubles. Only the summaries are read at open time;
+ * the coefficient records are used in place through the mapping, so opening a multi-gigabyte
+ * DE file is instant and only the pages that are actually evaluated are ever read from disk.
+ * Files must be in the machine's byte order (LTL-IEEE on x86/ARM); other segment types are
+ * skipped with a warning.
+ */
+class SpkFile
+{
+public:
+    /**
+     * @struct Segment
+     * @brief One segment: Chebyshev records for one target relative to one center over a time span.
+     * Times are TDB seconds past J2000 ("ephemeris time"), positions are km in frame @p frame.
+     */
+    struct Segment
+    {
+        int target = 0;                  // NAIF ID of the body the segment positions
+        int center = 0;                  // NAIF ID of the body it is relative to
+        int frame = 0;                   // Reference frame ID (1 = J2000)
+        int type = 0;                    // SPK data type (2 = position, 3 = position + velocity)
+        double startTime = 0.0;          // First covered time
+        double endTime = 0.0;            // Last covered time
+        const double *records = nullptr; // First record, inside the mapping
+        double initialTime = 0.0;        // Start of the first record's interval
+        double intervalLength = 0.0;     // Length of every record's interval (seconds)
+        size_t recordSize = 0;           // Doubles per record (midpoint, radius, coefficients)
+        size_t recordCount = 0;          // Number of records
+        size_t coefficientCount = 0;     // Chebyshev coefficients per coordinate (degree + 1)
+    };
+
+    /**
+     * @brief Maps @p path and reads its segment summaries. Problems are reported on std::cerr;
+     * check isOpen() afterwards.
+     */
+    explicit SpkFile(const std::string &path);
+
+    /**
+     * @brief Destructor that unmaps the file.
+     */
+    ~SpkFile();
+
+    SpkFile(const SpkFile &) = delete;            // No copying
+    SpkFile &operator=(const SpkFile &) = delete; // No copying
+
+    /** @brief True if the file was mapped and at least one usable segment was found. */
+    bool isOpen() const { return !segmentList.empty(); }
+
+    /** @brief Usable (type 2/3) segments, in file order. */
+    const std::vector<Segment> &segments() const { return segmentList; }
+
+private:
+    bool map(const std::string &path);
+    void unmap();
+    bool readSummaries(const std::string &path);
+
+    const unsigned char *data = nullptr; // Start of the mapping
+    size_t size = 0;                     // Length of the mapping in bytes
+#ifdef _WIN32
+    void *fileHandle = nullptr;    // HANDLE of the open file
+    void *mappingHandle = nullptr; // HANDLE of the file mapping
+#endif
+    std::vector<Segment> segmentList;
+};
+
+#endif // SPK_FILE_H
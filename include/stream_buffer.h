@@ -0,0 +1,128 @@
+/**
+ * @file stream_buffer.h
+ * @brief Defines the StreamBuffer class, the renderer's way of uploading data that changes
+ * every frame or tick: a triple-buffered ring of regions in one buffer object, written through
+ * a mapped pointer instead of glBufferData/glBufferSubData.
+ */
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h> // OpenGL types and GLADloadproc
+
+#include <cstddef> // For size_t
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+// glBufferStorage (GL 4.4 / GL_ARB_buffer_storage) is not part of the bundled GL 3.3 loader
+typedef void(APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+extern PFNGLBUFFERSTORAGEPROC solar_glBufferStorage;
+#define glBufferStorage solar_glBufferStorage
+
+/**
+ * @brief Loads glBufferStorage if the context is GL 4.4 or newer or has GL_ARB_buffer_storage.
+ * Call after gladLoadGLLoader() and before any StreamBuffer is allocated.
+ * @param load The loader passed to GLAD (e.g. glfwGetProcAddress).
+ * @return True if StreamBuffers will be persistently mapped.
+ */
+bool loadBufferStorage(GLADloadproc load);
+
+/**
+ * @struct StreamStats
+ * @brief Counters of every StreamBuffer since startup.
+ */
+struct StreamStats
+{
+    size_t writes = 0;    // Regions handed out by map()
+    size_t stalls = 0;    // map() calls that had to wait for the GPU to finish with a region
+    double stallMs = 0.0; // Time spent waiting in those calls
+};
+
+/**
+ * @class StreamBuffer
+ * @brief A buffer object split into REGIONS equal regions that are written in turn.
+ *
+ * Each map() hands out the next region; the caller fills it, calls unmap(), and points its
+ * draws at buffer() and offset(). The regions written before stay untouched until the ring
+ * comes round again, so the GPU can still read them while the CPU writes the next one.
+ *
+ * With glBufferStorage the whole buffer is mapped once, persistently and coherently, and map()
+ * just returns a pointer. Every region gets a fence when the next one is mapped (by then all
+ * draws reading it have been submitted); map() waits on the fence of the region it hands out,
+ * which only happens if the GPU is REGIONS uploads behind, and counts that as a stall. Without
+ * it (plain GL 3.3) each region is mapped unsynchronized, and the storage is orphaned whenever
+ * the ring wraps, so a region is never rewritten while the driver may still read it.
+ *
+ * The buffer is bound to GL_COPY_WRITE_BUFFER while it is allocated and mapped, so writing
+ * never disturbs the vertex array, uniform or indirect bindings.
+ */
+class StreamBuffer
+{
+public:
+    static constexpr unsigned int REGIONS = 3; // Triple buffering
+
+    StreamBuffer() = default;
+
+    /**
+     * @brief Destructor that unmaps and deletes the buffer and its fences.
+     */
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;            // No copying (owns GL objects)
+    StreamBuffer &operator=(const StreamBuffer &) = delete; // No copying
+
+    /**
+     * @brief (Re)creates the buffer with REGIONS regions of at least @p regionBytes bytes each,
+     * aligned for vertex, indirect and uniform buffer use. The buffer name may change.
+     */
+    void allocate(GLsizeiptr regionBytes);
+
+    /**
+     * @brief Hands out the next region for writing (regionSize() bytes).
+     * @return Pointer to the region, or nullptr if nothing is allocated or mapping failed.
+     */
+    void *map();
+
+    /**
+     * @brief Ends the write started by map(). Must be called before drawing from the region.
+     */
+    void unmap();
+
+    /** @brief The buffer object (0 until allocate()). */
+    GLuint buffer() const { return id; }
+
+    /** @brief Byte offset of the region handed out by the last map(). */
+    GLintptr offset() const { return static_cast<GLintptr>(current) * stride; }
+
+    /** @brief Usable bytes per region (as requested from allocate()). */
+    GLsizeiptr regionSize() const { return regionBytes; }
+
+    /** @brief True if the buffer is persistently mapped. */
+    bool persistent() const { return persistentBase != nullptr; }
+
+    /** @brief Counters of every StreamBuffer since startup. */
+    static const StreamStats &totals() { return stats; }
+
+private:
+    /**
+     * @brief Unmaps and deletes the buffer and fences.
+     */
+    void release();
+
+    GLuint id = 0;                      // Buffer object
+    GLsizeiptr regionBytes = 0;         // Requested bytes per region
+    GLsizeiptr stride = 0;              // Region size rounded up to the alignment
+    unsigned int current = REGIONS - 1; // Region handed out by the last map()
+    bool pending = false;               // The current region was written but has no fence yet
+    bool mapped = false;                // A region is mapped through glMapBufferRange (GL 3.3 path)
+    char *persistentBase = nullptr;     // Start of the persistent mapping (GL 4.4 path)
+    GLsync fences[REGIONS] = {};        // Per region: signaled once the GPU is done reading it
+    static StreamStats stats;           // Shared counters
+};
+
+#endif // STREAM_BUFFER_H
@@ -0,0 +1,75 @@
+/**
+ * @file thread_pool.h
+ * @brief Defines the ThreadPool class, a small fixed-size worker pool for data-parallel loops.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>             // For the shared chunk counter
+#include <condition_variable> // For waking/parking workers
+#include <cstddef>            // For size_t
+#include <functional>         // For std::function
+#include <mutex>              // For the job lock
+#include <thread>             // For std::thread
+#include <vector>             // For the worker list
+
+/**
+ * @class ThreadPool
+ * @brief Runs parallelFor() loops on a set of persistent worker threads.
+ *
+ * The calling thread takes part in every loop, so a pool with N threads uses N-1 workers.
+ * Work is split into fixed chunks claimed through an atomic counter; which thread runs a
+ * chunk varies between calls, but chunk boundaries do not, so loops whose iterations write
+ * disjoint outputs produce identical results every time.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount Total threads including the caller. 0 = std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    /**
+     * @brief Stops and joins all worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;            // No copying
+    ThreadPool &operator=(const ThreadPool &) = delete; // No copying
+
+    /**
+     * @brief Calls fn(chunkBegin, chunkEnd) for consecutive chunks covering [begin, end) and
+     * returns once all of them have finished. Ranges of at most @p grain items run inline.
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param grain Chunk size; chunk boundaries are begin + k * grain.
+     * @param fn Work function. Must be safe to call concurrently on disjoint chunks.
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn);
+
+    /** @brief Total number of threads that take part in a loop (workers + caller). */
+    unsigned int threadCount() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+
+    // --- Current job (guarded by mutex, except for the atomics) ---
+    std::mutex mutex;
+    std::condition_variable wakeCondition; // Signals a new job or shutdown
+    std::condition_variable doneCondition; // Signals that all chunks of the job finished
+    const std::function<void(size_t, size_t)> *jobFn = nullptr;
+    size_t jobBegin = 0, jobEnd = 0, jobGrain = 1, jobChunks = 0;
+    unsigned long long jobGeneration = 0; // Incremented per job so workers join each job once
+    std::atomic<size_t> nextChunk{0};     // Next chunk to claim
+    std::atomic<size_t> chunksDone{0};    // Chunks finished so far
+    unsigned int busyWorkers = 0;         // Workers currently inside runChunks()
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
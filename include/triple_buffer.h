@@ -0,0 +1,74 @@
+/**
+ * @file triple_buffer.h
+ * @brief Defines the TripleBuffer class template, a lock-free single-producer/single-consumer
+ * handoff of the latest value between two threads.
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic> // For the shared slot index
+
+/**
+ * @class TripleBuffer
+ * @brief Three slots: one owned by the writer, one by the reader, and one in the middle.
+ *
+ * The writer fills writeBuffer() and calls publish(), which atomically swaps its slot with the
+ * middle one and marks it fresh. The reader calls acquire(), which swaps its slot with the middle
+ * one if a fresh value is waiting. Neither side ever blocks or waits for the other, the reader
+ * always sees a complete value, and values the reader did not pick up in time are overwritten.
+ *
+ * @tparam T Slot type. Slots are reused, so large T (e.g. vectors) do not reallocate once sized.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Constructor: Initializes all three slots with copies of @p initial.
+     */
+    explicit TripleBuffer(const T &initial = T())
+        : slots{initial, initial, initial} {}
+
+    TripleBuffer(const TripleBuffer &) = delete;            // No copying (slots are owned by threads)
+    TripleBuffer &operator=(const TripleBuffer &) = delete; // No copying
+
+    // --- Writer side (one thread) ---
+
+    /** @brief The slot the writer may fill. Stays valid until the next publish(). */
+    T &writeBuffer() { return slots[backIndex]; }
+
+    /** @brief Hands the filled slot to the reader and takes back an unused one. */
+    void publish()
+    {
+        backIndex = middle.exchange(backIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // --- Reader side (one thread) ---
+
+    /**
+     * @brief Takes the most recently published value, if there is one the reader has not seen.
+     * @return true if readBuffer() now refers to a newer value.
+     */
+    bool acquire()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH_BIT))
+            return false;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /** @brief The reader's current value. Stays valid until the next acquire(). */
+    const T &readBuffer() const { return slots[frontIndex]; }
+
+private:
+    static constexpr unsigned int INDEX_MASK = 0x3; // Low bits hold the slot index
+    static constexpr unsigned int FRESH_BIT = 0x4;  // Set while the middle slot holds an unread value
+
+    T slots[3];
+    std::atomic<unsigned int> middle{1}; // Middle slot index (+ FRESH_BIT)
+    unsigned int backIndex = 0;          // Writer's slot
+    unsigned int frontIndex = 2;         // Reader's slot
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -1,13 +0,0 @@
-#version 330 core
-out vec4 FragColor;
-
-in vec2 TexCoord;
-
-uniform sampler2D ourTexture;
-
-void main()
-{
-    // The sun is emissive, so we just sample its texture
-    // and don't apply any lighting.
-    FragColor = texture(ourTexture, TexCoord);
-}
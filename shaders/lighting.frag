@@ -5,41 +5,62 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+flat in float Layer;   // Layer of the body texture array
+flat in uint Emissive; // The Sun: its texture is its color, unlit
+#ifdef LOG_DEPTH
+in float LogDepth; // 1 + clip-space w
+#endif
 
 // Uniforms
-uniform sampler2D ourTexture; // The planet's texture
-uniform vec3 lightPos;        // Light source position (Sun's position) in world space
-uniform vec3 viewPos;         // Camera position in world space
-uniform vec3 lightColor;      // Color of the light (usually white)
+uniform sampler2DArray ourTexture; // All body textures, one per layer
+layout (std140) uniform FrameData // Per-frame values, one buffer for every shader (see frame_data.h)
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;   // xyz = light source (Sun) position in world space
+    vec4 viewPos;    // xyz = camera position in world space
+    vec4 lightColor; // rgb = light color
+};
 
 void main()
 {
+#ifdef LOG_DEPTH
+    // Logarithmic depth: the same relative precision at every distance, with no far plane
+    gl_FragDepth = log2(LogDepth) * LOG_DEPTH_SCALE;
+#endif
+
+    // Get the object's base color from its texture
+    vec3 objectColor = texture(ourTexture, vec3(TexCoord, Layer)).rgb;
+    if (Emissive != 0u)
+    {
+        // The sun is emissive, so we just use its texture and don't apply any lighting
+        FragColor = vec4(objectColor, 1.0);
+        return;
+    }
+
     // --- Ambient Light ---
     // Provides a base level of light so dark areas aren't completely black.
     float ambientStrength = 0.1; // Low strength
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor.rgb;
 
     // --- Diffuse Light ---
     // Simulates directional light impact based on surface angle.
     vec3 norm = normalize(Normal); // Ensure normal vector is unit length
-    vec3 lightDir = normalize(lightPos - FragPos); // Direction from fragment to light
+    vec3 lightDir = normalize(lightPos.xyz - FragPos); // Direction from fragment to light
     float diff = max(dot(norm, lightDir), 0.0); // Intensity based on angle (cosine)
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor.rgb;
 
     // --- Specular Light ---
     // Simulates the bright highlight reflection of the light source.
     float specularStrength = 0.5; // Moderate strength
-    vec3 viewDir = normalize(viewPos - FragPos); // Direction from fragment to camera
+    vec3 viewDir = normalize(viewPos.xyz - FragPos); // Direction from fragment to camera
     vec3 reflectDir = reflect(-lightDir, norm); // Direction of reflected light
     // Use Blinn-Phong modification for slightly softer highlights
     vec3 halfwayDir = normalize(lightDir + viewDir);
     float spec = pow(max(dot(norm, halfwayDir), 0.0), 32.0); // Shininess factor of 32
     // Alternative: Standard Phong
     // float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0); // Shininess factor of 32
-    vec3 specular = specularStrength * spec * lightColor;
-
-    // Get the object's base color from its texture
-    vec3 objectColor = texture(ourTexture, TexCoord).rgb;
+    vec3 specular = specularStrength * spec * lightColor.rgb;
 
     // --- Final Color ---
     // Combine ambient, diffuse, and specular components, modulated by the object's color.
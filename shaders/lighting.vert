@@ -1,26 +1,51 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal; // Now we will use the normal
+layout (location = 1) in vec3 aNormal;   // Now we will use the normal
 layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in mat4 aModel;     // Per instance (locations 3-6), see BodyRenderer
+layout (location = 7) in uvec2 aMaterial; // Per instance: texture array layer, 1 if emissive
+#ifndef UNIFORM_SCALE
+layout (location = 8) in mat3 aNormalMatrix; // Per instance (locations 8-10): transpose(inverse(mat3(model)))
+#endif
 
-out vec3 FragPos;  // Fragment position in world space
-out vec3 Normal;   // Normal vector in world space
-out vec2 TexCoord; // Texture coordinate
+out vec3 FragPos;       // Fragment position in world space
+out vec3 Normal;        // Normal vector in world space
+out vec2 TexCoord;      // Texture coordinate
+flat out float Layer;   // Texture array layer
+flat out uint Emissive; // Unlit body (the Sun)
+#ifdef LOG_DEPTH
+out float LogDepth; // 1 + clip-space w, for the logarithmic depth (see depth_mode.h)
+#endif
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameData // Per-frame values, one buffer for every shader (see frame_data.h)
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;   // xyz = light source (Sun) position in world space
+    vec4 viewPos;    // xyz = camera position in world space
+    vec4 lightColor; // rgb = light color
+};
 
 void main()
 {
     // Calculate fragment position in world space
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
 
-    // Calculate the normal vector in world space
-    // Use the normal matrix (transpose(inverse(model))) to handle non-uniform scaling correctly
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Calculate the normal vector in world space (normalized per fragment)
+#ifdef UNIFORM_SCALE
+    // Rotation times one scale factor: the model matrix keeps normals perpendicular by itself
+    Normal = mat3(aModel) * aNormal;
+#else
+    // The normal matrix, computed once per body on the CPU, handles non-uniform scaling
+    Normal = aNormalMatrix * aNormal;
+#endif
 
     TexCoord = aTexCoord;
+    Layer = float(aMaterial.x);
+    Emissive = aMaterial.y;
 
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+#ifdef LOG_DEPTH
+    LogDepth = 1.0 + gl_Position.w;
+#endif
 }
@@ -0,0 +1,20 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 Color;
+#ifdef LOG_DEPTH
+in float LogDepth; // 1 + clip-space w
+#endif
+
+void main()
+{
+    // Round points: discard the corners of the point sprite
+    vec2 offset = gl_PointCoord - vec2(0.5);
+    if (dot(offset, offset) > 0.25)
+        discard;
+#ifdef LOG_DEPTH
+    // Logarithmic depth: the same relative precision at every distance, with no far plane
+    gl_FragDepth = log2(LogDepth) * LOG_DEPTH_SCALE;
+#endif
+    FragColor = vec4(Color, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+layout (location = 0) in vec3 aPrevious; // Position at the previous simulation tick, relative to its origin
+layout (location = 1) in vec3 aCurrent;  // Position at the current simulation tick, relative to its origin
+layout (location = 2) in vec4 aStyle;    // rgb = color, w = point size in pixels
+
+out vec3 Color;
+#ifdef LOG_DEPTH
+out float LogDepth; // 1 + clip-space w, for the logarithmic depth (see depth_mode.h)
+#endif
+
+layout (std140) uniform FrameData // Per-frame values, one buffer for every shader (see frame_data.h)
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;   // xyz = light source (Sun) position in world space
+    vec4 viewPos;    // xyz = camera position in world space
+    vec4 lightColor; // rgb = light color
+};
+uniform float alpha;          // Blend factor between the two ticks (SimSnapshot::blendFactor)
+uniform vec3 previousOrigin; // Previous tick's origin relative to the camera (ParticleRenderer::offsets)
+uniform vec3 currentOrigin;  // Current tick's origin relative to the camera
+
+void main()
+{
+    // Camera-relative, as the view matrix (see Camera::GetViewMatrix); the origins were
+    // subtracted from the eye in double, so only small offsets are added here
+    vec3 position = mix(aPrevious + previousOrigin, aCurrent + currentOrigin, alpha);
+    gl_Position = projection * view * vec4(position, 1.0);
+#ifdef LOG_DEPTH
+    LogDepth = 1.0 + gl_Position.w;
+#endif
+    gl_PointSize = aStyle.w;
+    Color = aStyle.rgb;
+}
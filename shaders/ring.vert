@@ -0,0 +1,82 @@
+#version 330 core
+// Ring particles without vertex data: everything is hashed from the particle index (see RingRenderer)
+
+out vec3 Color;
+#ifdef LOG_DEPTH
+out float LogDepth; // 1 + clip-space w, for the logarithmic depth (see depth_mode.h)
+#endif
+
+layout (std140) uniform FrameData // Per-frame values, one buffer for every shader (see frame_data.h)
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;   // xyz = light source (Sun) position in world space
+    vec4 viewPos;    // xyz = camera position in world space
+    vec4 lightColor; // rgb = light color
+};
+uniform vec3 center;       // Parent body's position relative to the camera
+uniform mat3 basis;        // Ring frame: in-plane X, normal, in-plane Z
+uniform float innerRadius;
+uniform float outerRadius;
+uniform float thickness;   // Full vertical extent
+uniform float rateSteps;   // Base-rate multiples at the outer edge (RingRenderer::RATE_STEPS)
+uniform uint basePhase;    // Base-rate phase at the current time, in 2^-32 revolutions
+uniform uint seed;
+uniform uint count;        // Number of particles (the last instance may be partial)
+uniform vec3 color;
+uniform float pointSize;
+
+const uint BATCH = 64u;                         // RingRenderer::BATCH
+const float TWO_PI_OVER_2_32 = 1.4629180793e-9; // 2*pi / 2^32
+
+// Integer hash with good avalanche (lowbias32)
+uint hash(uint x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Uniform float in [0, 1) from a hash
+float unit(uint h)
+{
+    return float(h >> 8) * (1.0 / 16777216.0);
+}
+
+void main()
+{
+    uint id = uint(gl_InstanceID) * BATCH + uint(gl_VertexID);
+    if (id >= count)
+    {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0); // Beyond the far plane: clipped
+        gl_PointSize = 1.0;
+        Color = vec3(0.0);
+#ifdef LOG_DEPTH
+        LogDepth = 1.0;
+#endif
+        return;
+    }
+
+    uint h0 = hash(id ^ hash(seed));
+    uint h1 = hash(h0);
+    uint h2 = hash(h1);
+    uint h3 = hash(h2);
+
+    // Radius uniform over the ring's area; speed is an integer number of base rates, so the
+    // phase below is exact modulo one revolution at any time
+    float r = sqrt(mix(innerRadius * innerRadius, outerRadius * outerRadius, unit(h1)));
+    uint multiple = uint(rateSteps * pow(outerRadius / r, 1.5) + 0.5);
+    uint phase = h0 + multiple * basePhase; // Wraps once per revolution
+    float angle = float(int(phase)) * TWO_PI_OVER_2_32;
+
+    vec3 local = vec3(r * cos(angle), (unit(h2) - 0.5) * thickness, -r * sin(angle)); // Prograde, as every orbit (scene_frame.h)
+    gl_Position = projection * view * vec4(center + basis * local, 1.0);
+#ifdef LOG_DEPTH
+    LogDepth = 1.0 + gl_Position.w;
+#endif
+    gl_PointSize = pointSize;
+    Color = color * (0.7 + 0.3 * unit(h3));
+}
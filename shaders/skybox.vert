@@ -3,16 +3,27 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view; // We remove the translation part
+layout (std140) uniform FrameData // Per-frame values, one buffer for every shader (see frame_data.h)
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;   // xyz = light source (Sun) position in world space
+    vec4 viewPos;    // xyz = camera position in world space
+    vec4 lightColor; // rgb = light color
+};
 
 void main()
 {
     // Remove translation from the view matrix so the skybox follows the camera
     mat4 viewNoTranslation = mat4(mat3(view));
     vec4 pos = projection * viewNoTranslation * vec4(aPos, 1.0);
+#ifdef REVERSE_Z
+    // Reverse-Z: the far end is depth 0, so z = 0
+    gl_Position = vec4(pos.xy, 0.0, pos.w);
+#else
     // Force depth to be 1.0 (furthest possible) by setting z = w
     gl_Position = pos.xyww;
+#endif
     // Pass vertex position directly as texture coordinate for cubemap sampling
     TexCoords = aPos;
 }
@@ -0,0 +1,466 @@
+/**
+ * @file barnes_hut.cpp
+ * @brief Implements the BarnesHutTree: Morton coding, parallel radix sort, linear octree
+ * construction and the tree walk that evaluates accelerations.
+ */
+
+#include "barnes_hut.h"
+#include "thread_pool.h" // For ThreadPool::parallelFor
+#include "simd_math.h"   // For the vectorized interaction loop
+
+#include <algorithm>  // For std::min, std::max, std::clamp, std::partition_point, std::lower_bound, std::none_of
+#include <cfloat>     // For FLT_MAX
+#include <cmath>      // For std::sqrt
+#include <functional> // For std::function
+
+// Items per parallel chunk for the per-particle passes
+static const size_t PARTICLE_GRAIN = 16384;
+// Leaves per chunk of the tree walk (small: the cost per leaf varies with local density)
+static const size_t LEAF_GRAIN = 32;
+// Below this many particles the top levels are not worth splitting across threads
+static const size_t PARALLEL_BUILD_MIN = 65536;
+// Radix sort: 4 passes of 12 bits cover the 48-bit Morton codes
+static const int RADIX_BITS = 12;
+static const int RADIX_PASSES = 4;
+
+/**
+ * @brief Runs fn over [begin, end) on the pool if there is one, otherwise inline in the same
+ * chunks (so per-chunk results do not depend on whether a pool is used).
+ */
+static void forRange(ThreadPool *pool, size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn)
+{
+    if (pool)
+    {
+        pool->parallelFor(begin, end, grain, fn);
+        return;
+    }
+    for (size_t first = begin; first < end; first += grain)
+        fn(first, std::min(first + grain, end));
+}
+
+/**
+ * @brief Spreads the low 16 bits of @p v so that bit k moves to bit 3k.
+ */
+static std::uint64_t spreadBits(std::uint64_t v)
+{
+    v &= 0xFFFF;
+    v = (v | v << 16) & 0x0000FF0000FFULL;
+    v = (v | v << 8) & 0x00F00F00F00FULL;
+    v = (v | v << 4) & 0x0C30C30C30C3ULL;
+    v = (v | v << 2) & 0x249249249249ULL;
+    return v;
+}
+
+/**
+ * @brief Inverse of spreadBits(): gathers every third bit back into the low 16 bits.
+ */
+static std::uint64_t compactBits(std::uint64_t v)
+{
+    v &= 0x249249249249ULL;
+    v = (v | v >> 2) & 0x0C30C30C30C3ULL;
+    v = (v | v >> 4) & 0x00F00F00F00FULL;
+    v = (v | v >> 8) & 0x0000FF0000FFULL;
+    v = (v | v >> 16) & 0xFFFF;
+    return v;
+}
+
+/**
+ * @brief Constructor: Stores the accuracy parameters.
+ */
+BarnesHutTree::BarnesHutTree(double theta, double softening, size_t leafSize)
+    : theta(std::clamp(theta, 0.0, 1.0)), // Above 1 a cell could be approximated for a particle inside it
+      softening2(softening * softening), leafSize(std::max<size_t>(leafSize, 1))
+{
+}
+
+/**
+ * @brief Bounding cube -> Morton codes -> sort -> sorted copies -> octree.
+ */
+void BarnesHutTree::build(const double *x, const double *y, const double *z, const double *mass, size_t count, ThreadPool *pool)
+{
+    nodes.clear();
+    codes.resize(count);
+    order.resize(count);
+    if (count == 0)
+        return;
+
+    // --- Bounding box (per-chunk min/max, then reduced in chunk order) ---
+    const size_t chunks = (count + PARTICLE_GRAIN - 1) / PARTICLE_GRAIN;
+    std::vector<double> bounds(chunks * 6);
+    forRange(pool, 0, count, PARTICLE_GRAIN, [&](size_t first, size_t last)
+             {
+                 double *b = &bounds[first / PARTICLE_GRAIN * 6];
+                 b[0] = b[3] = x[first];
+                 b[1] = b[4] = y[first];
+                 b[2] = b[5] = z[first];
+                 for (size_t i = first + 1; i < last; ++i)
+                 {
+                     b[0] = std::min(b[0], x[i]);
+                     b[1] = std::min(b[1], y[i]);
+                     b[2] = std::min(b[2], z[i]);
+                     b[3] = std::max(b[3], x[i]);
+                     b[4] = std::max(b[4], y[i]);
+                     b[5] = std::max(b[5], z[i]);
+                 } });
+    double lo[3] = {bounds[0], bounds[1], bounds[2]}, hi[3] = {bounds[3], bounds[4], bounds[5]};
+    for (size_t c = 1; c < chunks; ++c)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            lo[a] = std::min(lo[a], bounds[c * 6 + a]);
+            hi[a] = std::max(hi[a], bounds[c * 6 + 3 + a]);
+        }
+    }
+    cubeSize = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    cubeSize = cubeSize > 0.0 ? cubeSize * (1.0 + 1e-6) : 1.0; // Keep the maximum inside the last cell
+    originX = lo[0];
+    originY = lo[1];
+    originZ = lo[2];
+
+    // --- Morton codes ---
+    const double toCell = 65536.0 / cubeSize;
+    forRange(pool, 0, count, PARTICLE_GRAIN, [&](size_t first, size_t last)
+             {
+                 for (size_t i = first; i < last; ++i)
+                 {
+                     auto quantize = [&](double v, double origin)
+                     { return static_cast<std::uint64_t>(std::clamp((v - origin) * toCell, 0.0, 65535.0)); };
+                     codes[i] = spreadBits(quantize(x[i], originX)) << 2 |
+                                spreadBits(quantize(y[i], originY)) << 1 |
+                                spreadBits(quantize(z[i], originZ));
+                     order[i] = static_cast<std::uint32_t>(i);
+                 } });
+
+    sortByMortonCode(pool);
+
+    // --- Sorted single-precision copies (contiguous for the tree walk) ---
+    px.resize(count);
+    py.resize(count);
+    pz.resize(count);
+    pm.resize(count);
+    forRange(pool, 0, count, PARTICLE_GRAIN, [&](size_t first, size_t last)
+             {
+                 for (size_t i = first; i < last; ++i)
+                 {
+                     std::uint32_t src = order[i];
+                     px[i] = static_cast<float>(x[src]);
+                     py[i] = static_cast<float>(y[src]);
+                     pz[i] = static_cast<float>(z[src]);
+                     pm[i] = static_cast<float>(mass[src]);
+                 } });
+
+    // --- Octree: subtrees below SPLIT_LEVEL in parallel, then the top levels around them ---
+    if (!pool || count < PARALLEL_BUILD_MIN)
+    {
+        buildNode(nodes, 0, count, 0, nullptr);
+    }
+    else
+    {
+        buildTopLevels(pool);
+    }
+
+    // Leaves are the work items of the tree walk
+    leaves.clear();
+    for (size_t k = 0; k < nodes.size(); ++k)
+    {
+        if (nodes[k].subtreeSize == 1)
+            leaves.push_back(static_cast<std::uint32_t>(k));
+    }
+}
+
+/**
+ * @brief Splits the sorted particles into the (up to 64) cells at SPLIT_LEVEL, builds those
+ * subtrees in parallel, then builds the levels above them sequentially, splicing them in.
+ */
+void BarnesHutTree::buildTopLevels(ThreadPool *pool)
+{
+    const size_t count = codes.size();
+    Prebuilt prebuilt;
+    const int shift = 3 * (MAX_LEVEL - SPLIT_LEVEL);
+    for (size_t begin = 0; begin < count;)
+    {
+        std::uint64_t prefix = codes[begin] >> shift;
+        size_t end = std::partition_point(codes.begin() + begin, codes.end(), [&](std::uint64_t c)
+                                          { return (c >> shift) == prefix; }) -
+                     codes.begin();
+        prebuilt.begins.push_back(begin);
+        begin = end;
+    }
+    prebuilt.subtrees.resize(prebuilt.begins.size());
+    pool->parallelFor(0, prebuilt.begins.size(), 1, [&](size_t first, size_t last)
+                      {
+                          for (size_t k = first; k < last; ++k)
+                          {
+                              size_t end = k + 1 < prebuilt.begins.size() ? prebuilt.begins[k + 1] : count;
+                              buildNode(prebuilt.subtrees[k], prebuilt.begins[k], end, SPLIT_LEVEL, nullptr);
+                          } });
+    buildNode(nodes, 0, count, 0, &prebuilt);
+}
+
+/**
+ * @brief Stable LSD radix sort of (code, index) pairs. Each pass counts digits per chunk in
+ * parallel, turns the counts into per-chunk output offsets (in chunk order, which keeps the
+ * sort stable), and scatters in parallel.
+ */
+void BarnesHutTree::sortByMortonCode(ThreadPool *pool)
+{
+    const size_t count = codes.size();
+    const size_t buckets = size_t(1) << RADIX_BITS;
+    const size_t chunks = (count + PARTICLE_GRAIN - 1) / PARTICLE_GRAIN;
+    std::vector<size_t> offsets(chunks * buckets);
+    codeScratch.resize(count);
+    orderScratch.resize(count);
+
+    for (int pass = 0; pass < RADIX_PASSES; ++pass)
+    {
+        const int shift = pass * RADIX_BITS;
+        std::fill(offsets.begin(), offsets.end(), 0);
+        forRange(pool, 0, count, PARTICLE_GRAIN, [&](size_t first, size_t last)
+                 {
+                     size_t *histogram = &offsets[first / PARTICLE_GRAIN * buckets];
+                     for (size_t i = first; i < last; ++i)
+                         ++histogram[(codes[i] >> shift) & (buckets - 1)];
+                 });
+
+        // Exclusive prefix sum, digit-major then chunk-major
+        size_t running = 0;
+        for (size_t digit = 0; digit < buckets; ++digit)
+        {
+            for (size_t c = 0; c < chunks; ++c)
+            {
+                size_t n = offsets[c * buckets + digit];
+                offsets[c * buckets + digit] = running;
+                running += n;
+            }
+        }
+
+        forRange(pool, 0, count, PARTICLE_GRAIN, [&](size_t first, size_t last)
+                 {
+                     size_t *next = &offsets[first / PARTICLE_GRAIN * buckets];
+                     for (size_t i = first; i < last; ++i)
+                     {
+                         size_t dst = next[(codes[i] >> shift) & (buckets - 1)]++;
+                         codeScratch[dst] = codes[i];
+                         orderScratch[dst] = order[i];
+                     } });
+        codes.swap(codeScratch);
+        order.swap(orderScratch);
+    }
+}
+
+/**
+ * @brief Appends the subtree for sorted particles [begin, end) at depth @p level in pre-order,
+ * then fills in its mass moments. Children are found by binary search on the next 3 code bits.
+ * At SPLIT_LEVEL, a prebuilt subtree (if given) is spliced in instead of being built again.
+ */
+void BarnesHutTree::buildNode(std::vector<Node> &out, size_t begin, size_t end, int level, const Prebuilt *prebuilt) const
+{
+    if (prebuilt && level == SPLIT_LEVEL)
+    {
+        size_t k = std::lower_bound(prebuilt->begins.begin(), prebuilt->begins.end(), begin) - prebuilt->begins.begin();
+        const std::vector<Node> &subtree = prebuilt->subtrees[k];
+        out.insert(out.end(), subtree.begin(), subtree.end()); // Subtree sizes are relative, so no fix-up
+        return;
+    }
+
+    const size_t index = out.size();
+    out.push_back(Node{});
+    double mass = 0.0, mx = 0.0, my = 0.0, mz = 0.0;
+
+    if (end - begin <= leafSize || level == MAX_LEVEL)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            mass += pm[i];
+            mx += static_cast<double>(pm[i]) * px[i];
+            my += static_cast<double>(pm[i]) * py[i];
+            mz += static_cast<double>(pm[i]) * pz[i];
+        }
+    }
+    else
+    {
+        const int shift = 3 * (MAX_LEVEL - 1 - level);
+        for (size_t childBegin = begin; childBegin < end;)
+        {
+            std::uint64_t digit = (codes[childBegin] >> shift) & 7;
+            size_t childEnd = std::partition_point(codes.begin() + childBegin, codes.begin() + end, [&](std::uint64_t c)
+                                                   { return ((c >> shift) & 7) == digit; }) -
+                              codes.begin();
+            buildNode(out, childBegin, childEnd, level + 1, prebuilt);
+            childBegin = childEnd;
+        }
+        for (size_t child = index + 1; child < out.size(); child += out[child].subtreeSize)
+        {
+            const Node &c = out[child];
+            mass += c.mass;
+            mx += static_cast<double>(c.mass) * c.comX;
+            my += static_cast<double>(c.mass) * c.comY;
+            mz += static_cast<double>(c.mass) * c.comZ;
+        }
+    }
+
+    // Cell geometry from the shared code prefix
+    const double cellSize = cubeSize / static_cast<double>(1u << level);
+    const std::uint64_t cell = codes[begin] >> (3 * (MAX_LEVEL - level));
+    const double centerX = originX + (static_cast<double>(compactBits(cell >> 2)) + 0.5) * cellSize;
+    const double centerY = originY + (static_cast<double>(compactBits(cell >> 1)) + 0.5) * cellSize;
+    const double centerZ = originZ + (static_cast<double>(compactBits(cell)) + 0.5) * cellSize;
+
+    Node &node = out[index];
+    if (mass > 0.0)
+    {
+        node.comX = static_cast<float>(mx / mass);
+        node.comY = static_cast<float>(my / mass);
+        node.comZ = static_cast<float>(mz / mass);
+    }
+    else
+    {
+        node.comX = static_cast<float>(centerX); // Massless cell: any point works
+        node.comY = static_cast<float>(centerY);
+        node.comZ = static_cast<float>(centerZ);
+    }
+    node.mass = static_cast<float>(mass);
+    if (theta > 0.0)
+    {
+        double dx = node.comX - centerX, dy = node.comY - centerY, dz = node.comZ - centerZ;
+        double openRadius = cellSize / theta + std::sqrt(dx * dx + dy * dy + dz * dz);
+        node.openRadius2 = static_cast<float>(std::min(openRadius * openRadius, static_cast<double>(FLT_MAX)));
+    }
+    else
+    {
+        node.openRadius2 = FLT_MAX; // Never approximate
+    }
+    node.subtreeSize = static_cast<std::uint32_t>(out.size() - index);
+    node.begin = static_cast<std::uint32_t>(begin);
+    node.count = static_cast<std::uint32_t>(end - begin);
+}
+
+/**
+ * @brief Grouped tree walk: one stackless walk per leaf collects every node (as a point mass) or
+ * particle the leaf's particles interact with, using the distance from the node's centre of mass
+ * to the leaf's bounding box, so the list is valid for all of them. The list is then evaluated
+ * for each particle of the leaf with SIMD over list entries. Leaves are contiguous in Morton
+ * order, so consecutive leaves (and each thread's chunk) walk nearly the same nodes.
+ * Leaves without an active particle are not walked at all.
+ */
+void BarnesHutTree::accelerations(double *ax, double *ay, double *az, ThreadPool *pool,
+                                  const std::uint8_t *active, double *potential) const
+{
+    using namespace simd;
+    constexpr size_t W = Simd::width;
+    const size_t nodeTotal = nodes.size();
+    const Simd eps2 = set1(static_cast<float>(softening2));
+    const Simd zero = set1(0.0f);
+
+    forRange(pool, 0, leaves.size(), LEAF_GRAIN, [&](size_t first, size_t last)
+             {
+                 std::vector<float> lx, ly, lz, lm; // Interaction list of the current leaf (SoA)
+                 alignas(32) float sums[4][W];
+                 for (size_t l = first; l < last; ++l)
+                 {
+                     const Node &leaf = nodes[leaves[l]];
+                     const size_t begin = leaf.begin, end = leaf.begin + leaf.count;
+                     if (active && std::none_of(order.begin() + begin, order.begin() + end, [&](std::uint32_t p)
+                                                { return active[p] != 0; }))
+                         continue; // No particle of this leaf needs a force
+
+                     // Bounding box of the leaf's particles
+                     float lo[3] = {px[begin], py[begin], pz[begin]}, hi[3] = {lo[0], lo[1], lo[2]};
+                     for (size_t i = begin + 1; i < end; ++i)
+                     {
+                         lo[0] = std::min(lo[0], px[i]);
+                         lo[1] = std::min(lo[1], py[i]);
+                         lo[2] = std::min(lo[2], pz[i]);
+                         hi[0] = std::max(hi[0], px[i]);
+                         hi[1] = std::max(hi[1], py[i]);
+                         hi[2] = std::max(hi[2], pz[i]);
+                     }
+
+                     // --- Walk: build the interaction list ---
+                     lx.clear();
+                     ly.clear();
+                     lz.clear();
+                     lm.clear();
+                     size_t k = 0;
+                     while (k < nodeTotal)
+                     {
+                         const Node &node = nodes[k];
+                         float dx = std::max({lo[0] - node.comX, 0.0f, node.comX - hi[0]});
+                         float dy = std::max({lo[1] - node.comY, 0.0f, node.comY - hi[1]});
+                         float dz = std::max({lo[2] - node.comZ, 0.0f, node.comZ - hi[2]});
+                         if (dx * dx + dy * dy + dz * dz > node.openRadius2)
+                         {
+                             // Far from every particle of the leaf: the subtree acts as one point mass
+                             lx.push_back(node.comX);
+                             ly.push_back(node.comY);
+                             lz.push_back(node.comZ);
+                             lm.push_back(node.mass);
+                             k += node.subtreeSize;
+                         }
+                         else if (node.subtreeSize == 1)
+                         {
+                             // Nearby leaf (possibly this one): interact with its particles directly
+                             lx.insert(lx.end(), px.begin() + node.begin, px.begin() + node.begin + node.count);
+                             ly.insert(ly.end(), py.begin() + node.begin, py.begin() + node.begin + node.count);
+                             lz.insert(lz.end(), pz.begin() + node.begin, pz.begin() + node.begin + node.count);
+                             lm.insert(lm.end(), pm.begin() + node.begin, pm.begin() + node.begin + node.count);
+                             ++k;
+                         }
+                         else
+                         {
+                             ++k; // Open the node: its first child follows it
+                         }
+                     }
+                     while (lx.size() % W != 0)
+                     {
+                         lx.push_back(0.0f); // Massless padding
+                         ly.push_back(0.0f);
+                         lz.push_back(0.0f);
+                         lm.push_back(0.0f);
+                     }
+
+                     // --- Evaluate the list for every particle of the leaf ---
+                     for (size_t i = begin; i < end; ++i)
+                     {
+                         const std::uint32_t dst = order[i];
+                         if (active && !active[dst])
+                             continue;
+                         const Simd xi = set1(px[i]), yi = set1(py[i]), zi = set1(pz[i]);
+                         Simd sumX = zero, sumY = zero, sumZ = zero, sumP = zero;
+                         for (size_t j = 0; j < lx.size(); j += W)
+                         {
+                             Simd dx = load(&lx[j]) - xi;
+                             Simd dy = load(&ly[j]) - yi;
+                             Simd dz = load(&lz[j]) - zi;
+                             Simd r2 = fmadd(dx, dx, fmadd(dy, dy, fmadd(dz, dz, eps2)));
+                             Simd inv = rsqrt(r2);
+                             Simd m = select(cmplt(zero, r2), load(&lm[j]), zero); // The particle itself (r2 = 0 when unsoftened)
+                             Simd mInv = m * inv;
+                             Simd f = mInv * (inv * inv);
+                             sumX = fmadd(f, dx, sumX);
+                             sumY = fmadd(f, dy, sumY);
+                             sumZ = fmadd(f, dz, sumZ);
+                             sumP = sumP + mInv;
+                         }
+                         store(sums[0], sumX);
+                         store(sums[1], sumY);
+                         store(sums[2], sumZ);
+                         store(sums[3], sumP);
+                         double total[4] = {0.0, 0.0, 0.0, 0.0};
+                         for (int a = 0; a < 4; ++a)
+                         {
+                             for (size_t lane = 0; lane < W; ++lane)
+                                 total[a] += sums[a][lane];
+                         }
+                         ax[dst] = total[0];
+                         ay[dst] = total[1];
+                         az[dst] = total[2];
+                         if (potential)
+                         {
+                             // With softening the particle's own term is -m/eps instead of zero; remove it
+                             const double self = softening2 > 0.0 ? pm[i] / std::sqrt(softening2) : 0.0;
+                             potential[dst] = -(total[3] - self);
+                         }
+                     }
+                 } });
+}
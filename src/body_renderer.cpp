@@ -0,0 +1,347 @@
+/**
+ * @file body_renderer.cpp
+ * @brief Implements the BodyRenderer class: culling, level selection, front-to-back ordering,
+ * uploads and the indirect and instanced draw paths.
+ */
+
+#include "body_renderer.h"
+#include "gl_indirect.h"  // For the indirect command layout and glMultiDrawElementsIndirect
+#include "render_queue.h" // For submitting the draws
+
+#include <algorithm> // For std::stable_sort, std::count_if, std::equal, std::min, std::max
+#include <cmath>     // For std::cos
+#include <cstddef>   // For offsetof
+#include <cstring>   // For std::memcpy
+
+/**
+ * @brief Constructor: Builds the spheres, derives each level's error and enables the per-instance
+ * attributes on the spheres' VAO (their pointers follow the instance regions, see drawGroups()).
+ */
+BodyRenderer::BodyRenderer(const std::vector<unsigned int> &lodDetails, bool indirect, float pixelError)
+    : spheres(1.0f, lodDetails), indirect(indirect), pixelError(pixelError), groups(lodDetails.size())
+{
+    // A UV sphere of detail d has d - 1 segments around the equator; the middle of each chord
+    // lies 1 - cos(half the segment angle) inside the unit sphere
+    for (unsigned int detail : lodDetails)
+    {
+        chordError.push_back(1.0f - std::cos(glm::pi<float>() / static_cast<float>(detail - 1)));
+    }
+
+    glBindVertexArray(spheres.vertexArray());
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        glEnableVertexAttribArray(MODEL_ATTRIBUTE + column);
+        glVertexAttribDivisor(MODEL_ATTRIBUTE + column, 1); // Advance once per instance, not per vertex
+    }
+    glEnableVertexAttribArray(MATERIAL_ATTRIBUTE);
+    glVertexAttribDivisor(MATERIAL_ATTRIBUTE, 1);
+    for (GLuint column = 0; column < 3; ++column)
+    {
+        glEnableVertexAttribArray(NORMAL_ATTRIBUTE + column);
+        glVertexAttribDivisor(NORMAL_ATTRIBUTE + column, 1);
+    }
+    glBindVertexArray(0); // Unbind VAO to prevent accidental changes
+}
+
+/**
+ * @brief Destructor: The stream buffers clean up after themselves.
+ */
+BodyRenderer::~BodyRenderer() = default;
+
+/**
+ * @brief Model matrix as four vec4 columns; material as an integer pair, so the shader gets the
+ * exact layer; normal matrix as three vec3 columns.
+ */
+void BodyRenderer::pointInstanceAttributes(size_t first) const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instances.buffer());
+    const size_t base = static_cast<size_t>(instances.offset()) + first * sizeof(InstanceData);
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        const size_t offset = base + offsetof(InstanceData, model) + column * sizeof(glm::vec4);
+        glVertexAttribPointer(MODEL_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)offset);
+    }
+    glVertexAttribIPointer(MATERIAL_ATTRIBUTE, 2, GL_UNSIGNED_INT, sizeof(InstanceData), (void *)(base + offsetof(InstanceData, material)));
+    for (GLuint column = 0; column < 3; ++column)
+    {
+        const size_t offset = base + offsetof(InstanceData, normalMatrix) + column * sizeof(glm::vec3);
+        glVertexAttribPointer(NORMAL_ATTRIBUTE + column, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)offset);
+    }
+}
+
+/**
+ * @brief Stores the instances and sizes the instance regions and, on the indirect path, the
+ * command regions (one command per level, rewritten as the levels' counts change).
+ */
+void BodyRenderer::setInstances(const std::vector<BodyInstance> &bodies)
+{
+    instanceNodes.clear();
+    materials.clear();
+    for (const BodyInstance &body : bodies)
+    {
+        instanceNodes.push_back(body.node);
+        materials.push_back(glm::uvec2(body.layer, body.emissive ? 1u : 0u));
+    }
+    models.assign(bodies.size(), glm::mat4(1.0f));
+    positions.assign(bodies.size(), glm::dvec3(0.0));
+    radii.assign(bodies.size(), 0.0f);
+    normalMatrices.assign(bodies.size(), glm::mat3(1.0f));
+    allUniform = true;
+    levels.assign(bodies.size(), 0u);
+    bounds.resize(bodies.size());
+    order.clear();
+    distances.assign(bodies.size(), 0.0f);
+    for (Group &group : groups)
+        group = Group();
+    transformsDirty = true;
+
+    if (!bodies.empty())
+        instances.allocate(bodies.size() * sizeof(InstanceData));
+    if (indirect)
+    {
+        commands.allocate(groups.size() * sizeof(DrawElementsIndirectCommand));
+        uploadCommands();
+    }
+}
+
+/**
+ * @brief Gathers the model matrices, positions and bounding radii (the unit sphere's radius
+ * scaled by the longest model column); the upload waits for prepareFrame(). A matrix scales uniformly if its
+ * three column lengths agree to a relative 1e-4; only if one does not are the normal matrices
+ * computed, one inverse per body instead of one per vertex.
+ */
+void BodyRenderer::updateTransforms(const std::vector<glm::mat4> &worlds, const std::vector<glm::dvec3> &worldPositions)
+{
+    allUniform = true;
+    for (size_t i = 0; i < instanceNodes.size(); ++i)
+    {
+        models[i] = worlds[instanceNodes[i]];
+        positions[i] = worldPositions[instanceNodes[i]];
+        const float sx = glm::length(glm::vec3(models[i][0]));
+        const float sy = glm::length(glm::vec3(models[i][1]));
+        const float sz = glm::length(glm::vec3(models[i][2]));
+        const float largest = std::max(sx, std::max(sy, sz));
+        allUniform = allUniform && largest - std::min(sx, std::min(sy, sz)) <= 1e-4f * largest;
+        radii[i] = largest;
+    }
+    if (!allUniform)
+    {
+        for (size_t i = 0; i < instanceNodes.size(); ++i)
+            normalMatrices[i] = glm::transpose(glm::inverse(glm::mat3(models[i])));
+    }
+    transformsDirty = true;
+}
+
+/**
+ * @brief Levels are ordered coarsest first. Refining happens at once; coarsening only to a
+ * level whose error is below LOD_HYSTERESIS times the limit, which leaves a band of sizes in
+ * which either level is kept.
+ */
+unsigned int BodyRenderer::selectLevel(unsigned int current, float pixelRadius) const
+{
+    const unsigned int finest = static_cast<unsigned int>(chordError.size() - 1);
+    unsigned int target = finest;
+    for (unsigned int level = 0; level < finest; ++level)
+    {
+        if (chordError[level] * pixelRadius <= pixelError)
+        {
+            target = level;
+            break;
+        }
+    }
+    if (target >= current)
+        return target;
+    for (unsigned int level = target; level < current; ++level)
+    {
+        if (chordError[level] * pixelRadius <= pixelError * LOD_HYSTERESIS)
+            return level;
+    }
+    return current;
+}
+
+/**
+ * @brief Moves the bounding spheres to the eye (the double-precision subtraction is what keeps
+ * far-away bodies steady), culls with the SIMD kernel, picks each visible instance's level from its projected
+ * radius, then counting-sorts the visible instances by level and sorts each level by the
+ * distance to the surface (center distance minus the radius), so a large nearby body precedes
+ * the small moon behind it. The instances are written into the next region only if something
+ * changed; otherwise the draws keep reading the last one. The indirect commands follow the
+ * groups, not the order: a body can change level while every slot keeps its instance (zooming
+ * in on a single body, or all bodies crossing a threshold together).
+ */
+void BodyRenderer::prepareFrame(const Frustum &frustum, const glm::dvec3 &eye, float pixelScale)
+{
+    if (instanceNodes.empty())
+        return;
+    for (size_t i = 0; i < instanceNodes.size(); ++i)
+        bounds.set(i, glm::vec3(positions[i] - eye), radii[i]);
+    cullSphereBatch(frustum, bounds, visible);
+
+    previousGroups.swap(groups);
+    groups.assign(previousGroups.size(), Group());
+    for (unsigned int i : visible)
+    {
+        const glm::vec3 center(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]);
+        const float radius = bounds.radius[i];
+        const float centerDistance = glm::length(center); // The eye is at the origin
+        distances[i] = std::max(centerDistance - radius, 0.0f);
+        levels[i] = selectLevel(levels[i], radius * pixelScale / std::max(centerDistance, radius));
+        ++groups[levels[i]].visible;
+    }
+    size_t slot = 0;
+    for (Group &group : groups)
+    {
+        group.slot = slot;
+        slot += group.visible;
+    }
+
+    previousOrder.swap(order);
+    order.resize(visible.size());
+    nextSlots.resize(groups.size());
+    for (size_t level = 0; level < groups.size(); ++level)
+        nextSlots[level] = groups[level].slot;
+    for (unsigned int i : visible)
+        order[nextSlots[levels[i]]++] = i;
+    for (Group &group : groups)
+    {
+        if (group.visible == 0)
+            continue;
+        const auto begin = order.begin() + group.slot, end = begin + group.visible;
+        std::stable_sort(begin, end, [&](size_t a, size_t b)
+                         { return distances[a] < distances[b]; }); // Stable: equal distances keep their slots
+        group.nearest = distances[*begin];
+    }
+    const bool regrouped = !std::equal(groups.begin(), groups.end(), previousGroups.begin(), [](const Group &a, const Group &b)
+                                       { return a.slot == b.slot && a.visible == b.visible; });
+    if (indirect && regrouped)
+        uploadCommands();
+    const bool reordered = order != previousOrder;
+    if (!reordered && !transformsDirty && eye == lastEye)
+        return;
+
+    InstanceData *region = static_cast<InstanceData *>(instances.map());
+    if (!region)
+        return;
+    for (size_t s = 0; s < order.size(); ++s)
+    {
+        const size_t i = order[s];
+        InstanceData data = {models[i], materials[i], allUniform ? glm::mat3(1.0f) : normalMatrices[i]};
+        data.model[3] = glm::vec4(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i], 1.0f);
+        std::memcpy(region + s, &data, sizeof(InstanceData)); // Write-only: the mapping may be uncached
+    }
+    instances.unmap();
+    transformsDirty = false;
+    lastEye = eye;
+}
+
+/**
+ * @brief One command per level, empty levels included (an instance count of zero draws nothing).
+ */
+void BodyRenderer::uploadCommands()
+{
+    DrawElementsIndirectCommand *region = static_cast<DrawElementsIndirectCommand *>(commands.map());
+    if (!region)
+        return;
+    for (size_t level = 0; level < groups.size(); ++level)
+    {
+        const Planet::Mesh &mesh = spheres.mesh(level);
+        region[level] = {static_cast<GLuint>(mesh.indexCount), static_cast<GLuint>(groups[level].visible),
+                         mesh.firstIndex, mesh.baseVertex, static_cast<GLuint>(groups[level].slot)};
+    }
+    commands.unmap();
+}
+
+/**
+ * @brief Reads the latest command region back (a synchronous GL query; for checks only).
+ */
+std::vector<DrawElementsIndirectCommand> BodyRenderer::writtenCommands() const
+{
+    std::vector<DrawElementsIndirectCommand> written(indirect ? groups.size() : 0);
+    if (written.empty())
+        return written;
+    glBindBuffer(GL_COPY_READ_BUFFER, commands.buffer());
+    const GLsizeiptr bytes = static_cast<GLsizeiptr>(written.size() * sizeof(DrawElementsIndirectCommand));
+    glGetBufferSubData(GL_COPY_READ_BUFFER, commands.offset(), bytes, written.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return written;
+}
+
+/**
+ * @brief Sum over the levels of their instances times their triangles.
+ */
+size_t BodyRenderer::triangleCount() const
+{
+    size_t triangles = 0;
+    for (size_t level = 0; level < groups.size(); ++level)
+    {
+        triangles += groups[level].visible * static_cast<size_t>(spheres.mesh(level).indexCount / 3);
+    }
+    return triangles;
+}
+
+/**
+ * @brief One multi-draw if anything is visible, else one instanced draw per non-empty level.
+ */
+size_t BodyRenderer::drawCalls() const
+{
+    if (order.empty())
+        return 0;
+    if (indirect)
+        return 1;
+    return static_cast<size_t>(std::count_if(groups.begin(), groups.end(), [](const Group &group)
+                                             { return group.visible > 0; }));
+}
+
+/**
+ * @brief The indirect path is one item at the nearest visible body's depth; the fallback is
+ * one item per non-empty level, so the queue can order the levels among themselves.
+ */
+void BodyRenderer::enqueue(RenderQueue &queue, unsigned int program, unsigned int textures) const
+{
+    if (order.empty())
+        return;
+    if (indirect)
+    {
+        float nearest = distances[order.front()];
+        for (const Group &group : groups)
+        {
+            if (group.visible > 0)
+                nearest = std::min(nearest, group.nearest);
+        }
+        queue.submit(RenderPass::Opaque, program, GL_TEXTURE_2D_ARRAY, textures, spheres.vertexArray(), 0, nearest,
+                     [this]()
+                     { drawGroups(0); });
+        return;
+    }
+    for (size_t level = 0; level < groups.size(); ++level)
+    {
+        if (groups[level].visible == 0)
+            continue;
+        queue.submit(RenderPass::Opaque, program, GL_TEXTURE_2D_ARRAY, textures, spheres.vertexArray(),
+                     static_cast<unsigned int>(level), groups[level].nearest, [this, level]()
+                     { drawGroups(level); });
+    }
+}
+
+/**
+ * @brief Indirect path: one multi-draw from the latest command region, each command's
+ * baseInstance selecting its instances. Fallback: one instanced draw, the attributes re-pointed
+ * at the group's first slot.
+ */
+void BodyRenderer::drawGroups(size_t group) const
+{
+    if (indirect)
+    {
+        pointInstanceAttributes(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.buffer());
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void *)commands.offset(),
+                                    static_cast<GLsizei>(groups.size()), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    const Group &g = groups[group];
+    pointInstanceAttributes(g.slot);
+    spheres.drawInstanced(static_cast<GLsizei>(g.visible), group);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -15,7 +15,7 @@ Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
       MouseSensitivity(SENSITIVITY),       // Default sensitivity
       Zoom(ZOOM)                           // Default FOV
 {
-    Position = position;
+    Position = glm::dvec3(position);
     WorldUp = up;
     Yaw = yaw;
     Pitch = pitch;
@@ -31,7 +31,7 @@ Camera::Camera(float posX, float posY, float posZ, float upX, float upY, float u
       MouseSensitivity(SENSITIVITY),
       Zoom(ZOOM)
 {
-    Position = glm::vec3(posX, posY, posZ);
+    Position = glm::dvec3(posX, posY, posZ);
     WorldUp = glm::vec3(upX, upY, upZ);
     Yaw = yaw;
     Pitch = pitch;
@@ -40,12 +40,13 @@ Camera::Camera(float posX, float posY, float posZ, float upX, float upY, float u
 
 /**
  * @brief Calculates and returns the view matrix using glm::lookAt.
- * This matrix transforms world coordinates to view (camera) coordinates.
+ * This matrix transforms camera-relative coordinates (world position - Position) to view
+ * coordinates; the translation is left out so no large float values reach the GPU.
  */
 glm::mat4 Camera::GetViewMatrix()
 {
     // glm::lookAt requires: camera position, target position, world up vector
-    return glm::lookAt(Position, Position + Front, Up);
+    return glm::lookAt(glm::vec3(0.0f), Front, Up);
 }
 
 /**
@@ -55,13 +56,13 @@ void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime)
 {
     float velocity = MovementSpeed * deltaTime; // Movement distance for this frame
     if (direction == FORWARD)
-        Position += Front * velocity;
+        Position += glm::dvec3(Front * velocity);
     if (direction == BACKWARD)
-        Position -= Front * velocity;
+        Position -= glm::dvec3(Front * velocity);
     if (direction == LEFT)
-        Position -= Right * velocity; // Use the calculated Right vector
+        Position -= glm::dvec3(Right * velocity); // Use the calculated Right vector
     if (direction == RIGHT)
-        Position += Right * velocity;
+        Position += glm::dvec3(Right * velocity);
     // Note: UP/DOWN movement is handled directly in main.cpp using absolute Y axis
 }
 
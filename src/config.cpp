@@ -3,11 +3,41 @@
  * @brief Implements the configuration loading function using the inih library.
  */
 
-#include "config.h" // Includes definition of Config struct
-#include "ini.h"    // Includes the inih parser header
-#include <iostream> // For error reporting (std::cerr)
-#include <string>   // For std::string comparison
-#include <cstring>  // For strcmp
+#include "config.h"  // Includes definition of Config struct
+#include "ini.h"     // Includes the inih parser header
+#include <iostream>  // For error reporting (std::cerr)
+#include <string>    // For std::string comparison
+#include <cstring>   // For strcmp
+#include <algorithm> // For std::max, std::clamp
+#include <cstdio>    // For std::sscanf
+#include <cstdlib>   // For std::strtod, std::strtol
+#include <cmath>     // For std::isfinite
+
+/**
+ * @brief Parses a date for the ephemeris scenario: either "YYYY-MM-DD" (midnight, proleptic
+ * Gregorian) or a plain number of days. Either way the result is in days past J2000.
+ * @return false if the value is neither.
+ */
+static bool parseJ2000Days(const char *value, double &days)
+{
+    int year = 0, month = 0, day = 0;
+    char tail = 0;
+    if (std::sscanf(value, "%d-%d-%d%c", &year, &month, &day, &tail) == 3 && month >= 1 && month <= 12 && day >= 1 && day <= 31)
+    {
+        // Days since 1970-01-01 (Howard Hinnant's days_from_civil)
+        const int y = year - (month <= 2 ? 1 : 0);
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const int yearOfEra = y - era * 400;
+        const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        const double unixDays = era * 146097.0 + dayOfEra - 719468.0;
+        days = unixDays - 10957.5; // J2000 is 2000-01-01 12:00
+        return true;
+    }
+    char *end = nullptr;
+    days = std::strtod(value, &end);
+    return end != value && *end == '\0';
+}
 
 /**
  * @brief Callback function used by the inih parser.
@@ -44,6 +74,82 @@ static int handler(void *user, const char *section, const char *name,
         // Interpret "true" (case-sensitive) as boolean true, otherwise false
         pconfig->startFullscreen = (strcmp(value, "true") == 0);
     }
+    else if (MATCH("render", "multi_draw_indirect"))
+    {
+        pconfig->multiDrawIndirect = (strcmp(value, "true") == 0);
+    }
+    else if (MATCH("render", "lod_pixel_error"))
+    {
+        pconfig->lodPixelError = std::max(0.0f, std::stof(value)); // 0 = always the finest mesh
+    }
+    else if (MATCH("render", "reverse_z"))
+    {
+        pconfig->reverseZ = (strcmp(value, "true") == 0);
+    }
+    else if (MATCH("simulation", "worker_threads"))
+    {
+        pconfig->workerThreads = std::max(0, std::stoi(value)); // Negative values mean "auto" too
+    }
+    else if (MATCH("simulation", "tick_rate"))
+    {
+        pconfig->tickRate = std::max(1.0, std::stod(value)); // At least one tick per second
+    }
+    else if (MATCH("simulation", "start_time"))
+    {
+        pconfig->startTime = std::stod(value);
+    }
+    else if (MATCH("simulation", "scenario"))
+    {
+        pconfig->scenario = value;
+    }
+    else if (MATCH("nbody", "belt_particles"))
+    {
+        pconfig->beltParticles = std::max(0, std::stoi(value));
+    }
+    else if (MATCH("nbody", "integrator"))
+    {
+        pconfig->nbodyIntegrator = value;
+    }
+    else if (MATCH("nbody", "timestep"))
+    {
+        pconfig->nbodyTimestep = std::max(1e-4, std::stod(value)); // Guard against zero (infinite steps)
+    }
+    else if (MATCH("nbody", "max_substeps"))
+    {
+        pconfig->nbodyMaxSubsteps = std::max(1, std::stoi(value));
+    }
+    else if (MATCH("nbody", "max_levels"))
+    {
+        pconfig->nbodyMaxLevels = std::clamp(std::stoi(value), 0, 16);
+    }
+    else if (MATCH("nbody", "accuracy"))
+    {
+        pconfig->nbodyAccuracy = std::max(1e-4, std::stod(value)); // Guard against zero (every body at the deepest level)
+    }
+    else if (MATCH("nbody", "theta"))
+    {
+        pconfig->nbodyTheta = std::clamp(std::stod(value), 0.0, 1.0);
+    }
+    else if (MATCH("nbody", "softening"))
+    {
+        pconfig->nbodySoftening = std::max(0.0, std::stod(value));
+    }
+    else if (MATCH("ephemeris", "file"))
+    {
+        pconfig->ephemerisFile = value;
+    }
+    else if (MATCH("ephemeris", "start_date"))
+    {
+        if (!parseJ2000Days(value, pconfig->ephemerisStartDays))
+        {
+            std::cerr << "Warning: Invalid ephemeris start_date '" << value << "', using J2000." << std::endl;
+            pconfig->ephemerisStartDays = 0.0;
+        }
+    }
+    else if (MATCH("ephemeris", "days_per_second"))
+    {
+        pconfig->ephemerisDaysPerSecond = std::stod(value);
+    }
     else
     {
         return 0; // Unknown section or name, but not necessarily an error, just ignore it
@@ -72,3 +178,77 @@ Config loadConfig(const std::string &filename)
 
     return config; // Return the resulting config (either defaults or file values)
 }
+
+/**
+ * @brief Prints the command-line usage to std::cerr.
+ */
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--headless] [--size WxH] [--frames N] [--duration S] [--warp X] [--lock Body] [--output file.ppm]\n"
+              << "  --headless      Render off-screen through EGL, with no window or display server\n"
+              << "  --size WxH      Render size in pixels (default: [window] in config.ini)\n"
+              << "  --frames N      Exit after N frames (headless default: 300)\n"
+              << "  --duration S    Exit after S seconds of wall-clock time\n"
+              << "  --warp X        Initial time warp (negative runs backwards)\n"
+              << "  --lock Body     Start with the camera locked to the named body\n"
+              << "  --output file   Headless only: write the last frame as a PPM image" << std::endl;
+}
+
+/**
+ * @brief Every option but --headless takes one value, the next argument.
+ */
+bool parseCommandLine(int argc, char **argv, LaunchOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *option = argv[i];
+        if (std::strcmp(option, "--headless") == 0)
+        {
+            options.headless = true;
+            continue;
+        }
+        const char *value = i + 1 < argc ? argv[++i] : nullptr;
+        char *end = nullptr;
+        bool valid = value != nullptr;
+        if (valid && std::strcmp(option, "--size") == 0)
+        {
+            valid = std::sscanf(value, "%dx%d", &options.width, &options.height) == 2 && options.width > 0 && options.height > 0;
+        }
+        else if (valid && std::strcmp(option, "--frames") == 0)
+        {
+            options.frames = static_cast<int>(std::strtol(value, &end, 10));
+            valid = *end == '\0' && options.frames > 0;
+        }
+        else if (valid && std::strcmp(option, "--duration") == 0)
+        {
+            options.duration = std::strtod(value, &end);
+            valid = *end == '\0' && options.duration > 0.0;
+        }
+        else if (valid && std::strcmp(option, "--warp") == 0)
+        {
+            options.warp = std::strtod(value, &end); // Clamped by SimClock::setWarp()
+            valid = *end == '\0' && std::isfinite(*options.warp);
+        }
+        else if (valid && std::strcmp(option, "--lock") == 0)
+        {
+            options.lockBody = value;
+        }
+        else if (valid && std::strcmp(option, "--output") == 0)
+        {
+            options.outputFile = value;
+        }
+        else
+        {
+            valid = false;
+        }
+        if (!valid)
+        {
+            std::cerr << "Error: Invalid option '" << option << (value ? " " : "") << (value ? value : "") << "'" << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.headless && options.frames == 0 && options.duration == 0.0)
+        options.frames = 300;
+    return true;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file depth_mode.cpp
+ * @brief Implements the depth setups and loads the GL 4.5 clip control entry point.
+ */
+
+#include "depth_mode.h"
+
+#include <glm/gtc/matrix_transform.hpp> // For glm::perspective
+
+#include <cmath>   // For std::tan, std::log2
+#include <cstring> // For std::strcmp
+#include <sstream> // For formatting the shader defines
+
+PFNGLCLIPCONTROLPROC solar_glClipControl = nullptr;
+
+/**
+ * @brief Checks the version GLAD found, then the extension list, before looking the function
+ * up (drivers may return a non-null pointer for functions they do not support).
+ */
+bool loadClipControl(GLADloadproc load)
+{
+    solar_glClipControl = nullptr;
+    bool supported = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 5);
+    GLint extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (GLint i = 0; i < extensions && !supported; ++i)
+    {
+        const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        supported = name && std::strcmp(name, "GL_ARB_clip_control") == 0;
+    }
+    if (supported)
+        solar_glClipControl = (PFNGLCLIPCONTROLPROC)load("glClipControl");
+    return solar_glClipControl != nullptr;
+}
+
+/**
+ * @brief Both infinite projections keep w = -z (view space). Reverse-Z sets clip z to the near
+ * distance, so depth = near / distance: 1 at the near plane, falling towards 0 at infinity,
+ * where float depth has its finest steps. The logarithmic mode uses the limit of the standard
+ * matrix as the far plane recedes; its depth comes from the shaders, so the matrix only clips.
+ */
+glm::mat4 depthProjection(DepthMode mode, float fovy, float aspect, float zNear, float zFar)
+{
+    if (mode == DepthMode::Standard)
+        return glm::perspective(fovy, aspect, zNear, zFar);
+    const float f = 1.0f / std::tan(0.5f * fovy);
+    glm::mat4 projection(0.0f);
+    projection[0][0] = f / aspect;
+    projection[1][1] = f;
+    projection[2][3] = -1.0f;
+    if (mode == DepthMode::ReverseZ)
+    {
+        projection[3][2] = zNear;
+    }
+    else
+    {
+        projection[2][2] = -1.0f;
+        projection[3][2] = -2.0f * zNear;
+    }
+    return projection;
+}
+
+/**
+ * @brief Reverse-Z maps clip z from [0, w] to depth (not from [-w, w], whose remapping would
+ * throw away the float precision near 0) and clears to 0, the far end.
+ */
+void applyDepthMode(DepthMode mode)
+{
+    if (mode == DepthMode::ReverseZ)
+    {
+        glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        glClearDepth(0.0);
+    }
+    else
+    {
+        glClearDepth(1.0);
+    }
+    glDepthFunc(sceneDepthFunc(mode));
+}
+
+/**
+ * @brief Nearer fragments have the larger depth under reverse-Z.
+ */
+GLenum sceneDepthFunc(DepthMode mode)
+{
+    return mode == DepthMode::ReverseZ ? GL_GREATER : GL_LESS;
+}
+
+/**
+ * @brief The skybox is drawn at the far end of the range, where only the cleared depth equals it.
+ */
+GLenum skyDepthFunc(DepthMode mode)
+{
+    return mode == DepthMode::ReverseZ ? GL_GEQUAL : GL_LEQUAL;
+}
+
+/**
+ * @brief LOG_DEPTH_SCALE is 1 / log2(1 + LOG_DEPTH_FAR), written with enough digits for a float.
+ */
+std::string depthShaderDefines(DepthMode mode)
+{
+    std::ostringstream defines;
+    if (mode == DepthMode::ReverseZ)
+    {
+        defines << "#define REVERSE_Z\n";
+    }
+    else if (mode == DepthMode::Logarithmic)
+    {
+        defines.precision(9);
+        defines << "#define LOG_DEPTH\n"
+                << "#define LOG_DEPTH_SCALE " << std::fixed << 1.0 / std::log2(1.0 + static_cast<double>(LOG_DEPTH_FAR)) << "\n";
+    }
+    return defines.str();
+}
+
+/**
+ * @brief Mode, depth format and far plane in one line.
+ */
+const char *depthModeName(DepthMode mode)
+{
+    switch (mode)
+    {
+    case DepthMode::ReverseZ:
+        return "reverse-Z, 32-bit float, infinite far plane";
+    case DepthMode::Logarithmic:
+        return "logarithmic, 32-bit float, infinite far plane";
+    default:
+        return "standard, 24-bit";
+    }
+}
@@ -0,0 +1,198 @@
+/**
+ * @file ephemeris.cpp
+ * @brief Implements the EphemerisBatch class: chain resolution and the lockstep Chebyshev evaluation.
+ */
+
+#include "ephemeris.h"
+
+#include <algorithm> // For std::sort, std::min, std::max, std::clamp
+#include <cmath>     // For std::floor
+#include <utility>   // For std::pair
+
+static const int MAX_CHAIN = 16; // Longest target -> ... -> root chain followed (guards against cycles)
+
+/**
+ * @brief Constructor: Stores the file; links and bodies are added by add().
+ */
+EphemerisBatch::EphemerisBatch(std::shared_ptr<const SpkFile> file)
+    : spk(std::move(file))
+{
+    linkSegmentStarts.push_back(0);
+}
+
+/**
+ * @brief Follows the segments from @p id towards the root (the body no segment positions,
+ * normally the solar system barycenter), appending each (target, center) step to @p chain.
+ * @return false if the chain does not end within MAX_CHAIN steps.
+ */
+static bool chainToRoot(const SpkFile &spk, int id, std::vector<std::pair<int, int>> &chain)
+{
+    for (int step = 0; step < MAX_CHAIN; ++step)
+    {
+        auto segment = std::find_if(spk.segments().begin(), spk.segments().end(), [id](const SpkFile::Segment &s)
+                                    { return s.target == id; });
+        if (segment == spk.segments().end())
+            return true; // id is the root
+        chain.emplace_back(id, segment->center);
+        id = segment->center;
+    }
+    return false;
+}
+
+/**
+ * @brief Resolves both bodies to the root, cancels the shared tail of the two chains and
+ * records the remaining steps as + (target side) and - (center side) terms.
+ */
+bool EphemerisBatch::add(int target, int center)
+{
+    if (!spk)
+        return false;
+    std::vector<std::pair<int, int>> up, down; // target -> root, center -> root
+    if (!chainToRoot(*spk, target, up) || !chainToRoot(*spk, center, down))
+        return false;
+    const int targetRoot = up.empty() ? target : up.back().second;
+    const int centerRoot = down.empty() ? center : down.back().second;
+    if (targetRoot != centerRoot)
+        return false; // Not connected by this file
+    while (!up.empty() && !down.empty() && up.back() == down.back())
+    {
+        up.pop_back();
+        down.pop_back();
+    }
+
+    for (const auto &step : up)
+    {
+        termLinks.push_back(static_cast<size_t>(linkFor(step.first, step.second)));
+        termSigns.push_back(1.0);
+    }
+    for (const auto &step : down)
+    {
+        termLinks.push_back(static_cast<size_t>(linkFor(step.first, step.second)));
+        termSigns.push_back(-1.0);
+    }
+    termStarts.push_back(termLinks.size());
+    return true;
+}
+
+/**
+ * @brief Returns the link for a target -> center series, creating it (with its time-sorted
+ * segment list and scratch entries) on first use.
+ */
+int EphemerisBatch::linkFor(int target, int center)
+{
+    for (size_t l = 0; l < linkTargets.size(); ++l)
+    {
+        if (linkTargets[l] == target && linkCenters[l] == center)
+            return static_cast<int>(l);
+    }
+
+    const std::vector<SpkFile::Segment> &segments = spk->segments();
+    const size_t first = linkSegments.size();
+    for (size_t s = 0; s < segments.size(); ++s)
+    {
+        if (segments[s].target == target && segments[s].center == center)
+        {
+            linkSegments.push_back(s);
+            maxCoefficients = std::max(maxCoefficients, segments[s].coefficientCount);
+        }
+    }
+    std::sort(linkSegments.begin() + first, linkSegments.end(), [&](size_t a, size_t b)
+              { return segments[a].startTime < segments[b].startTime; });
+    linkSegmentStarts.push_back(linkSegments.size());
+    cachedSegments.push_back(first);
+
+    linkTargets.push_back(target);
+    linkCenters.push_back(center);
+    coefficients.push_back(nullptr);
+    coefficientCounts.push_back(0);
+    twoS.push_back(0.0);
+    for (std::vector<double> *b : {&b1x, &b1y, &b1z, &b2x, &b2y, &b2z})
+    {
+        b->push_back(0.0);
+    }
+    return static_cast<int>(linkTargets.size() - 1);
+}
+
+/**
+ * @brief Picks each link's segment and record, runs Clenshaw's recurrence for all links at
+ * once, then sums the signed links of each body.
+ */
+void EphemerisBatch::evaluate(double et, double *x, double *y, double *z)
+{
+    const std::vector<SpkFile::Segment> &segments = spk->segments();
+    const size_t linkCount = linkTargets.size();
+
+    // --- Record lookup: O(1) within the cached segment, a short scan when crossing segments ---
+    for (size_t l = 0; l < linkCount; ++l)
+    {
+        const SpkFile::Segment *segment = &segments[linkSegments[cachedSegments[l]]];
+        if (et < segment->startTime || et > segment->endTime)
+        {
+            size_t pick = linkSegmentStarts[l]; // Latest segment starting at or before et, else the first
+            for (size_t k = linkSegmentStarts[l]; k < linkSegmentStarts[l + 1]; ++k)
+            {
+                if (segments[linkSegments[k]].startTime <= et)
+                    pick = k;
+            }
+            cachedSegments[l] = pick;
+            segment = &segments[linkSegments[pick]];
+        }
+        const double t = std::clamp(et, segment->startTime, segment->endTime);
+        const double index = std::floor((t - segment->initialTime) / segment->intervalLength);
+        const size_t record = static_cast<size_t>(std::clamp(index, 0.0, static_cast<double>(segment->recordCount - 1)));
+        const double *data = segment->records + record * segment->recordSize;
+        twoS[l] = 2.0 * std::clamp((t - data[0]) / data[1], -1.0, 1.0); // data[0] = midpoint, data[1] = half length
+        coefficients[l] = data + 2;
+        coefficientCounts[l] = segment->coefficientCount;
+        b1x[l] = b1y[l] = b1z[l] = 0.0;
+        b2x[l] = b2y[l] = b2z[l] = 0.0;
+    }
+
+    // --- Clenshaw, all links in lockstep: b(k) = 2s b(k+1) - b(k+2) + c(k) ---
+    for (size_t k = maxCoefficients; k-- > 1;)
+    {
+        for (size_t l = 0; l < linkCount; ++l)
+        {
+            const size_t n = coefficientCounts[l];
+            const double *c = coefficients[l];
+            const double cx = k < n ? c[k] : 0.0;
+            const double cy = k < n ? c[n + k] : 0.0;
+            const double cz = k < n ? c[2 * n + k] : 0.0;
+            const double bx = twoS[l] * b1x[l] - b2x[l] + cx;
+            const double by = twoS[l] * b1y[l] - b2y[l] + cy;
+            const double bz = twoS[l] * b1z[l] - b2z[l] + cz;
+            b2x[l] = b1x[l];
+            b2y[l] = b1y[l];
+            b2z[l] = b1z[l];
+            b1x[l] = bx;
+            b1y[l] = by;
+            b1z[l] = bz;
+        }
+    }
+    // Final step: f(s) = s b(1) - b(2) + c(0); the result goes into b1
+    for (size_t l = 0; l < linkCount; ++l)
+    {
+        const size_t n = coefficientCounts[l];
+        const double *c = coefficients[l];
+        const double s = 0.5 * twoS[l];
+        b1x[l] = s * b1x[l] - b2x[l] + c[0];
+        b1y[l] = s * b1y[l] - b2y[l] + c[n];
+        b1z[l] = s * b1z[l] - b2z[l] + c[2 * n];
+    }
+
+    // --- Bodies ---
+    for (size_t b = 0; b + 1 < termStarts.size(); ++b)
+    {
+        double sx = 0.0, sy = 0.0, sz = 0.0;
+        for (size_t t = termStarts[b]; t < termStarts[b + 1]; ++t)
+        {
+            const size_t l = termLinks[t];
+            sx += termSigns[t] * b1x[l];
+            sy += termSigns[t] * b1y[l];
+            sz += termSigns[t] * b1z[l];
+        }
+        x[b] = sx;
+        y[b] = sy;
+        z[b] = sz;
+    }
+}
@@ -0,0 +1,30 @@
+/**
+ * @file frame_data.cpp
+ * @brief Implements the FrameDataBuffer class.
+ */
+
+#include "frame_data.h"
+
+#include <cstring> // For std::memcpy
+
+/**
+ * @brief Constructor: Allocates the stream buffer regions.
+ */
+FrameDataBuffer::FrameDataBuffer()
+{
+    stream.allocate(sizeof(FrameData));
+}
+
+/**
+ * @brief Writes the values into the next region and binds that region, so the update never
+ * waits for the previous frames' draws still reading theirs.
+ */
+void FrameDataBuffer::update(const FrameData &data)
+{
+    void *region = stream.map();
+    if (!region)
+        return;
+    std::memcpy(region, &data, sizeof(FrameData));
+    stream.unmap();
+    glBindBufferRange(GL_UNIFORM_BUFFER, BINDING, stream.buffer(), stream.offset(), sizeof(FrameData));
+}
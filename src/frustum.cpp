@@ -0,0 +1,119 @@
+/**
+ * @file frustum.cpp
+ * @brief Implements frustum plane extraction and the SoA sphere culling kernel on top of simd_math.h.
+ */
+
+#include "frustum.h"
+#include "simd_math.h" // SIMD backend
+
+#include <cmath> // For std::sqrt
+
+/**
+ * @brief Gribb-Hartmann extraction: each plane is the last row of the matrix plus or minus
+ * one of the others, normalized by the length of its normal.
+ */
+Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection)
+{
+    const glm::mat4 &m = viewProjection;
+    const glm::vec4 row[4] = {glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]),
+                              glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]),
+                              glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]),
+                              glm::vec4(m[0][3], m[1][3], m[2][3], m[3][3])};
+    Frustum frustum;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        frustum.planes[2 * axis] = row[3] + row[axis];
+        frustum.planes[2 * axis + 1] = row[3] - row[axis];
+    }
+    for (glm::vec4 &plane : frustum.planes)
+    {
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f)
+            plane /= length;
+    }
+    return frustum;
+}
+
+/**
+ * @brief Same test and operation order as the kernel, one sphere at a time (results can differ
+ * only by the rounding of fused multiply-adds, for spheres exactly touching a plane).
+ */
+bool Frustum::intersects(const glm::vec3 &center, float radius) const
+{
+    for (const glm::vec4 &plane : planes)
+    {
+        if (plane.x * center.x + (plane.y * center.y + (plane.z * center.z + plane.w)) + radius < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Resizes every array, filling new (and padding) entries with a sphere of negative
+ * radius, which no plane test can pass.
+ */
+void SphereBatch::resize(size_t n)
+{
+    size_t padded = (n + laneBlock - 1) / laneBlock * laneBlock;
+    centerX.resize(padded, 0.0f);
+    centerY.resize(padded, 0.0f);
+    centerZ.resize(padded, 0.0f);
+    radius.resize(padded, -1.0f);
+    for (size_t i = n; i < padded; ++i)
+        radius[i] = -1.0f; // Entries left over from a larger size
+    count = n;
+}
+
+/**
+ * @brief Kernel body. Each iteration takes the smallest signed distance of Simd::width sphere
+ * surfaces over the six planes; lanes where it is negative are outside. The visible lanes of
+ * the resulting bit mask are appended in order, so the list stays sorted and compact.
+ */
+size_t cullSphereBatch(const Frustum &frustum, const SphereBatch &spheres, std::vector<unsigned int> &visible)
+{
+    using namespace simd;
+    constexpr int W = Simd::width;
+    static_assert(SphereBatch::laneBlock % W == 0, "Lane block must be a multiple of the SIMD width");
+
+    visible.clear();
+    const size_t count = spheres.size();
+    const Simd zero = set1(0.0f);
+    Simd nx[6], ny[6], nz[6], d[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        nx[p] = set1(frustum.planes[p].x);
+        ny[p] = set1(frustum.planes[p].y);
+        nz[p] = set1(frustum.planes[p].z);
+        d[p] = set1(frustum.planes[p].w);
+    }
+
+    for (size_t base = 0; base < count; base += W)
+    {
+        const Simd cx = load(&spheres.centerX[base]);
+        const Simd cy = load(&spheres.centerY[base]);
+        const Simd cz = load(&spheres.centerZ[base]);
+        const Simd r = load(&spheres.radius[base]);
+
+        Simd margin = fmadd(nx[0], cx, fmadd(ny[0], cy, fmadd(nz[0], cz, d[0]))) + r;
+        for (int p = 1; p < 6; ++p)
+        {
+            margin = min(margin, fmadd(nx[p], cx, fmadd(ny[p], cy, fmadd(nz[p], cz, d[p]))) + r);
+        }
+
+        const int outside = movemask(cmplt(margin, zero));
+        for (int l = 0; l < W; ++l)
+        {
+            if (!(outside & (1 << l)) && base + l < count)
+                visible.push_back(static_cast<unsigned int>(base + l));
+        }
+    }
+    return visible.size();
+}
+
+/**
+ * @brief Reports the compiled SIMD backend.
+ */
+const char *cullKernelBackend()
+{
+    return simd::Simd::name;
+}
@@ -0,0 +1,21 @@
+/**
+ * @file gl_indirect.cpp
+ * @brief Loads the GL 4.3 multi-draw-indirect entry point.
+ */
+
+#include "gl_indirect.h"
+
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC solar_glMultiDrawElementsIndirect = nullptr;
+
+/**
+ * @brief Checks the version GLAD found and looks the function up. Drivers may return a
+ * non-null pointer for functions of newer versions, so the version is checked first.
+ */
+bool loadIndirectDraw(GLADloadproc load)
+{
+    solar_glMultiDrawElementsIndirect = nullptr;
+    if (GLVersion.major < 4 || (GLVersion.major == 4 && GLVersion.minor < 3))
+        return false;
+    solar_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)load("glMultiDrawElementsIndirect");
+    return solar_glMultiDrawElementsIndirect != nullptr;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file headless_context.cpp
+ * @brief Implements the HeadlessContext class: EGL display selection and surfaceless context creation.
+ */
+
+#include "headless_context.h"
+
+#include <iostream> // For error output
+
+#ifdef SOLAR_HAS_EGL
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring> // For strlen, strchr, strncmp
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+/**
+ * @brief True if the space-separated extension list @p extensions contains @p name.
+ */
+static bool hasExtension(const char *extensions, const char *name)
+{
+    const size_t length = std::strlen(name);
+    for (const char *p = extensions; p && *p;)
+    {
+        const char *end = std::strchr(p, ' ');
+        const size_t tokenLength = end ? static_cast<size_t>(end - p) : std::strlen(p);
+        if (tokenLength == length && std::strncmp(p, name, length) == 0)
+            return true;
+        p = end ? end + 1 : nullptr;
+    }
+    return false;
+}
+
+/**
+ * @brief Destructor: Releases the context, then the display.
+ */
+HeadlessContext::~HeadlessContext()
+{
+    if (display != nullptr)
+    {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context != nullptr)
+            eglDestroyContext(display, context);
+        eglTerminate(display);
+    }
+}
+
+/**
+ * @brief The display is initialized on the first call only; a failed context version leaves it
+ * for the next attempt, a failed display fails every later call too. Client extensions
+ * (EGL_NO_DISPLAY) are only listed by EGL 1.5 or EGL_EXT_client_extensions, so a null list
+ * falls back to the default display.
+ */
+bool HeadlessContext::create(int major, int minor)
+{
+    if (unavailable)
+        return false;
+    if (display == nullptr)
+    {
+        const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+        if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless") && hasExtension(clientExtensions, "EGL_EXT_platform_base"))
+        {
+            auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay)
+                eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (eglDisplay == EGL_NO_DISPLAY)
+            eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr))
+        {
+            std::cerr << "ERROR::HEADLESS: No EGL display could be initialized" << std::endl;
+            unavailable = true;
+            return false;
+        }
+        display = eglDisplay;
+        if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context") || !eglBindAPI(EGL_OPENGL_API))
+        {
+            std::cerr << "ERROR::HEADLESS: The EGL display supports no surfaceless OpenGL contexts" << std::endl;
+            unavailable = true;
+            return false;
+        }
+    }
+
+    // No surface type is required: the context is never bound to one
+    const EGLint configAttributes[] = {EGL_SURFACE_TYPE, 0, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        std::cerr << "ERROR::HEADLESS: No EGL config for OpenGL rendering" << std::endl;
+        unavailable = true;
+        return false;
+    }
+    const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION_KHR, major,
+                                        EGL_CONTEXT_MINOR_VERSION_KHR, minor,
+                                        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+                                        EGL_NONE};
+    EGLContext eglContext = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (eglContext == EGL_NO_CONTEXT)
+        return false; // Version not supported; the caller may try a lower one
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext))
+    {
+        eglDestroyContext(display, eglContext);
+        std::cerr << "ERROR::HEADLESS: Failed to make the OpenGL context current" << std::endl;
+        return false;
+    }
+    context = eglContext;
+    return true;
+}
+
+/**
+ * @brief eglGetProcAddress also returns core functions (EGL 1.5, EGL_KHR_get_all_proc_addresses).
+ */
+void *HeadlessContext::getProcAddress(const char *name)
+{
+    return reinterpret_cast<void *>(eglGetProcAddress(name));
+}
+
+#else // No EGL: the application was built without headless support
+
+/**
+ * @brief Destructor: Nothing to release.
+ */
+HeadlessContext::~HeadlessContext() = default;
+
+/**
+ * @brief Always fails: there is no EGL library to create the context with.
+ */
+bool HeadlessContext::create(int, int)
+{
+    if (!unavailable)
+        std::cerr << "ERROR::HEADLESS: Built without EGL; headless rendering is unavailable" << std::endl;
+    unavailable = true;
+    return false;
+}
+
+/**
+ * @brief No entry points without a context.
+ */
+void *HeadlessContext::getProcAddress(const char *)
+{
+    return nullptr;
+}
+
+#endif // SOLAR_HAS_EGL
@@ -0,0 +1,435 @@
+/**
+ * @file hierarchy.cpp
+ * @brief Implements the TransformHierarchy class: scenario compilation and the linear update pass.
+ */
+
+#include "hierarchy.h"
+#include "scenario.h"    // For Scenario and CelestialBody
+#include "scene_frame.h" // For the ephemeris frame -> scene mapping
+#include "thread_pool.h"
+
+#include <algorithm> // For std::stable_sort, std::fill
+#include <cmath>     // For std::sqrt, std::sin, std::cos
+#include <iostream>  // For warnings (std::cerr)
+#include <numeric>   // For std::iota
+
+/**
+ * @brief Constructor: Resolves parent names to indices and orders the bodies breadth-first.
+ */
+TransformHierarchy::TransformHierarchy(const Scenario &scenario)
+{
+    const size_t bodyCount = scenario.bodies.size();
+
+    // Name -> body index, used only while resolving parents
+    std::unordered_map<std::string, size_t> bodyByName;
+    bodyByName.reserve(bodyCount);
+    for (size_t i = 0; i < bodyCount; ++i)
+    {
+        if (!bodyByName.emplace(scenario.bodies[i].name, i).second)
+        {
+            std::cerr << "Warning: Duplicate body name '" << scenario.bodies[i].name
+                      << "', children will attach to the first one." << std::endl;
+        }
+    }
+
+    // Build child lists (in scenario order) and collect the roots
+    std::vector<std::vector<size_t>> children(bodyCount);
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < bodyCount; ++i)
+    {
+        const CelestialBody &body = scenario.bodies[i];
+        if (!body.parentName || body.dynamics == Dynamics::NBody) // N-body positions are in world space
+        {
+            roots.push_back(i);
+            continue;
+        }
+        auto it = bodyByName.find(*body.parentName);
+        if (it == bodyByName.end() || it->second == i)
+        {
+            std::cerr << "Warning: Parent '" << *body.parentName << "' of body '" << body.name
+                      << "' not found, treating it as a root." << std::endl;
+            roots.push_back(i);
+            continue;
+        }
+        children[it->second].push_back(i);
+    }
+
+    // Breadth-first traversal: parents always precede children, depths are contiguous
+    std::vector<int> nodeOfBody(bodyCount, NO_PARENT);
+    bodyIndices.reserve(bodyCount);
+    parents.reserve(bodyCount);
+    auto appendRoot = [&](size_t body)
+    {
+        nodeOfBody[body] = static_cast<int>(bodyIndices.size());
+        bodyIndices.push_back(body);
+        parents.push_back(NO_PARENT);
+    };
+    // Appends the descendants of every node from 'first' onwards, level by level
+    auto appendDescendants = [&](size_t first)
+    {
+        for (size_t n = first; n < bodyIndices.size(); ++n)
+        {
+            for (size_t child : children[bodyIndices[n]])
+            {
+                if (nodeOfBody[child] != NO_PARENT)
+                    continue; // Already placed
+                nodeOfBody[child] = static_cast<int>(bodyIndices.size());
+                bodyIndices.push_back(child);
+                parents.push_back(static_cast<int>(n));
+            }
+        }
+    };
+    for (size_t root : roots)
+    {
+        appendRoot(root);
+    }
+    appendDescendants(0);
+
+    // Bodies never reached are part of a parent cycle; break the cycle by promoting them to roots
+    for (size_t i = 0; i < bodyCount; ++i)
+    {
+        if (nodeOfBody[i] == NO_PARENT)
+        {
+            std::cerr << "Warning: Body '" << scenario.bodies[i].name
+                      << "' is part of a parent cycle, treating it as a root." << std::endl;
+            size_t first = bodyIndices.size();
+            appendRoot(i);
+            appendDescendants(first);
+        }
+    }
+
+    // Cycle-broken roots were appended after deeper nodes; regroup all nodes by depth so each
+    // level is one contiguous range. Parents still precede children since depth strictly increases.
+    const size_t nodeCount = bodyIndices.size();
+    std::vector<int> depths(nodeCount);
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        depths[n] = parents[n] == NO_PARENT ? 0 : depths[parents[n]] + 1;
+    }
+    std::vector<size_t> order(nodeCount);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                     { return depths[a] < depths[b]; });
+    std::vector<int> newIndex(nodeCount);
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        newIndex[order[n]] = static_cast<int>(n);
+    }
+    std::vector<size_t> sortedBodies(nodeCount);
+    std::vector<int> sortedParents(nodeCount);
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        sortedBodies[n] = bodyIndices[order[n]];
+        int parent = parents[order[n]];
+        sortedParents[n] = parent == NO_PARENT ? NO_PARENT : newIndex[parent];
+        if (n == 0 || depths[order[n]] != depths[order[n - 1]])
+        {
+            levelStarts.push_back(n); // First node of a new depth level
+        }
+    }
+    levelStarts.push_back(nodeCount); // Sentinel: end of the last level
+    bodyIndices.swap(sortedBodies);
+    parents.swap(sortedParents);
+
+    // Bodies with ephemeris data under a parent with ephemeris data are positioned from the file
+    ephemerisParams = EphemerisBatch(scenario.ephemeris);
+    ephemerisEpoch = scenario.ephemerisEpoch;
+    ephemerisTimeScale = scenario.ephemerisTimeScale;
+    std::vector<double> ephemerisRadii; // Scene orbit radius per entry, matched at the epoch below
+
+    // Copy animation parameters into node order
+    params.resize(nodeCount);
+    worlds.assign(nodeCount, glm::mat4(1.0f));
+    positions.assign(nodeCount, glm::dvec3(0.0));
+    nodeByName.reserve(nodeCount);
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        const CelestialBody &body = scenario.bodies[bodyIndices[n]];
+        // Bodies on an elliptical or simulated orbit get no circular orbit; their translation
+        // comes from the Kepler pass or from setDynamicPosition()
+        const bool dynamic = body.dynamics == Dynamics::NBody;
+        const CelestialBody *parent = parents[n] == NO_PARENT ? nullptr : &scenario.bodies[bodyIndices[parents[n]]];
+        const bool ephemeris = !dynamic && body.ephemerisId && parent && parent->ephemerisId &&
+                               ephemerisParams.add(*body.ephemerisId, *parent->ephemerisId);
+        float orbitRadius = (body.orbitElements || dynamic || ephemeris) ? 0.0f : body.orbitRadius;
+        params.set(n, orbitRadius, body.orbitSpeed, body.rotationSpeed,
+                   body.rotationAxis.x, body.rotationAxis.y, body.rotationAxis.z, body.radius);
+        nodeByName.emplace(body.name, static_cast<int>(n));
+        if (dynamic)
+        {
+            dynamicNodeList.push_back(static_cast<int>(n));
+        }
+        else if (ephemeris)
+        {
+            ephemerisNodes.push_back(static_cast<int>(n));
+            ephemerisRadii.push_back(body.orbitElements ? body.orbitElements->semiMajorAxis : body.orbitRadius);
+        }
+        else if (body.orbitElements)
+        {
+            keplerNodes.push_back(static_cast<int>(n));
+        }
+    }
+
+    keplerParams.resize(keplerNodes.size());
+    for (size_t k = 0; k < keplerNodes.size(); ++k)
+    {
+        keplerParams.set(k, *scenario.bodies[bodyIndices[keplerNodes[k]]].orbitElements);
+    }
+    keplerX.assign(keplerParams.paddedSize(), 0.0f);
+    keplerY.assign(keplerParams.paddedSize(), 0.0f);
+    keplerZ.assign(keplerParams.paddedSize(), 0.0f);
+    dynamicPositions.assign(dynamicNodeList.size(), glm::dvec3(0.0));
+    moveDeltas.assign(nodeCount, glm::dvec3(0.0));
+    moved.assign(nodeCount, 0);
+
+    // Real distances span too many orders of magnitude for the scene, so each body keeps its
+    // scenario orbit radius at the epoch and only the direction and shape of its orbit come from the file
+    ephemerisX.assign(ephemerisNodes.size(), 0.0);
+    ephemerisY.assign(ephemerisNodes.size(), 0.0);
+    ephemerisZ.assign(ephemerisNodes.size(), 0.0);
+    ephemerisScales.assign(ephemerisNodes.size(), 0.0);
+    if (!ephemerisNodes.empty())
+    {
+        ephemerisParams.evaluate(ephemerisEpoch, ephemerisX.data(), ephemerisY.data(), ephemerisZ.data());
+        for (size_t e = 0; e < ephemerisNodes.size(); ++e)
+        {
+            const double distance = std::sqrt(ephemerisX[e] * ephemerisX[e] + ephemerisY[e] * ephemerisY[e] + ephemerisZ[e] * ephemerisZ[e]);
+            ephemerisScales[e] = distance > 0.0 ? ephemerisRadii[e] / distance : 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Looks up a node by body name.
+ */
+int TransformHierarchy::findNode(const std::string &name) const
+{
+    auto it = nodeByName.find(name);
+    return it != nodeByName.end() ? it->second : -1;
+}
+
+/**
+ * @brief Evaluates every node's local transform with the batch kernels, then composes the
+ * hierarchy level by level. Nodes within a level only read their parent's (already final)
+ * position from the previous level and write their own matrix, so each level can be split
+ * across threads without changing the result. Local offsets are small next to the distances
+ * they are added to, so they stay float; the sums are formed in double and the matrices get
+ * the rounded result.
+ */
+void TransformHierarchy::update(SimClock::Ticks simTime, ThreadPool *pool)
+{
+    if (worlds.empty())
+        return;
+    if (evaluated && simTime == lastTime)
+    {
+        updateMovedSubtrees(); // Paused (or re-evaluated at the same tick): nothing analytic can have moved
+        return;
+    }
+
+    // Runs fn over [begin, end) on the pool if there is one, otherwise inline
+    auto forRange = [pool](size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn)
+    {
+        if (pool)
+            pool->parallelFor(begin, end, grain, fn);
+        else
+            fn(begin, end);
+    };
+
+    // Local transforms: translate(orbitOffset) * rotate * scale. No dependencies between nodes,
+    // so the whole array is one parallel loop (chunks aligned to the kernel's lane block).
+    float *out = &worlds[0][0][0];
+    forRange(0, worlds.size(), KERNEL_GRAIN, [&](size_t first, size_t last)
+             {
+                 evaluateOrbitBatchRange(params, simTime, out, first, last);
+                 for (size_t n = first; n < last; ++n)
+                 {
+                     positions[n] = glm::dvec3(glm::vec3(worlds[n][3]));
+                 } });
+
+    // Elliptical orbits: solve Kepler's equation for every such node, then write the positions
+    // into the (zero) translations the kernel produced for them
+    forRange(0, keplerNodes.size(), KERNEL_GRAIN, [&](size_t first, size_t last)
+             {
+                 evaluateKeplerBatchRange(keplerParams, simTime, keplerX.data(), keplerY.data(), keplerZ.data(), first, last);
+                 for (size_t k = first; k < last; ++k)
+                 {
+                     worlds[keplerNodes[k]][3] = glm::vec4(keplerX[k], keplerY[k], keplerZ[k], 1.0f);
+                     positions[keplerNodes[k]] = glm::dvec3(keplerX[k], keplerY[k], keplerZ[k]);
+                 } });
+
+    // Ephemeris bodies: one batched Chebyshev evaluation, rotated from the J2000 equator to the
+    // ecliptic scene frame (ecliptic north = +Y, vernal equinox = +X, see scene_frame.h) and
+    // scaled per body
+    if (!ephemerisNodes.empty())
+    {
+        const double et = ephemerisEpoch + ephemerisTimeScale * static_cast<double>(simTime) / SimClock::TICKS_PER_SECOND;
+        ephemerisParams.evaluate(et, ephemerisX.data(), ephemerisY.data(), ephemerisZ.data());
+        for (size_t e = 0; e < ephemerisNodes.size(); ++e)
+        {
+            positions[ephemerisNodes[e]] = equatorialToScene(ephemerisX[e], ephemerisY[e], ephemerisZ[e]) * ephemerisScales[e];
+            worlds[ephemerisNodes[e]][3] = glm::vec4(glm::vec3(positions[ephemerisNodes[e]]), 1.0f);
+        }
+    }
+
+    // Simulated bodies: positions supplied by the N-body system (few nodes, no need to split)
+    for (size_t k = 0; k < dynamicNodeList.size(); ++k)
+    {
+        worlds[dynamicNodeList[k]][3] = glm::vec4(glm::vec3(dynamicPositions[k]), 1.0f);
+        positions[dynamicNodeList[k]] = dynamicPositions[k];
+    }
+
+    // Compose level by level; roots (level 0) have nothing to inherit. Only the parent's
+    // translation is inherited, so its scale/rotation does not affect the child's orbit.
+    for (size_t level = 1; level + 1 < levelStarts.size(); ++level)
+    {
+        forRange(levelStarts[level], levelStarts[level + 1], COMPOSE_GRAIN, [&](size_t first, size_t last)
+                 {
+                     for (size_t n = first; n < last; ++n)
+                     {
+                         positions[n] += positions[parents[n]];
+                         worlds[n][3] = glm::vec4(glm::vec3(positions[n]), 1.0f);
+                     } });
+    }
+
+    evaluated = true;
+    lastTime = simTime;
+    recomputed = worlds.size();
+    dynamicMoved = false;
+}
+
+/**
+ * @brief Incremental update at an unchanged time: moves each dynamic node whose position was
+ * changed and shifts its descendants by the same amount. Children only inherit the parent's
+ * translation, so adding the parent's displacement gives the same result as recomposing.
+ */
+void TransformHierarchy::updateMovedSubtrees()
+{
+    recomputed = 0;
+    if (!dynamicMoved)
+        return;
+    dynamicMoved = false;
+
+    for (size_t k = 0; k < dynamicNodeList.size(); ++k)
+    {
+        const int node = dynamicNodeList[k];
+        const glm::dvec3 delta = dynamicPositions[k] - positions[node];
+        if (delta == glm::dvec3(0.0))
+            continue;
+        positions[node] = dynamicPositions[k];
+        worlds[node][3] = glm::vec4(glm::vec3(dynamicPositions[k]), 1.0f);
+        moveDeltas[node] = delta;
+        moved[node] = 1;
+        ++recomputed;
+    }
+    // Parents precede children, so one forward pass reaches every descendant
+    for (size_t n = levelStarts.size() > 2 ? levelStarts[1] : worlds.size(); n < worlds.size(); ++n)
+    {
+        if (moved[parents[n]])
+        {
+            moveDeltas[n] = moveDeltas[parents[n]];
+            positions[n] += moveDeltas[n];
+            worlds[n][3] = glm::vec4(glm::vec3(positions[n]), 1.0f);
+            moved[n] = 1;
+            ++recomputed;
+        }
+    }
+    std::fill(moved.begin(), moved.end(), static_cast<unsigned char>(0));
+}
+
+// Source of a selected node's local offset (Selection::kinds)
+enum SelectionKind : unsigned char
+{
+    SELECT_CIRCULAR,
+    SELECT_KEPLER,
+    SELECT_EPHEMERIS,
+    SELECT_DYNAMIC
+};
+
+/**
+ * @brief Marks the nodes and their ancestors, then lists the marked nodes in node order and
+ * looks up each one's Kepler, ephemeris or dynamic entry.
+ */
+TransformHierarchy::Selection TransformHierarchy::select(const std::vector<int> &nodes) const
+{
+    std::vector<int> slotOf(size(), NO_PARENT);
+    for (int node : nodes)
+    {
+        for (int n = node; n != NO_PARENT && slotOf[n] == NO_PARENT; n = parents[n])
+            slotOf[n] = 0; // Marked; numbered below
+    }
+
+    Selection selection;
+    for (size_t n = 0; n < size(); ++n)
+    {
+        if (slotOf[n] == NO_PARENT)
+            continue;
+        slotOf[n] = static_cast<int>(selection.nodes.size());
+        selection.nodes.push_back(static_cast<int>(n));
+        selection.parentSlots.push_back(parents[n] == NO_PARENT ? NO_PARENT : slotOf[parents[n]]);
+        selection.kinds.push_back(SELECT_CIRCULAR);
+        selection.sources.push_back(n);
+    }
+    auto assignSource = [&](const std::vector<int> &entryNodes, unsigned char kind)
+    {
+        for (size_t e = 0; e < entryNodes.size(); ++e)
+        {
+            const int slot = slotOf[entryNodes[e]];
+            if (slot == NO_PARENT)
+                continue;
+            selection.kinds[slot] = kind;
+            selection.sources[slot] = e;
+            selection.ephemeris = selection.ephemeris || kind == SELECT_EPHEMERIS;
+        }
+    };
+    assignSource(keplerNodes, SELECT_KEPLER);
+    assignSource(ephemerisNodes, SELECT_EPHEMERIS);
+    assignSource(dynamicNodeList, SELECT_DYNAMIC);
+
+    for (int node : nodes)
+        selection.selectedSlots.push_back(static_cast<size_t>(slotOf[node]));
+    selection.positions.assign(selection.nodes.size(), glm::dvec3(0.0));
+    return selection;
+}
+
+/**
+ * @brief The same offsets as update() (the circular orbit and Kepler phases from the tick count,
+ * ephemeris positions from the batch), evaluated in double and summed along the slots' parents.
+ */
+void TransformHierarchy::positionsAt(SimClock::Ticks simTime, Selection &selection)
+{
+    if (selection.ephemeris)
+    {
+        const double et = ephemerisEpoch + ephemerisTimeScale * static_cast<double>(simTime) / SimClock::TICKS_PER_SECOND;
+        ephemerisParams.evaluate(et, ephemerisX.data(), ephemerisY.data(), ephemerisZ.data());
+    }
+    for (size_t slot = 0; slot < selection.nodes.size(); ++slot)
+    {
+        const size_t source = selection.sources[slot];
+        glm::dvec3 local(0.0);
+        switch (selection.kinds[slot])
+        {
+        case SELECT_CIRCULAR:
+        {
+            const double radius = params.orbitRadius[source];
+            const double angle = phaseAngleExact(params.orbitRate[source], simTime);
+            local = referenceToScene(radius * std::cos(angle), radius * std::sin(angle), 0.0);
+            break;
+        }
+        case SELECT_KEPLER:
+        {
+            double position[3];
+            keplerPositionAt(keplerParams, source, simTime, position);
+            local = glm::dvec3(position[0], position[1], position[2]);
+            break;
+        }
+        case SELECT_EPHEMERIS:
+            local = equatorialToScene(ephemerisX[source], ephemerisY[source], ephemerisZ[source]) * ephemerisScales[source];
+            break;
+        default: // SELECT_DYNAMIC: already in world space (dynamic nodes are roots)
+            local = dynamicPositions[source];
+            break;
+        }
+        const int parent = selection.parentSlots[slot];
+        selection.positions[slot] = parent == NO_PARENT ? local : local + selection.positions[parent];
+    }
+}
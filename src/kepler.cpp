@@ -0,0 +1,233 @@
+/**
+ * @file kepler.cpp
+ * @brief Implements the KeplerBatch setup and the vectorized Kepler solver on top of simd_math.h.
+ */
+
+#include "kepler.h"
+#include "simd_math.h"  // SIMD backend + vectorized sincos
+#include "scene_frame.h" // Reference plane -> scene mapping
+
+#include <algorithm> // For std::clamp
+#include <cmath>     // For std::sin, std::cos, std::sqrt, std::remainder
+
+/**
+ * @brief Resizes every array, filling new (and padding) entries with a degenerate orbit
+ * (zero-length basis vectors, so the position is always the parent's).
+ */
+void KeplerBatch::resize(size_t n)
+{
+    size_t padded = (n + laneBlock - 1) / laneBlock * laneBlock;
+    meanMotion.resize(padded, 0);
+    meanAnomalyStart.resize(padded, 0);
+    eccentricity.resize(padded, 0.0f);
+    px.resize(padded, 0.0f);
+    py.resize(padded, 0.0f);
+    pz.resize(padded, 0.0f);
+    qx.resize(padded, 0.0f);
+    qy.resize(padded, 0.0f);
+    qz.resize(padded, 0.0f);
+    count = n;
+}
+
+/**
+ * @brief Unit vectors towards periapsis (P) and 90 degrees ahead of it in the orbital plane (Q),
+ * in scene coordinates.
+ */
+static void perifocalBasis(const KeplerElements &elements, double P[3], double Q[3])
+{
+    const double cosO = std::cos(elements.ascendingNode), sinO = std::sin(elements.ascendingNode);
+    const double cosW = std::cos(elements.argumentOfPeriapsis), sinW = std::sin(elements.argumentOfPeriapsis);
+    const double cosI = std::cos(elements.inclination), sinI = std::sin(elements.inclination);
+
+    // Perifocal basis in reference-plane coordinates (x: reference direction, y: 90 degrees
+    // ahead in the plane, z: north)
+    const double Px = cosW * cosO - sinW * sinO * cosI;
+    const double Py = cosW * sinO + sinW * cosO * cosI;
+    const double Pz = sinW * sinI;
+    const double Qx = -sinW * cosO - cosW * sinO * cosI;
+    const double Qy = -sinW * sinO + cosW * cosO * cosI;
+    const double Qz = cosW * sinI;
+
+    // Reference plane -> scene, as for every other orbit path
+    const glm::dvec3 p = referenceToScene(Px, Py, Pz), q = referenceToScene(Qx, Qy, Qz);
+    for (int k = 0; k < 3; ++k)
+    {
+        P[k] = p[k];
+        Q[k] = q[k];
+    }
+}
+
+/**
+ * @brief Stores one orbit. The orientation (i, Omega, omega) and the semi-axes are folded into
+ * the P and Q vectors here, in double precision, so the kernel only needs one sincos per orbit
+ * for the orientation-independent part.
+ */
+void KeplerBatch::set(size_t i, const KeplerElements &elements)
+{
+    const double a = elements.semiMajorAxis > 0.0f ? elements.semiMajorAxis : 0.0; // Non-positive axis means "no orbit"
+    const double e = std::clamp(static_cast<double>(elements.eccentricity), 0.0, static_cast<double>(MAX_ECCENTRICITY));
+    const double b = a * std::sqrt(1.0 - e * e);
+
+    double P[3], Q[3];
+    perifocalBasis(elements, P, Q);
+    px[i] = static_cast<float>(a * P[0]);
+    py[i] = static_cast<float>(a * P[1]);
+    pz[i] = static_cast<float>(a * P[2]);
+    qx[i] = static_cast<float>(b * Q[0]);
+    qy[i] = static_cast<float>(b * Q[1]);
+    qz[i] = static_cast<float>(b * Q[2]);
+    eccentricity[i] = static_cast<float>(e);
+    meanMotion[i] = phaseRateFromSpeed(elements.meanMotion);
+    meanAnomalyStart[i] = phaseFromAngle(elements.meanAnomalyAtEpoch);
+}
+
+/**
+ * @brief Branch-free Kepler solve for Simd::width lanes.
+ * Halley's method converges cubically: from Danby's starting guess the error is below float
+ * resolution after KEPLER_ITERATIONS steps for every M and e in range. Also returns sin(E)
+ * and cos(E) of the final iterate, which the position evaluation needs anyway.
+ */
+static inline simd::Simd solveKepler(simd::Simd M, simd::Simd e, simd::Simd &sinE, simd::Simd &cosE)
+{
+    using namespace simd;
+    const Simd one = set1(1.0f);
+    const Simd half = set1(0.5f);
+
+    // E0 = M + 0.85 * e * sign(M)
+    Simd sign = select(cmplt(M, set1(0.0f)), set1(-1.0f), one);
+    Simd E = fmadd(e * set1(0.85f), sign, M);
+
+    for (int iter = 0; iter < KEPLER_ITERATIONS; ++iter)
+    {
+        Simd s, c;
+        sincos(E, s, c);
+        Simd es = e * s;
+        Simd f = E - es - M;         // f(E)   = E - e sin E - M
+        Simd fp = fnmadd(e, c, one); // f'(E)  = 1 - e cos E (>= 1 - e > 0)
+        // Halley: dE = f / (f' - f f'' / (2 f')) = f f' / (f'^2 - f f'' / 2), with f'' = e sin E
+        Simd denominator = fnmadd(half * f, es, fp * fp);
+        E = E - (f * fp) / denominator;
+    }
+    sincos(E, sinE, cosE);
+    return E;
+}
+
+/**
+ * @brief Full vectors go straight through the solver; the tail is copied into a padded
+ * scratch block so the kernel never reads past the caller's arrays.
+ */
+void solveKeplerBatch(const float *meanAnomaly, const float *eccentricity, float *eccentricAnomaly, size_t count)
+{
+    using namespace simd;
+    constexpr size_t W = Simd::width;
+
+    size_t i = 0;
+    Simd s, c;
+    for (; i + W <= count; i += W)
+    {
+        store(eccentricAnomaly + i, solveKepler(load(meanAnomaly + i), load(eccentricity + i), s, c));
+    }
+    if (i < count)
+    {
+        alignas(32) float m[W] = {}, e[W] = {}, out[W];
+        for (size_t l = 0; l < count - i; ++l)
+        {
+            m[l] = meanAnomaly[i + l];
+            e[l] = eccentricity[i + l];
+        }
+        store(out, solveKepler(load(m), load(e), s, c));
+        for (size_t l = 0; l < count - i; ++l)
+        {
+            eccentricAnomaly[i + l] = out[l];
+        }
+    }
+}
+
+/**
+ * @brief Kernel body. Each iteration: fixed-point mean anomalies (scalar 64-bit arithmetic,
+ * already reduced to [-pi, pi)), one vector Kepler solve, then r = P*(cos E - e) + Q*sin E.
+ */
+void evaluateKeplerBatchRange(const KeplerBatch &batch, SimClock::Ticks simTime,
+                              float *outX, float *outY, float *outZ, size_t first, size_t last)
+{
+    using namespace simd;
+    constexpr int W = Simd::width;
+    static_assert(KeplerBatch::laneBlock % W == 0, "Lane block must be a multiple of the SIMD width");
+
+    const size_t count = last < batch.size() ? last : batch.size();
+    alignas(32) float meanAnomalies[W];
+
+    for (size_t base = first; base < count; base += W)
+    {
+        for (int l = 0; l < W; ++l)
+        {
+            meanAnomalies[l] = phaseAngle(batch.meanMotion[base + l], simTime, batch.meanAnomalyStart[base + l]);
+        }
+
+        Simd e = load(&batch.eccentricity[base]);
+        Simd sinE, cosE;
+        solveKepler(load(meanAnomalies), e, sinE, cosE);
+        Simd u = cosE - e; // Perifocal x / a
+
+        // Padding lanes have zero P and Q, so writing whole vectors is safe (arrays are padded)
+        store(outX + base, fmadd(load(&batch.px[base]), u, load(&batch.qx[base]) * sinE));
+        store(outY + base, fmadd(load(&batch.py[base]), u, load(&batch.qy[base]) * sinE));
+        store(outZ + base, fmadd(load(&batch.pz[base]), u, load(&batch.qz[base]) * sinE));
+    }
+}
+
+/**
+ * @brief Eccentric anomaly for mean anomaly @p M in [-pi, pi]: Newton's method in double
+ * precision from Danby's guess until converged.
+ */
+static double solveKeplerExact(double M, double e)
+{
+    double E = M + 0.85 * e * (M < 0.0 ? -1.0 : 1.0);
+    for (int iter = 0; iter < 50; ++iter)
+    {
+        double step = (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+        E -= step;
+        if (std::fabs(step) < 1e-15)
+            break;
+    }
+    return E;
+}
+
+/**
+ * @brief Newton's method in double precision until converged (only used at setup time), then
+ * r = a(cos E - e) P + b sin E Q and v = dE/dt * (-a sin E P + b cos E Q), dE/dt = n / (1 - e cos E).
+ */
+void keplerStateAt(const KeplerElements &elements, double meanMotion, double simSeconds,
+                   double position[3], double velocity[3])
+{
+    const double pi = 3.14159265358979323846;
+    const double a = elements.semiMajorAxis > 0.0f ? elements.semiMajorAxis : 0.0;
+    const double e = std::clamp(static_cast<double>(elements.eccentricity), 0.0, static_cast<double>(KeplerBatch::MAX_ECCENTRICITY));
+    const double b = a * std::sqrt(1.0 - e * e);
+
+    const double M = std::remainder(elements.meanAnomalyAtEpoch + meanMotion * simSeconds, 2.0 * pi); // [-pi, pi]
+    const double E = solveKeplerExact(M, e);
+
+    double P[3], Q[3];
+    perifocalBasis(elements, P, Q);
+    const double sinE = std::sin(E), cosE = std::cos(E);
+    const double rate = meanMotion / (1.0 - e * cosE);
+    for (int k = 0; k < 3; ++k)
+    {
+        position[k] = a * (cosE - e) * P[k] + b * sinE * Q[k];
+        velocity[k] = rate * (-a * sinE * P[k] + b * cosE * Q[k]);
+    }
+}
+
+/**
+ * @brief The batch's fixed-point mean anomaly and scaled basis, with E from solveKeplerExact().
+ */
+void keplerPositionAt(const KeplerBatch &batch, size_t i, SimClock::Ticks simTime, double position[3])
+{
+    const double e = batch.eccentricity[i];
+    const double E = solveKeplerExact(phaseAngleExact(batch.meanMotion[i], simTime, batch.meanAnomalyStart[i]), e);
+    const double cosTerm = std::cos(E) - e, sinE = std::sin(E);
+    position[0] = batch.px[i] * cosTerm + batch.qx[i] * sinE;
+    position[1] = batch.py[i] * cosTerm + batch.qy[i] * sinE;
+    position[2] = batch.pz[i] * cosTerm + batch.qz[i] * sinE;
+}
@@ -16,8 +16,19 @@
 #include "shader.h"   // For loading and managing GLSL shaders
 #include "camera.h"   // For managing the camera view and movement
 #include "config.h"   // For loading window/simulation settings
-#include "planet.h"   // Include full Planet definition BEFORE scenario.h
 #include "scenario.h" // For defining the celestial bodies and scene parameters
+#include "simulation.h"        // For the simulation core (hierarchy, N-body mode, clock)
+#include "sim_thread.h"        // For the fixed-timestep simulation thread
+#include "particle_renderer.h" // For drawing N-body particles
+#include "ring_renderer.h"     // For drawing planetary rings
+#include "body_renderer.h"     // For drawing the bodies from shared sphere meshes
+#include "gl_indirect.h"       // For the optional GL 4.3 multi-draw-indirect path
+#include "frame_data.h"        // For the per-frame uniform buffer
+#include "render_queue.h"      // For the sorted per-frame draw list
+#include "stream_buffer.h"     // For the persistent-mapped per-frame uploads
+#include "depth_mode.h"        // For the optional reverse-Z / logarithmic depth
+#include "scene_framebuffer.h" // For the 32-bit float depth buffer
+#include "headless_context.h"  // For the windowless EGL context of --headless
 
 #include "imgui.h"              // Immediate mode GUI library
 #include "imgui_impl_glfw.h"    // ImGui backend for GLFW
@@ -30,15 +41,15 @@
 #include <thread>    // For std::this_thread::sleep_for
 #include <chrono>    // For std::chrono::milliseconds
 #include <optional>  // For std::optional (used for parentName in CelestialBody)
-#include <map>       // For std::map (used to look up bodies by name)
 #include <algorithm> // For std::clamp, std::max, std::find, std::distance
+#include <cmath>     // For std::copysign, std::fabs
 
 // --- Function Prototypes ---
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
-unsigned int loadTexture(const char *path);
+unsigned int loadTextureArray(const std::vector<std::string> &paths);
 unsigned int loadCubemap(std::vector<std::string> faces);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 void lockCameraToBody(const std::string &name);
@@ -72,15 +83,21 @@ bool f11_pressed = false;
 int last_window_x = 100, last_window_y = 100, last_window_width = 1280, last_window_height = 720; // Windowed mode fallback
 
 // Simulation control
-float simulationSpeed = 1.0f;    // Multiplier for animation speed
-float accumulatedSimTime = 0.0f; // Tracks total simulation time elapsed, adjusted by speed
+double simulationWarp = 1.0;                 // Time warp factor (applied by the simulation thread)
+SimulationThread *simulationThread = nullptr; // The running simulation (owned by main), for seeking from input
+
+// Scene state shared with the input callbacks
+Scenario *activeScenario = nullptr;          // The loaded scenario (owned by main)
+const TransformHierarchy *bodyHierarchy = nullptr; // Flattened transform hierarchy of activeScenario (owned by the Simulation)
+std::vector<glm::mat4> bodyTransforms;       // Interpolated world matrix per hierarchy node, refreshed when it changes
+std::vector<glm::dvec3> bodyPositions;       // Interpolated world position per hierarchy node (double precision), refreshed with bodyTransforms
 
 // Camera locking state
-CelestialBody *cameraLockedTo = nullptr;        // Pointer to the body the camera is locked on, or nullptr
-std::string lockedBodyName = "None";            // Name of the locked body for display
-std::map<std::string, CelestialBody *> bodyMap; // Map for easy lookup of bodies by name
-std::vector<std::string> lockablePlanetNames;   // Order for cycling through planets with 'P' key
-int currentLockIndex = -1;                      // Index into lockablePlanetNames for cycling
+CelestialBody *cameraLockedTo = nullptr;      // Pointer to the body the camera is locked on, or nullptr
+int cameraLockedNode = -1;                    // Hierarchy node of the locked body (for its world transform)
+std::string lockedBodyName = "None";          // Name of the locked body for display
+std::vector<std::string> lockablePlanetNames; // Order for cycling through planets with 'P' key
+int currentLockIndex = -1;                    // Index into lockablePlanetNames for cycling
 
 // Locked camera parameters (orbit mode)
 float lockedCameraDistance = 10.0f;  // Distance from the locked body
@@ -115,17 +132,18 @@ float skyboxVertices[] = {
  */
 void lockCameraToBody(const std::string &name)
 {
-    auto it = bodyMap.find(name);
-    if (it != bodyMap.end())
+    int node = bodyHierarchy ? bodyHierarchy->findNode(name) : -1;
+    if (node >= 0)
     {
-        cameraLockedTo = it->second;
+        cameraLockedNode = node;
+        cameraLockedTo = &activeScenario->bodies[bodyHierarchy->bodyIndexOf(node)];
         lockedBodyName = name;
         lockedCameraDistance = cameraLockedTo->radius * 5.0f; // Set initial distance relative to body size
         camera.Zoom = ZOOM;                                   // Reset zoom (FOV) to default
 
         // Initialize orbit angles based on current camera view when locking
         // This makes the transition smoother
-        glm::vec3 direction = glm::normalize(camera.Position - glm::vec3(cameraLockedTo->currentModelMatrix[3]));
+        glm::vec3 direction = glm::normalize(glm::vec3(camera.Position - bodyPositions[cameraLockedNode]));
         lockedCameraOrbitYaw = glm::degrees(atan2(direction.z, direction.x));
         lockedCameraOrbitPitch = glm::degrees(asin(direction.y));
         lockedCameraOrbitPitch = std::clamp(lockedCameraOrbitPitch, -89.0f, 89.0f); // Prevent looking straight up/down initially
@@ -144,62 +162,104 @@ void lockCameraToBody(const std::string &name)
 }
 
 /**
- * @brief Main application function.
+ * @brief Main application function. See parseCommandLine() for the options.
  */
-int main()
+int main(int argc, char **argv)
 {
     // --- Initialization ---
+    LaunchOptions options;
+    if (!parseCommandLine(argc, argv, options))
+        return -1;
     config = loadConfig("config.ini");
-    SCR_WIDTH = config.width;
-    SCR_HEIGHT = config.height;
-    fullscreen = config.startFullscreen;
+    SCR_WIDTH = options.width > 0 ? options.width : config.width;
+    SCR_HEIGHT = options.height > 0 ? options.height : config.height;
+    fullscreen = config.startFullscreen && !options.headless;
+    if (options.warp)
+        simulationWarp = *options.warp;
     last_window_width = config.width;
     last_window_height = config.height; // Store initial windowed size
     lastX = SCR_WIDTH / 2.0f;
     lastY = SCR_HEIGHT / 2.0f; // Center mouse initially
 
-    // Initialize GLFW
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    const char *glsl_version = "#version 330 core";      // GLSL version for ImGui
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // Required on MacOS
-
-    // Create GLFW window (fullscreen or windowed based on config)
-    GLFWmonitor *monitor = glfwGetPrimaryMonitor();
-    const GLFWvidmode *mode = glfwGetVideoMode(monitor);
-    GLFWwindow *window;
-    if (fullscreen)
+    const char *glsl_version = "#version 330 core";           // GLSL version for ImGui
+    GLFWwindow *window = nullptr;                             // No window in the headless mode
+    std::unique_ptr<HeadlessContext> headless;                // Context of the headless mode (declared before every GL object, so released after them)
+    GLADloadproc loadProc = (GLADloadproc)glfwGetProcAddress; // OpenGL entry points of the context in use
+    if (options.headless)
     {
-        window = glfwCreateWindow(mode->width, mode->height, "Solar System", monitor, NULL);
-        SCR_WIDTH = mode->width;
-        SCR_HEIGHT = mode->height;
+        // Surfaceless EGL context: no display server or GPU needed (Mesa llvmpipe renders on
+        // the CPU), and every frame goes to the off-screen scene target
+        headless = std::make_unique<HeadlessContext>();
+        if (!(config.multiDrawIndirect && headless->create(4, 3)) && !headless->create(3, 3))
+        {
+            std::cerr << "Failed to create a headless OpenGL context" << std::endl;
+            return -1;
+        }
+        loadProc = (GLADloadproc)HeadlessContext::getProcAddress;
     }
     else
     {
-        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Solar System", NULL, NULL);
-    }
-    if (!window)
-    {
-        std::cerr << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
+        // Initialize GLFW
+        glfwInit();
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // Required on MacOS
+
+        // Create GLFW window (fullscreen or windowed based on config). A 4.3 context is tried
+        // first for multi-draw-indirect; where that fails (e.g. macOS) the 3.3 context is used.
+        GLFWmonitor *monitor = glfwGetPrimaryMonitor();
+        const GLFWvidmode *mode = glfwGetVideoMode(monitor);
+        auto createWindow = [&](int major, int minor) -> GLFWwindow *
+        {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+            if (fullscreen)
+            {
+                SCR_WIDTH = mode->width;
+                SCR_HEIGHT = mode->height;
+                return glfwCreateWindow(mode->width, mode->height, "Solar System", monitor, NULL);
+            }
+            return glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Solar System", NULL, NULL);
+        };
+        window = config.multiDrawIndirect ? createWindow(4, 3) : nullptr;
+        if (!window)
+            window = createWindow(3, 3);
+        if (!window)
+        {
+            std::cerr << "Failed to create GLFW window" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(window);
+        glfwGetWindowPos(window, &last_window_x, &last_window_y); // Store initial windowed position
     }
-    glfwMakeContextCurrent(window);
-    glfwGetWindowPos(window, &last_window_x, &last_window_y); // Store initial windowed position
 
     // Initialize GLAD (loads OpenGL function pointers)
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    if (!gladLoadGLLoader(loadProc))
     {
         std::cerr << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    const bool indirectDraws = config.multiDrawIndirect && loadIndirectDraw(loadProc);
+    const bool persistentStreams = loadBufferStorage(loadProc); // Before any StreamBuffer
+    const DepthMode depthMode = !config.reverseZ ? DepthMode::Standard
+                                : loadClipControl(loadProc) ? DepthMode::ReverseZ
+                                                             : DepthMode::Logarithmic;
 
-    // Enable VSync (limits framerate to monitor refresh rate)
-    glfwSwapInterval(1);
+    if (window)
+    {
+        // Enable VSync (limits framerate to monitor refresh rate)
+        glfwSwapInterval(1);
+    }
+    else
+    {
+        glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT); // No window, so no resize callback sets it
+    }
     // Enable depth testing for correct 3D rendering order
     glEnable(GL_DEPTH_TEST);
+    applyDepthMode(depthMode);
+    std::unique_ptr<SceneFramebuffer> sceneTarget; // Float depth buffer (all but the standard depth mode), the only target when headless
+    if (depthMode != DepthMode::Standard || options.headless)
+        sceneTarget = std::make_unique<SceneFramebuffer>();
 
     // Initialize Dear ImGui
     IMGUI_CHECKVERSION();
@@ -210,19 +270,69 @@ int main()
     io.MouseDrawCursor = false;                           // Don't let ImGui draw its own cursor
     io.ConfigFlags |= ImGuiConfigFlags_NoMouse;           // Disable mouse interaction for ImGui
     ImGui::StyleColorsDark();                             // Set ImGui theme
-    ImGui_ImplGlfw_InitForOpenGL(window, false);          // Init ImGui for GLFW (false = don't install callbacks automatically)
-    ImGui_ImplOpenGL3_Init(glsl_version);                 // Init ImGui for OpenGL 3
+    if (window)
+        ImGui_ImplGlfw_InitForOpenGL(window, false); // Init ImGui for GLFW (false = don't install callbacks automatically)
+    ImGui_ImplOpenGL3_Init(glsl_version);            // Init ImGui for OpenGL 3
 
     // Set GLFW callbacks (must be done AFTER ImGui init if install_callbacks=false)
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetKeyCallback(window, key_callback);
+    if (window)
+    {
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetKeyCallback(window, key_callback);
+    }
 
     // Load the scene description
-    Scenario currentScenario = loadScenario_SolarSystemBasic();
+    Scenario currentScenario;
+    if (config.scenario == "asteroid_belt")
+    {
+        currentScenario = loadScenario_AsteroidBelt(static_cast<size_t>(config.beltParticles));
+    }
+    else if (config.scenario == "ephemeris")
+    {
+        currentScenario = loadScenario_Ephemeris(config.ephemerisFile, config.ephemerisStartDays, config.ephemerisDaysPerSecond);
+    }
+    else
+    {
+        if (config.scenario != "solar_system")
+        {
+            std::cerr << "Warning: Unknown scenario '" << config.scenario << "', loading solar_system." << std::endl;
+        }
+        currentScenario = loadScenario_SolarSystemBasic();
+    }
 
-    // Populate lookup map and list for camera locking
+    // Simulation core: compiles the body tree once into a flat, parent-indexed hierarchy and
+    // sets up the N-body bodies and particles, if the scenario has any
+    SimulationSettings simulationSettings;
+    simulationSettings.workerThreads = static_cast<unsigned int>(std::max(config.workerThreads, 0));
+    simulationSettings.startTime = config.startTime;
+    NBodySettings &nbodySettings = simulationSettings.nbody;
+    if (config.nbodyIntegrator == "yoshida4")
+    {
+        nbodySettings.integrator = Integrator::Yoshida4;
+    }
+    else if (config.nbodyIntegrator != "leapfrog")
+    {
+        std::cerr << "Warning: Unknown N-body integrator '" << config.nbodyIntegrator << "', using leapfrog." << std::endl;
+    }
+    nbodySettings.timestep = config.nbodyTimestep;
+    nbodySettings.maxSubsteps = config.nbodyMaxSubsteps;
+    nbodySettings.maxLevels = config.nbodyMaxLevels;
+    nbodySettings.accuracy = config.nbodyAccuracy;
+    nbodySettings.theta = config.nbodyTheta;
+    nbodySettings.softening = config.nbodySoftening;
+    Simulation simulationCore(currentScenario, simulationSettings);
+    const TransformHierarchy &hierarchy = simulationCore.hierarchy();
+    activeScenario = &currentScenario;
+    bodyHierarchy = &hierarchy;
+
+    // Fixed-rate simulation thread; the render loop interpolates its latest snapshot
+    SimulationThread simulation(simulationCore, config.tickRate);
+    simulationThread = &simulation;
+    simulation.latest().interpolate(SimulationThread::clockSeconds(), bodyTransforms, bodyPositions);
+
+    // Populate list for camera locking
     // Define the order for the 'P' key cycle
     lockablePlanetNames.push_back("Mercury");
     lockablePlanetNames.push_back("Venus");
@@ -231,38 +341,83 @@ int main()
     lockablePlanetNames.push_back("Saturn");
     lockablePlanetNames.push_back("Uranus");
     lockablePlanetNames.push_back("Neptune");
-    // Build the name->pointer map for fast lookups
-    for (auto &body : currentScenario.bodies)
-    {
-        bodyMap[body.name] = &body;
-    }
 
     // Set initial camera position from scenario
-    camera.Position = currentScenario.initialCameraPos;
+    camera.Position = glm::dvec3(currentScenario.initialCameraPos);
     camera.updateCameraVectors(); // Ensure camera vectors are consistent
+    if (!options.lockBody.empty())
+    {
+        if (hierarchy.findNode(options.lockBody) < 0)
+            std::cerr << "Warning: Body '" << options.lockBody << "' to lock the camera to not found." << std::endl;
+        lockCameraToBody(options.lockBody);
+    }
 
-    // Load shaders
-    Shader lightingShader("shaders/lighting.vert", "shaders/lighting.frag"); // For planets
-    Shader emissiveShader("shaders/emissive.vert", "shaders/emissive.frag"); // For the Sun
-    Shader skyboxShader("shaders/skybox.vert", "shaders/skybox.frag");       // For the background
-
-    // Load textures for celestial bodies
-    stbi_set_flip_vertically_on_load(true); // Tell stb_image to flip textures vertically (OpenGL expects 0,0 at bottom-left)
-    for (auto &body : currentScenario.bodies)
+    // Load shaders (every one in the variant of the depth mode)
+    const std::string depthDefines = depthShaderDefines(depthMode);
+    Shader lightingShader("shaders/lighting.vert", "shaders/lighting.frag", depthDefines);                                  // For all bodies (instanced; the Sun unlit)
+    Shader lightingUniformShader("shaders/lighting.vert", "shaders/lighting.frag", depthDefines + "#define UNIFORM_SCALE\n"); // Same, while no body is scaled non-uniformly
+    Shader skyboxShader("shaders/skybox.vert", "shaders/skybox.frag", depthDefines);                                        // For the background
+    Shader particleShader("shaders/particle.vert", "shaders/particle.frag", depthDefines);                                  // For N-body particles
+    Shader ringShader("shaders/ring.vert", "shaders/particle.frag", depthDefines);                                          // For planetary rings (same round points)
+
+    // Particle buffers (sizes and styles are fixed; positions are uploaded per simulation tick)
+    ParticleRenderer particles(simulationCore.particleStyles());
+    particles.upload(simulation.latest().particlesPrevious, simulation.latest().particleOriginPrevious,
+                     simulation.latest().particles, simulation.latest().particleOrigin);
+    // Snapshot versions held by the particle buffers (unchanged particles are not re-uploaded)
+    unsigned long long uploadedParticleVersion = simulation.latest().particleVersion;
+    unsigned long long uploadedPreviousParticleVersion = simulation.latest().previousParticleVersion;
+    glEnable(GL_PROGRAM_POINT_SIZE); // Point size comes from the particle shader
+
+    // Version of bodyTransforms, so unchanged transforms are not re-interpolated or re-uploaded
+    const unsigned long long NOT_SETTLED = ~0ull;
+    unsigned long long displayedTransformVersion = NOT_SETTLED; // Version bodyTransforms holds, once settled
+
+    // Planetary rings (generated on the GPU; only the parent's node is looked up here)
+    std::vector<std::unique_ptr<RingRenderer>> rings;
+    std::vector<int> ringNodes;
+    for (const ParticleRing &ring : currentScenario.rings)
     {
-        if (!body.mesh)
+        int node = hierarchy.findNode(ring.parentName);
+        if (node < 0)
         {
-            std::cerr << "Error: Mesh not created for " << body.name << std::endl;
-            return -1;
-        }
-        body.textureID = loadTexture(body.texturePath.c_str());
-        if (body.textureID == 0)
-        {
-            std::cerr << "Error: Failed texture load for " << body.name << std::endl;
-            return -1;
+            std::cerr << "Warning: Parent '" << ring.parentName << "' of a ring not found, skipping the ring." << std::endl;
+            continue;
         }
+        const CelestialBody &parent = currentScenario.bodies[hierarchy.bodyIndexOf(node)];
+        rings.push_back(std::make_unique<RingRenderer>(ring, parent.rotationAxis));
+        ringNodes.push_back(node);
+    }
+
+    // Load the textures for the celestial bodies: one layer per distinct file, all in one array texture
+    std::vector<std::string> texturePaths;
+    for (auto &body : currentScenario.bodies)
+    {
+        auto pathIt = std::find(texturePaths.begin(), texturePaths.end(), body.texturePath);
+        body.textureLayer = static_cast<unsigned int>(std::distance(texturePaths.begin(), pathIt));
+        if (pathIt == texturePaths.end())
+            texturePaths.push_back(body.texturePath);
+    }
+    stbi_set_flip_vertically_on_load(true); // Tell stb_image to flip textures vertically (OpenGL expects 0,0 at bottom-left)
+    unsigned int bodyTextures = loadTextureArray(texturePaths);
+    if (bodyTextures == 0)
+    {
+        std::cerr << "Error: Failed to load the body textures" << std::endl;
+        return -1;
     }
 
+    // Every body is a unit sphere scaled by its model matrix: a chain of sphere meshes from 8x8
+    // to 256x256, all in shared buffers, and every body (lit or emissive) an instance of the
+    // level its size on screen calls for
+    std::vector<BodyInstance> bodyInstances;
+    for (int node = 0; node < static_cast<int>(hierarchy.size()); ++node)
+    {
+        const CelestialBody &body = currentScenario.bodies[hierarchy.bodyIndexOf(node)];
+        bodyInstances.push_back({node, body.textureLayer, body.isEmissive});
+    }
+    auto bodyRenderer = std::make_unique<BodyRenderer>(Planet::lodChain(8, 256), indirectDraws, config.lodPixelError);
+    bodyRenderer->setInstances(bodyInstances);
+
     // Set up skybox VAO and VBO
     unsigned int skyboxVAO, skyboxVBO;
     glGenVertexArrays(1, &skyboxVAO);
@@ -284,36 +439,61 @@ int main()
     stbi_set_flip_vertically_on_load(true); // Flip back for regular textures
 
     // Set initial texture units for shaders
-    lightingShader.use();
-    lightingShader.setInt("ourTexture", 0); // Use texture unit 0
-    emissiveShader.use();
-    emissiveShader.setInt("ourTexture", 0); // Use texture unit 0
+    for (Shader *shader : {&lightingShader, &lightingUniformShader})
+    {
+        shader->use();
+        shader->setInt("ourTexture", 0); // Use texture unit 0
+    }
     skyboxShader.use();
     skyboxShader.setInt("skybox", 0); // Use texture unit 0
 
-    // Initialize timing and lighting variables
-    lastTimeForFPS = glfwGetTime();
+    // Camera and light values reach every shader through one uniform buffer, written once per frame
+    FrameDataBuffer frameData;
+    RenderQueue renderQueue;        // Every draw of a frame, sorted by state (see render_queue.h)
+    const float farPlane = 1000.0f; // Increased far plane for larger scene (standard depth only; also the depth key range)
+    for (const Shader *shader : {&lightingShader, &lightingUniformShader, &skyboxShader, &particleShader, &ringShader})
+    {
+        shader->bindUniformBlock("FrameData", FrameDataBuffer::BINDING);
+    }
+
+    // Handles to the remaining per-draw uniforms, looked up once so the render loop does no string work
+    const Uniform<float> particleAlpha = particleShader.uniform<float>("alpha");
+    const Uniform<glm::vec3> particlePreviousOrigin = particleShader.uniform<glm::vec3>("previousOrigin");
+    const Uniform<glm::vec3> particleCurrentOrigin = particleShader.uniform<glm::vec3>("currentOrigin");
+    const RingRenderer::Uniforms ringUniforms(ringShader);
+
+    // Initialize timing and lighting variables (without GLFW, seconds since this point)
+    const double clockStart = SimulationThread::clockSeconds();
+    auto currentTime = [&]()
+    { return window ? glfwGetTime() : SimulationThread::clockSeconds() - clockStart; };
+    lastTimeForFPS = currentTime();
     lastFrame = (float)lastTimeForFPS;
-    accumulatedSimTime = (float)lastTimeForFPS; // Start simulation time from current time
     glm::vec3 lightPos = currentScenario.lightPos;
     glm::vec3 lightColor = currentScenario.lightColor;
 
     // Hide and capture the mouse cursor
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (window)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // Headless frames can only go to the scene target
+    if (!window && !sceneTarget->resize(SCR_WIDTH, SCR_HEIGHT))
+        return -1;
 
     // --- Main Render Loop ---
-    while (!glfwWindowShouldClose(window))
+    // Runs until the window is closed, or until the frame or time limit of the command line
+    int framesRendered = 0;
+    const double runStart = currentTime();
+    simulation.start();
+    while (!window || !glfwWindowShouldClose(window))
     {
         // --- Timing ---
-        double currentFrameTime = glfwGetTime();
+        double currentFrameTime = currentTime();
         deltaTime = (float)currentFrameTime - lastFrame;
         lastFrame = (float)currentFrameTime;
-        float simDeltaTime = deltaTime * simulationSpeed; // Time step adjusted by simulation speed
-        accumulatedSimTime += simDeltaTime;               // Accumulate simulation time
 
         // Calculate and display FPS in window title once per second
         nbFrames++;
-        if (currentFrameTime - lastTimeForFPS >= 1.0)
+        if (window && currentFrameTime - lastTimeForFPS >= 1.0)
         {
             std::string title = "Solar System - FPS: " + std::to_string(nbFrames);
             glfwSetWindowTitle(window, title.c_str());
@@ -322,40 +502,85 @@ int main()
         }
 
         // --- Input ---
-        glfwPollEvents();     // Check for window events (close, resize, etc.)
-        processInput(window); // Handle keyboard input for camera/simulation
+        if (window)
+        {
+            glfwPollEvents();     // Check for window events (close, resize, etc.)
+            processInput(window); // Handle keyboard input for camera/simulation
+        }
 
         // --- ImGui Frame Setup ---
         ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
+        if (window)
+        {
+            ImGui_ImplGlfw_NewFrame();
+        }
+        else
+        {
+            io.DisplaySize = ImVec2((float)SCR_WIDTH, (float)SCR_HEIGHT); // What the GLFW backend would set
+            io.DeltaTime = std::max(deltaTime, 1e-6f);                    // Must be positive
+        }
         ImGui::NewFrame();
 
         // --- Clear Buffers ---
+        // With a float depth buffer, and always when headless, the scene goes to the off-screen
+        // target (the window keeps the default one while minimized)
+        const bool offscreen = sceneTarget && sceneTarget->resize(SCR_WIDTH, SCR_HEIGHT);
+        if (offscreen)
+            sceneTarget->bind();
         glClearColor(0.01f, 0.01f, 0.01f, 1.0f); // Dark background
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // --- Update Transforms ---
+        // Pick up the newest simulation tick (never blocks) and interpolate it to "now".
+        // Done before the camera so a locked camera follows the body's current position.
+        // While the simulation is paused (or nothing moved) the snapshot is settled and its
+        // version unchanged, so interpolation, instance and particle uploads are skipped.
+        simulation.setWarp(simulationWarp);
+        const bool newTick = simulation.acquireLatest();
+        const SimSnapshot &snapshot = simulation.latest();
+        if (newTick && (snapshot.particleVersion != uploadedParticleVersion || snapshot.previousParticleVersion != uploadedPreviousParticleVersion))
+        {
+            particles.upload(snapshot.particlesPrevious, snapshot.particleOriginPrevious, // Only on new, changed ticks
+                             snapshot.particles, snapshot.particleOrigin);
+            uploadedParticleVersion = snapshot.particleVersion;
+            uploadedPreviousParticleVersion = snapshot.previousParticleVersion;
+        }
+        const double frameClock = SimulationThread::clockSeconds();
+        size_t transformsRecomputed = 0; // Interpolated transforms this frame (shown in the overlay)
+        if (!snapshot.settled() || snapshot.transformVersion != displayedTransformVersion)
+        {
+            snapshot.interpolate(frameClock, bodyTransforms, bodyPositions);
+            bodyRenderer->updateTransforms(bodyTransforms, bodyPositions);
+            transformsRecomputed = bodyTransforms.size();
+            displayedTransformVersion = snapshot.settled() ? snapshot.transformVersion : NOT_SETTLED;
+        }
+
         // --- Camera Update ---
-        glm::vec3 currentCameraTargetPos = glm::vec3(0.0f); // World position of the locked body
+        // Positions are double precision; the view matrix is camera-relative (no translation),
+        // so a locked camera stays steady at any distance from the origin
+        glm::dvec3 currentCameraTargetPos = glm::dvec3(0.0); // World position of the locked body
         glm::mat4 view;
         if (cameraLockedTo)
         {
             // Camera is locked - calculate orbit position and view matrix
-            currentCameraTargetPos = glm::vec3(cameraLockedTo->currentModelMatrix[3]); // Get target's world position
+            currentCameraTargetPos = bodyPositions[cameraLockedNode]; // Get target's world position
 
             // Adjust distance based on scroll wheel input (clamped)
             lockedCameraDistance = std::clamp(lockedCameraDistance, cameraLockedTo->radius * 1.5f, 50.0f * cameraLockedTo->radius);
 
-            // Calculate camera position in spherical coordinates around the target
-            float camX = currentCameraTargetPos.x + lockedCameraDistance * cos(glm::radians(lockedCameraOrbitPitch)) * cos(glm::radians(lockedCameraOrbitYaw));
-            float camY = currentCameraTargetPos.y + lockedCameraDistance * sin(glm::radians(lockedCameraOrbitPitch));
-            float camZ = currentCameraTargetPos.z + lockedCameraDistance * cos(glm::radians(lockedCameraOrbitPitch)) * sin(glm::radians(lockedCameraOrbitYaw));
-            camera.Position = glm::vec3(camX, camY, camZ); // Set the camera's position
+            // Calculate the camera's offset from the target in spherical coordinates (small, so
+            // float is exact enough); only the sum with the target's position needs double
+            float camX = lockedCameraDistance * cos(glm::radians(lockedCameraOrbitPitch)) * cos(glm::radians(lockedCameraOrbitYaw));
+            float camY = lockedCameraDistance * sin(glm::radians(lockedCameraOrbitPitch));
+            float camZ = lockedCameraDistance * cos(glm::radians(lockedCameraOrbitPitch)) * sin(glm::radians(lockedCameraOrbitYaw));
+            const glm::vec3 orbitOffset(camX, camY, camZ);
+            camera.Position = currentCameraTargetPos + glm::dvec3(orbitOffset); // Set the camera's position
 
-            // Create the view matrix looking at the target
-            view = glm::lookAt(camera.Position, currentCameraTargetPos, camera.WorldUp);
+            // Create the camera-relative view matrix looking at the target
+            view = glm::lookAt(glm::vec3(0.0f), -orbitOffset, camera.WorldUp);
 
             // Update camera's internal orientation vectors to match the locked view
-            camera.Front = glm::normalize(currentCameraTargetPos - camera.Position);
+            camera.Front = glm::normalize(-orbitOffset);
             camera.Right = glm::normalize(glm::cross(camera.Front, camera.WorldUp));
             camera.Up = glm::normalize(glm::cross(camera.Right, camera.Front));
             // Recalculate Yaw/Pitch from the Front vector for consistency if needed later
@@ -364,111 +589,103 @@ int main()
         }
         else
         {
-            // Camera is in free-fly mode - get view matrix from camera object directly
+            // Camera is in free-fly mode - get the (camera-relative) view matrix from the camera object
             view = camera.GetViewMatrix();
         }
 
-        // Calculate projection matrix (perspective)
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 1000.0f); // Increased far plane for larger scene
-
-        // --- Render Celestial Bodies ---
-        for (auto &body : currentScenario.bodies)
+        // Calculate projection matrix (perspective; without a far plane outside the standard depth mode)
+        glm::mat4 projection = depthProjection(depthMode, glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, farPlane);
+
+        // --- Per-Frame Uniforms ---
+        // One upload shared by every shader (FrameData block); positions are camera-relative
+        FrameData frame;
+        frame.projection = projection;
+        frame.view = view;
+        frame.lightPos = glm::vec4(glm::vec3(glm::dvec3(lightPos) - camera.Position), 1.0f); // Position of the light source (Sun)
+        frame.viewPos = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);                                    // Camera's position for specular highlights
+        frame.lightColor = glm::vec4(lightColor, 1.0f);                                       // Color of the light
+        frameData.update(frame);
+
+        // --- Collect Draws ---
+        // Every draw goes into the queue with the program, texture and vertex array it needs;
+        // execute() sorts them so each state is set once, opaque draws front to back
+        renderQueue.begin(farPlane);
+
+        // Every visible body at the detail its size on screen needs: one multi-draw (GL 4.3) or
+        // one instanced draw per detail level (GL 3.3), with each draw's instances ordered nearest first
+        bodyRenderer->prepareFrame(Frustum::fromMatrix(projection * view), camera.Position, projection[1][1] * 0.5f * SCR_HEIGHT);
+        const Shader &bodyShader = bodyRenderer->uniformScale() ? lightingUniformShader : lightingShader;
+        bodyRenderer->enqueue(renderQueue, bodyShader.ID, bodyTextures);
+
+        // N-body particles: spread over the whole belt, so drawn after the bodies
+        if (particles.size() > 0)
         {
-            // Calculate Model Matrix for the current body
-            glm::mat4 model = glm::mat4(1.0f);
-            glm::mat4 orbitTranslation = glm::mat4(1.0f);
-            glm::mat4 rotation = glm::mat4(1.0f);
-
-            // Apply orbit if applicable
-            if (body.orbitRadius > 0.0f)
-            {
-                float orbitAngle = accumulatedSimTime * body.orbitSpeed;
-                orbitTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(cos(orbitAngle) * body.orbitRadius, 0.0f, sin(orbitAngle) * body.orbitRadius));
-            }
-            // Apply rotation
-            rotation = glm::rotate(glm::mat4(1.0f), accumulatedSimTime * body.rotationSpeed, glm::normalize(body.rotationAxis));
-
-            // --- Hierarchical Transformation ---
-            // Calculate the body's final world position and build its model matrix
-            glm::vec3 parentPosition = glm::vec3(0.0f);
-            // If the body has a parent...
-            if (body.parentName)
-            {
-                // ...find the parent's current world matrix
-                auto it = bodyMap.find(*body.parentName);
-                if (it != bodyMap.end())
-                {
-                    // Extract only the translation (position) part of the parent's matrix
-                    // This prevents the parent's scale/rotation from affecting the child's orbital distance
-                    parentPosition = glm::vec3(it->second->currentModelMatrix[3]);
-                }
-            }
-
-            // Calculate the final world position: Parent's Position + Orbital Offset
-            glm::vec3 finalPosition = parentPosition + glm::vec3(orbitTranslation * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-
-            // Construct the final model matrix for this body:
-            // 1. Translate to the final world position
-            // 2. Apply its own rotation around its center
-            // 3. Apply its own scale
-            model = glm::translate(glm::mat4(1.0f), finalPosition);
-            model = model * rotation;                          // Apply self-rotation after translation
-            model = glm::scale(model, glm::vec3(body.radius)); // Apply self-scaling last
-
-            // Store the calculated world matrix for use by children or camera locking
-            body.currentModelMatrix = model;
-            // --- End Hierarchical Transformation ---
-
-            // Select the appropriate shader (emissive or lighting)
-            Shader &currentShader = body.isEmissive ? emissiveShader : lightingShader;
-            currentShader.use();
-
-            // Set common uniforms
-            currentShader.setMat4("projection", projection);
-            currentShader.setMat4("view", view);
-            currentShader.setMat4("model", model);
-
-            // Set lighting-specific uniforms only for non-emissive bodies
-            if (!body.isEmissive)
-            {
-                lightingShader.setVec3("lightPos", lightPos);       // Position of the light source (Sun)
-                lightingShader.setVec3("viewPos", camera.Position); // Camera's position for specular highlights
-                lightingShader.setVec3("lightColor", lightColor);   // Color of the light
-
-                // Calculate and set the normal matrix (for correct lighting on scaled/rotated objects)
-                glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
-                lightingShader.setMat3("normalMatrix", normalMatrix);
-            }
-
-            // Bind the texture
-            glActiveTexture(GL_TEXTURE0); // Activate texture unit 0
-            glBindTexture(GL_TEXTURE_2D, body.textureID);
+            // Particle positions are float offsets from a per-tick origin; the camera's offset from
+            // each origin is formed in double, so the shader only adds small vectors
+            const float particleBlend = snapshot.blendFactor(frameClock);
+            glm::vec3 previousOffset, currentOffset;
+            particles.offsets(camera.Position, previousOffset, currentOffset);
+            renderQueue.submit(RenderPass::Opaque, particleShader.ID, 0, 0, particles.vertexArray(), 0, farPlane,
+                               [&, particleBlend, previousOffset, currentOffset]()
+                               {
+                                   particleShader.set(particleAlpha, particleBlend);
+                                   particleShader.set(particlePreviousOrigin, previousOffset);
+                                   particleShader.set(particleCurrentOrigin, currentOffset);
+                                   particles.draw();
+                               });
+        }
 
-            // Draw the mesh
-            if (body.mesh)
-            {
-                body.mesh->draw(); // Call draw method on the Planet object managed by unique_ptr
-            }
+        // Planetary rings, at the distance of their nearest edge
+        const SimClock::Ticks ringTime = snapshot.interpolatedTicks(frameClock);
+        for (size_t r = 0; r < rings.size(); ++r)
+        {
+            const glm::vec3 center = glm::vec3(bodyPositions[ringNodes[r]] - camera.Position); // Camera-relative
+            const float depth = glm::length(center) - rings[r]->radius();
+            renderQueue.submit(RenderPass::Opaque, ringShader.ID, 0, 0, rings[r]->vertexArray(), 0, depth,
+                               [&, r, center]()
+                               { rings[r]->draw(ringShader, ringUniforms, center, ringTime); });
         }
 
-        // --- Render Skybox ---
-        glDepthFunc(GL_LEQUAL); // Change depth function so depth test passes when values are equal to depth buffer's content
-        skyboxShader.use();
-        glm::mat4 skyboxView = glm::mat4(glm::mat3(view)); // Remove translation from the view matrix
-        skyboxShader.setMat4("view", skyboxView);
-        skyboxShader.setMat4("projection", projection);
-        // Draw skybox cube
-        glBindVertexArray(skyboxVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
-        glDepthFunc(GL_LESS); // Set depth function back to default
+        // Skybox last, where nothing else was drawn (the shader removes the translation from the view matrix)
+        renderQueue.submit(RenderPass::Sky, skyboxShader.ID, GL_TEXTURE_CUBE_MAP, cubemapTexture, skyboxVAO, 0, farPlane,
+                           [depthMode]()
+                           {
+                               glDepthFunc(skyDepthFunc(depthMode)); // Depth test passes when values are equal to depth buffer's content
+                               glDrawArrays(GL_TRIANGLES, 0, 36);
+                               glDepthFunc(sceneDepthFunc(depthMode)); // Set depth function back to default
+                           });
+
+        // --- Render ---
+        renderQueue.execute();
+        if (offscreen && window)
+            sceneTarget->present(); // The overlay is drawn on the window directly (headless: on the scene target)
 
         // --- Render ImGui UI ---
         ImGui::Begin("Controls");
-        ImGui::Text("Sim Speed: %.1fx (Keys 0-4)", simulationSpeed);
+        ImGui::Text("Time Warp: %.4gx (Keys 0-4, [ ], , .)", simulationWarp);
+        ImGui::Text("Sim Time: %.1f s (Home: Reset, PgUp/PgDn: Jump)", snapshot.simTime);
         ImGui::Text("Cam Lock: %s (Keys E,M,P,N)", lockedBodyName.c_str());
+        ImGui::Text("Transforms recomputed: %zu/tick, %zu/frame", snapshot.transformsRecomputed, transformsRecomputed);
+        ImGui::Text("Bodies: %zu visible, %zu culled (%s)", bodyRenderer->visibleCount(),
+                    bodyRenderer->instanceCount() - bodyRenderer->visibleCount(), cullKernelBackend());
+        ImGui::Text("Body draw calls: %zu for %zu bodies (%s)", bodyRenderer->drawCalls(), bodyRenderer->visibleCount(),
+                    bodyRenderer->usesIndirect() ? "multi-draw-indirect" : "instanced");
+        ImGui::Text("Body triangles: %zu", bodyRenderer->triangleCount());
+        ImGui::Text("Depth: %s", depthModeName(depthMode));
+        const StreamStats &streamStats = StreamBuffer::totals();
+        ImGui::Text("Streaming: %s, %zu uploads, %zu stalls (%.2f ms)", persistentStreams ? "persistent-mapped" : "orphaned",
+                    streamStats.writes, streamStats.stalls, streamStats.stallMs);
+        const RenderStats &queueStats = renderQueue.stats();
+        ImGui::Text("State changes: %zu programs, %zu textures, %zu VAOs for %zu draws (unsorted: %zu, %zu, %zu)",
+                    queueStats.programChanges, queueStats.textureBinds, queueStats.vertexArrayBinds, queueStats.items,
+                    queueStats.unsortedProgramChanges, queueStats.unsortedTextureBinds, queueStats.unsortedVertexArrayBinds);
+        if (simulationCore.hasNBody())
+        {
+            const NBodyStats &stats = snapshot.nbodyStats;
+            ImGui::Text("N-Body: %zu bodies, %zu particles | %d steps/tick, %d levels, %d evals, %.2f ms/force, %.2f ms/tick",
+                        stats.bodies, stats.particles, stats.substeps, stats.deepestLevel, stats.evaluations, stats.forceMs, stats.totalMs);
+            ImGui::Text("Energy drift: %.2e", stats.energyDrift);
+        }
         ImGui::Separator();
         ImGui::Text("WASD: Move | Spc/Shft: Up/Dn | Ctrl: Sprint");
         ImGui::Text("Mouse: Look/Orbit | Scroll: Zoom");
@@ -481,28 +698,46 @@ int main()
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         // --- Swap Buffers and Poll Events ---
-        glfwSwapBuffers(window);
+        if (window)
+            glfwSwapBuffers(window);
+
+        // Command-line limits
+        ++framesRendered;
+        if ((options.frames > 0 && framesRendered >= options.frames) ||
+            (options.duration > 0.0 && currentTime() - runStart >= options.duration))
+            break;
 
     } // End of main render loop
+    simulation.stop();
+    simulationThread = nullptr;
+
+    // Headless runs report their frame rate and can save the last frame
+    if (!window)
+    {
+        glFinish(); // Wait for the last frame, so the time includes all rendering
+        const double seconds = currentTime() - runStart;
+        std::cout << "Rendered " << framesRendered << " frames at " << SCR_WIDTH << "x" << SCR_HEIGHT << " in " << seconds
+                  << " s (" << 1000.0 * seconds / std::max(framesRendered, 1) << " ms/frame, " << depthModeName(depthMode) << " depth)" << std::endl;
+        if (!options.outputFile.empty() && sceneTarget->writePPM(options.outputFile))
+            std::cout << "Wrote " << options.outputFile << std::endl;
+    }
 
     // --- Cleanup ---
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (window)
+        ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
     // Delete OpenGL objects
     glDeleteVertexArrays(1, &skyboxVAO);
     glDeleteBuffers(1, &skyboxVBO);
     glDeleteTextures(1, &cubemapTexture);
-    for (auto &body : currentScenario.bodies)
-    {
-        if (body.textureID != 0)
-            glDeleteTextures(1, &body.textureID);
-        // Note: body.mesh unique_ptr will automatically delete the Planet object and its GL buffers
-    }
+    glDeleteTextures(1, &bodyTextures);
+    bodyRenderer.reset(); // Delete the sphere and instance buffers while the context still exists
 
-    // Terminate GLFW
-    glfwTerminate();
+    // Terminate GLFW (the headless context is released when it goes out of scope)
+    if (window)
+        glfwTerminate();
     return 0;
 }
 
@@ -515,60 +750,120 @@ int main()
 #endif
 
 /**
- * @brief Loads a 2D texture from file using stb_image.
- * @param path Path to the texture file.
- * @return OpenGL texture ID, or 0 on failure.
+ * @brief Bilinearly resamples an RGB image to @p width x @p height. Columns wrap around (a body
+ * texture's U coordinate goes once around the sphere); rows are clamped at the poles.
  */
-unsigned int loadTexture(char const *path)
+static std::vector<unsigned char> resampleRGB(const unsigned char *pixels, int srcWidth, int srcHeight, int width, int height)
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+    std::vector<unsigned char> resampled(static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; ++y)
+    {
+        const float sy = std::clamp((y + 0.5f) * srcHeight / height - 0.5f, 0.0f, static_cast<float>(srcHeight - 1));
+        const int y0 = static_cast<int>(sy), y1 = std::min(y0 + 1, srcHeight - 1);
+        const float fy = sy - y0;
+        for (int x = 0; x < width; ++x)
+        {
+            const float sx = (x + 0.5f) * srcWidth / width - 0.5f + srcWidth; // Shifted by one width to stay positive
+            const int x0 = static_cast<int>(sx) % srcWidth, x1 = (x0 + 1) % srcWidth;
+            const float fx = sx - static_cast<int>(sx);
+            for (int c = 0; c < 3; ++c)
+            {
+                const float p00 = pixels[(static_cast<size_t>(y0) * srcWidth + x0) * 3 + c];
+                const float p01 = pixels[(static_cast<size_t>(y0) * srcWidth + x1) * 3 + c];
+                const float p10 = pixels[(static_cast<size_t>(y1) * srcWidth + x0) * 3 + c];
+                const float p11 = pixels[(static_cast<size_t>(y1) * srcWidth + x1) * 3 + c];
+                const float top = p00 + (p01 - p00) * fx, bottom = p10 + (p11 - p10) * fx;
+                resampled[(static_cast<size_t>(y) * width + x) * 3 + c] = static_cast<unsigned char>(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+    return resampled;
+}
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format = GL_RGB; // Default format
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-        else
+/**
+ * @brief Loads 2D textures into the layers of one OpenGL array texture, so every body is drawn
+ * with a single texture binding. Layers take the size of the largest image (limited to
+ * GL_MAX_TEXTURE_SIZE); images of another size are resampled to it.
+ * @param paths Path of each layer's texture file, in layer order.
+ * @return OpenGL texture array ID, or 0 on failure.
+ */
+unsigned int loadTextureArray(const std::vector<std::string> &paths)
+{
+    // Decode every image first: the layer size is only known once all are loaded
+    struct Image
+    {
+        int width, height;
+        std::vector<unsigned char> rgb;
+    };
+    std::vector<Image> images;
+    int layerWidth = 0, layerHeight = 0;
+    for (const std::string &path : paths)
+    {
+        int width, height, nrComponents;
+        unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrComponents, 3); // Always RGB (body textures are opaque)
+        if (!data)
         {
-            std::cerr << "Texture format error: Unsupported number of components (" << nrComponents << ") in " << path << std::endl;
-            stbi_image_free(data);
-            glDeleteTextures(1, &textureID); // Clean up allocated texture ID
+            std::cerr << "Texture load failure: Failed to load texture at path: " << path << std::endl;
             return 0;
         }
+        images.push_back({width, height, std::vector<unsigned char>(data, data + static_cast<size_t>(width) * height * 3)});
+        stbi_image_free(data); // Free the loaded image data from CPU memory
+        layerWidth = std::max(layerWidth, width);
+        layerHeight = std::max(layerHeight, height);
+    }
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D); // Generate mipmaps for better quality at distance
-
-        // Set texture wrapping and filtering options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // Trilinear filtering
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);               // Bilinear filtering
+    GLint maxSize = 0, maxLayers = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (images.empty() || static_cast<GLint>(images.size()) > maxLayers)
+    {
+        std::cerr << "Texture array error: " << images.size() << " layers requested, 1 to " << maxLayers << " supported" << std::endl;
+        return 0;
+    }
+    layerWidth = std::min(layerWidth, static_cast<int>(maxSize));
+    layerHeight = std::min(layerHeight, static_cast<int>(maxSize));
 
-        // Enable Anisotropic Filtering if available (improves clarity at angles)
-        if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic"))
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB8, layerWidth, layerHeight, static_cast<GLsizei>(images.size()), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB rows are not necessarily 4-byte aligned
+    for (size_t layer = 0; layer < images.size(); ++layer)
+    {
+        const Image &image = images[layer];
+        std::vector<unsigned char> resampled;
+        const unsigned char *pixels = image.rgb.data();
+        if (image.width != layerWidth || image.height != layerHeight)
         {
-            float maxAniso;
-            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAniso);
+            resampled = resampleRGB(pixels, image.width, image.height, layerWidth, layerHeight);
+            pixels = resampled.data();
         }
-
-        stbi_image_free(data); // Free the loaded image data from CPU memory
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(layer), layerWidth, layerHeight, 1, GL_RGB, GL_UNSIGNED_BYTE, pixels);
     }
-    else
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // Back to the default
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY); // Generate mipmaps for better quality at distance
+
+    // Set texture wrapping and filtering options
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // Trilinear filtering
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);               // Bilinear filtering
+
+    // Enable Anisotropic Filtering if available (improves clarity at angles)
+    // (queried from the context itself, as there is no GLFW context in the headless mode)
+    GLint extensions = 0;
+    bool anisotropic = false;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (GLint i = 0; i < extensions && !anisotropic; ++i)
     {
-        std::cerr << "Texture load failure: Failed to load texture at path: " << path << std::endl;
-        // stbi_failure_reason() might provide more details if needed
-        glDeleteTextures(1, &textureID); // Clean up allocated texture ID
-        return 0;
+        const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        anisotropic = name && std::string(name) == "GL_EXT_texture_filter_anisotropic";
+    }
+    if (anisotropic)
+    {
+        float maxAniso;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso);
+        glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAniso);
     }
 
     return textureID;
@@ -635,11 +930,33 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 {
     if (action == GLFW_PRESS)
     {
-        // --- Simulation Speed Control (Keys 0-4) ---
+        // --- Time Warp Presets (Keys 0-4) ---
         if (key >= GLFW_KEY_0 && key <= GLFW_KEY_4)
         {
-            float speeds[] = {0.0f, 0.5f, 1.0f, 2.0f, 5.0f};
-            simulationSpeed = speeds[key - GLFW_KEY_0];
+            double warps[] = {0.0, 0.5, 1.0, 2.0, 5.0};
+            simulationWarp = warps[key - GLFW_KEY_0];
+        }
+        // --- Continuous Time Warp ([ and ] by 10x, comma and period by 2x) ---
+        else if (key == GLFW_KEY_LEFT_BRACKET || key == GLFW_KEY_RIGHT_BRACKET ||
+                 key == GLFW_KEY_COMMA || key == GLFW_KEY_PERIOD)
+        {
+            if (simulationWarp == 0.0)
+                simulationWarp = 1.0; // Resume from pause before scaling
+            double factor = (key == GLFW_KEY_LEFT_BRACKET || key == GLFW_KEY_RIGHT_BRACKET) ? 10.0 : 2.0;
+            bool faster = (key == GLFW_KEY_RIGHT_BRACKET || key == GLFW_KEY_PERIOD);
+            const double scaled = faster ? simulationWarp * factor : simulationWarp / factor;
+            simulationWarp = std::copysign(std::clamp(std::fabs(scaled), 1e-3, SimClock::MAX_WARP), scaled); // Keeps running backwards
+        }
+        // --- Seeking (Home: back to start time, Page Up/Down: jump one minute of playback) ---
+        else if (key == GLFW_KEY_HOME && simulationThread)
+        {
+            simulationThread->seek(config.startTime);
+        }
+        else if ((key == GLFW_KEY_PAGE_UP || key == GLFW_KEY_PAGE_DOWN) && simulationThread)
+        {
+            double jump = 60.0 * std::max(simulationWarp, 1.0); // Sim seconds in one wall-clock minute
+            double now = simulationThread->latest().simTime;
+            simulationThread->seek(key == GLFW_KEY_PAGE_UP ? now + jump : now - jump);
         }
         // --- Direct Camera Lock (E for Earth, M for Mars) ---
         else if (key == GLFW_KEY_E)
@@ -667,6 +984,7 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         else if (key == GLFW_KEY_N)
         {
             cameraLockedTo = nullptr;
+            cameraLockedNode = -1;
             lockedBodyName = "None";
             currentLockIndex = -1;
             camera.updateCameraVectors();
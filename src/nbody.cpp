@@ -0,0 +1,614 @@
+/**
+ * @file nbody.cpp
+ * @brief Implements the NBodySystem class: initial conditions, force evaluation and the block-step integrators.
+ */
+
+#include "nbody.h"
+#include "hierarchy.h"   // For analytic positions and setDynamicPosition
+#include "scenario.h"    // For CelestialBody and ParticleBelt
+#include "thread_pool.h" // For ThreadPool::parallelFor
+
+#include <algorithm>     // For std::min, std::max, std::fill
+#include <chrono>        // For the timing stats
+#include <cmath>         // For std::sqrt, std::cbrt, std::ceil, std::fabs, std::llround, HUGE_VAL
+#include <functional>    // For std::function
+#include <iostream>      // For warnings (std::cerr)
+#include <random>        // For the belt particles' elements
+#include <unordered_map> // For the load-time name lookups
+
+static const size_t ENTRY_GRAIN = 4096;    // Entries per parallel chunk (integration, attractor sums, publishing)
+static const double VELOCITY_PROBE = 0.01; // Half-width (seconds) of the central difference for analytic velocities
+static const size_t BARNES_HUT_LEAF = 32;  // Particles per tree leaf (best measured trade-off for the grouped walk)
+static const size_t DIRECT_LIMIT = 32;     // Partial evaluations of at most this many entries use a direct sum instead of a tree rebuild
+
+/**
+ * @brief Runs fn over [begin, end) in chunks of @p grain, on the pool if there is one. Chunks
+ * start at begin + k * grain either way, so per-chunk partial results are laid out identically.
+ */
+static void forRange(ThreadPool *pool, size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn)
+{
+    if (pool)
+    {
+        pool->parallelFor(begin, end, grain, fn);
+        return;
+    }
+    for (size_t first = begin; first < end; first += grain)
+        fn(first, std::min(first + grain, end));
+}
+
+/**
+ * @brief Elements describing a body's scripted orbit: its KeplerElements, or the circular orbit
+ * (e = 0, i = 0 starting on +X) that orbitRadius/orbitSpeed describe.
+ */
+static KeplerElements scriptedOrbit(const CelestialBody &body)
+{
+    if (body.orbitElements)
+        return *body.orbitElements;
+    KeplerElements elements;
+    elements.semiMajorAxis = body.orbitRadius;
+    elements.meanMotion = body.orbitSpeed;
+    return elements;
+}
+
+/**
+ * @brief Mean motion of a body of mass @p mu2 on @p elements around a parent of mass @p mu1.
+ * Keeps the scripted direction of motion; falls back to the scripted speed when there is no mass.
+ */
+static double gravityMeanMotion(const KeplerElements &elements, double mu1, double mu2)
+{
+    const double a = elements.semiMajorAxis;
+    const double mu = mu1 + mu2;
+    if (mu <= 0.0 || a <= 0.0)
+        return elements.meanMotion;
+    const double n = std::sqrt(mu / (a * a * a));
+    return elements.meanMotion < 0.0f ? -n : n;
+}
+
+/**
+ * @brief Constructor: Orders the simulated bodies so parents come first, resolves parents and
+ * attractors to hierarchy nodes, and draws the belt particles' orbits.
+ */
+NBodySystem::NBodySystem(const Scenario &scenario, TransformHierarchy &hierarchy, const NBodySettings &settings)
+    : hierarchy(hierarchy), settings(settings),
+      tree(settings.theta, settings.softening, BARNES_HUT_LEAF)
+{
+    std::unordered_map<std::string, size_t> bodyByName;
+    for (size_t i = 0; i < scenario.bodies.size(); ++i)
+    {
+        bodyByName.emplace(scenario.bodies[i].name, i);
+    }
+    auto massOf = [&](const std::string &name)
+    {
+        auto it = bodyByName.find(name);
+        return it != bodyByName.end() ? static_cast<double>(scenario.bodies[it->second].mass) : 0.0;
+    };
+
+    // Analytic bodies with mass attract the entries
+    for (size_t n = 0; n < hierarchy.size(); ++n)
+    {
+        const CelestialBody &body = scenario.bodies[hierarchy.bodyIndexOf(static_cast<int>(n))];
+        if (body.dynamics == Dynamics::Analytic && body.mass > 0.0f)
+        {
+            attractorNodes.push_back(static_cast<int>(n));
+            attractorMass.push_back(body.mass);
+        }
+    }
+
+    // Simulated bodies, parents before children (repeated passes; whatever is left is a cycle)
+    const std::vector<int> &dynamicNodes = hierarchy.dynamicNodes();
+    std::unordered_map<std::string, int> entryByName;
+    std::vector<bool> placed(dynamicNodes.size(), false);
+    for (bool progress = true; progress;)
+    {
+        progress = false;
+        for (size_t k = 0; k < dynamicNodes.size(); ++k)
+        {
+            if (placed[k])
+                continue;
+            const CelestialBody &body = scenario.bodies[hierarchy.bodyIndexOf(dynamicNodes[k])];
+            InitialOrbit orbit;
+            if (body.parentName)
+            {
+                auto parent = bodyByName.find(*body.parentName);
+                if (parent != bodyByName.end() && scenario.bodies[parent->second].dynamics == Dynamics::NBody)
+                {
+                    auto entry = entryByName.find(*body.parentName);
+                    if (entry == entryByName.end())
+                        continue; // Parent not placed yet
+                    orbit.parentEntry = entry->second;
+                }
+                else
+                {
+                    orbit.parentNode = hierarchy.findNode(*body.parentName);
+                }
+            }
+            orbit.elements = scriptedOrbit(body);
+            orbit.meanMotion = gravityMeanMotion(orbit.elements, body.parentName ? massOf(*body.parentName) : 0.0, body.mass);
+            entryByName.emplace(body.name, static_cast<int>(entryCount()));
+            dynamicIndex.push_back(k);
+            addEntry(orbit, body.mass);
+            placed[k] = true;
+            progress = true;
+        }
+    }
+    for (size_t k = 0; k < dynamicNodes.size(); ++k)
+    {
+        if (!placed[k])
+        {
+            const CelestialBody &body = scenario.bodies[hierarchy.bodyIndexOf(dynamicNodes[k])];
+            std::cerr << "Warning: N-body body '" << body.name
+                      << "' is part of a parent cycle, starting it at rest at the origin." << std::endl;
+            dynamicIndex.push_back(k);
+            addEntry(InitialOrbit(), body.mass);
+        }
+    }
+    bodyCount = entryCount();
+
+    // Belt particles: random orbits around their parent, uniform in area between the two radii
+    for (const ParticleBelt &belt : scenario.belts)
+    {
+        InitialOrbit orbit;
+        auto entry = entryByName.find(belt.parentName);
+        if (entry != entryByName.end())
+            orbit.parentEntry = entry->second;
+        else
+            orbit.parentNode = hierarchy.findNode(belt.parentName);
+        if (orbit.parentEntry < 0 && orbit.parentNode < 0)
+        {
+            std::cerr << "Warning: Parent '" << belt.parentName << "' of a particle belt not found, skipping the belt." << std::endl;
+            continue;
+        }
+
+        const double parentMass = massOf(belt.parentName);
+        const double particleMass = belt.count > 0 ? belt.totalMass / belt.count : 0.0;
+        const glm::vec4 style(belt.color, belt.pointSize);
+        const float twoPi = 6.28318530718f;
+        const float inner2 = belt.innerRadius * belt.innerRadius;
+        const float outer2 = belt.outerRadius * belt.outerRadius;
+        std::mt19937 rng(belt.seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (size_t i = 0; i < belt.count; ++i)
+        {
+            KeplerElements &el = orbit.elements;
+            el.semiMajorAxis = std::sqrt(inner2 + (outer2 - inner2) * unit(rng));
+            el.eccentricity = belt.maxEccentricity * unit(rng);
+            el.inclination = belt.maxInclination * unit(rng);
+            el.ascendingNode = twoPi * unit(rng);
+            el.argumentOfPeriapsis = twoPi * unit(rng);
+            el.meanAnomalyAtEpoch = twoPi * unit(rng);
+            el.meanMotion = 0.0f; // Prograde; the speed comes from the parent's mass alone
+            orbit.meanMotion = gravityMeanMotion(el, parentMass, particleMass);
+            addEntry(orbit, particleMass);
+            styles.push_back(style);
+        }
+    }
+
+    ax.assign(entryCount(), 0.0);
+    ay.assign(entryCount(), 0.0);
+    az.assign(entryCount(), 0.0);
+    dynamicalTime2.assign(entryCount(), HUGE_VAL);
+    levels.assign(entryCount(), 0);
+    active.assign(entryCount(), 1);
+    mutualPotential.assign(entryCount(), 0.0);
+    externalPotential.assign(entryCount(), 0.0);
+    attractorState.assign(attractorNodes.size() * 6, 0.0);
+    attractorSelection = hierarchy.select(attractorNodes);
+    attractorPositions.assign(attractorNodes.size() * 3, 0.0);
+    chunkForces.assign((entryCount() + ENTRY_GRAIN - 1) / ENTRY_GRAIN * attractorNodes.size() * 3, 0.0);
+    particlePositionsF.assign(entryCount() - bodyCount, glm::vec3(0.0f));
+    lastStats.bodies = bodyCount;
+    lastStats.particles = entryCount() - bodyCount;
+}
+
+/**
+ * @brief Appends one entry with its initial orbit (the state itself is filled in by reset()).
+ */
+void NBodySystem::addEntry(const InitialOrbit &orbit, double entryMass)
+{
+    initialOrbits.push_back(orbit);
+    x.push_back(0.0);
+    y.push_back(0.0);
+    z.push_back(0.0);
+    vx.push_back(0.0);
+    vy.push_back(0.0);
+    vz.push_back(0.0);
+    mass.push_back(entryMass);
+    selfGravity = selfGravity || entryMass > 0.0;
+}
+
+/**
+ * @brief Places every entry on its initial orbit at @p simTime. Analytic parents' velocities
+ * come from a central difference of their hierarchy positions; simulated parents are already
+ * set because they precede their children.
+ */
+void NBodySystem::reset(SimClock::Ticks simTime, ThreadPool *pool)
+{
+    time = simTime;
+    if (empty())
+        return;
+    const double seconds = static_cast<double>(simTime) / SimClock::TICKS_PER_SECOND;
+
+    // Analytic parent positions at t - probe, t + probe and t (the last one stays in the hierarchy)
+    const SimClock::Ticks probe = SimClock::toTicks(VELOCITY_PROBE);
+    hierarchy.update(simTime - probe, pool);
+    const std::vector<glm::dvec3> before = hierarchy.worldPositions();
+    hierarchy.update(simTime + probe, pool);
+    const std::vector<glm::dvec3> after = hierarchy.worldPositions();
+    hierarchy.update(simTime, pool);
+
+    const double probeSpan = 2.0 * static_cast<double>(probe) / SimClock::TICKS_PER_SECOND;
+    for (size_t i = 0; i < entryCount(); ++i)
+    {
+        const InitialOrbit &orbit = initialOrbits[i];
+        double origin[3] = {0.0, 0.0, 0.0}, originVelocity[3] = {0.0, 0.0, 0.0};
+        if (orbit.parentEntry >= 0)
+        {
+            const size_t p = static_cast<size_t>(orbit.parentEntry);
+            origin[0] = x[p];
+            origin[1] = y[p];
+            origin[2] = z[p];
+            originVelocity[0] = vx[p];
+            originVelocity[1] = vy[p];
+            originVelocity[2] = vz[p];
+        }
+        else if (orbit.parentNode >= 0)
+        {
+            const glm::dvec3 &position = hierarchy.worldPositions()[orbit.parentNode];
+            const glm::dvec3 velocity = (after[orbit.parentNode] - before[orbit.parentNode]) / probeSpan;
+            for (int k = 0; k < 3; ++k)
+            {
+                origin[k] = position[k];
+                originVelocity[k] = velocity[k];
+            }
+        }
+
+        double position[3], velocity[3];
+        keplerStateAt(orbit.elements, orbit.meanMotion, seconds, position, velocity);
+        x[i] = origin[0] + position[0];
+        y[i] = origin[1] + position[1];
+        z[i] = origin[2] + position[2];
+        vx[i] = originVelocity[0] + velocity[0];
+        vy[i] = originVelocity[1] + velocity[1];
+        vz[i] = originVelocity[2] + velocity[2];
+    }
+
+    computeAccelerations(0.0, true, true, pool);
+    initialEnergy = totalEnergy();
+    attractorWork = 0.0;
+    lastStats.energyDrift = 0.0;
+    publish(pool);
+}
+
+/**
+ * @brief Splits [time, simTime] into base steps no longer than NBodySettings::timestep (at most
+ * maxSubsteps of them) and advances each with the block-step scheme. Leapfrog is one block step
+ * per base step; Yoshida-4 is three, of w1*h, w0*h and w1*h (w0 < 0, so the middle one runs
+ * backwards). Base step ends are derived from the tick endpoints, so the state always ends
+ * exactly at @p simTime.
+ */
+void NBodySystem::advanceTo(SimClock::Ticks simTime, ThreadPool *pool)
+{
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const SimClock::Ticks from = time;
+    const SimClock::Ticks delta = simTime - from;
+    lastStats.substeps = 0;
+    lastStats.deepestLevel = 0;
+    lastStats.evaluations = 0;
+    lastStats.forceMs = 0.0;
+    if (empty() || delta == 0)
+    {
+        time = simTime;
+        return;
+    }
+
+    const double deltaSeconds = static_cast<double>(delta) / SimClock::TICKS_PER_SECOND;
+    const double wanted = std::ceil(std::fabs(deltaSeconds) / std::max(settings.timestep, 1e-6));
+    const int steps = static_cast<int>(std::clamp(wanted, 1.0, static_cast<double>(std::max(settings.maxSubsteps, 1))));
+
+    // Yoshida's 4th-order weights: w1 + w0 + w1 = 1
+    const double cbrt2 = std::cbrt(2.0);
+    const double w1 = 1.0 / (2.0 - cbrt2);
+    const double w0 = -cbrt2 / (2.0 - cbrt2);
+
+    for (int step = 1; step <= steps; ++step)
+    {
+        const SimClock::Ticks stepEnd = from + static_cast<SimClock::Ticks>(static_cast<double>(delta) * step / steps);
+        const double h = static_cast<double>(stepEnd - time) / SimClock::TICKS_PER_SECOND;
+        const bool last = step == steps;
+        double offset = 0.0;
+        if (settings.integrator == Integrator::Yoshida4)
+        {
+            const int deepest = assignLevels(std::fabs(w0 * h)); // Largest of the three sub-steps
+            blockStep(w1 * h, deepest, offset, false, pool);
+            blockStep(w0 * h, deepest, offset, false, pool);
+            blockStep(w1 * h, deepest, offset, last, pool);
+        }
+        else
+        {
+            blockStep(h, assignLevels(std::fabs(h)), offset, last, pool);
+        }
+        time = stepEnd;
+    }
+    publish(pool);
+
+    lastStats.substeps = steps;
+    lastStats.forceMs /= std::max(lastStats.evaluations, 1);
+    lastStats.energyDrift = initialEnergy != 0.0 ? (totalEnergy() - initialEnergy - attractorWork) / std::fabs(initialEnergy) : 0.0;
+    lastStats.totalMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+}
+
+/**
+ * @brief Picks each entry's level: the smallest L with |step| / 2^L <= accuracy * dynamical time,
+ * capped at NBodySettings::maxLevels.
+ * @return The deepest level assigned.
+ */
+int NBodySystem::assignLevels(double stepSeconds)
+{
+    const int maxLevel = std::clamp(settings.maxLevels, 0, 30);
+    const double accuracy2 = settings.accuracy * settings.accuracy;
+    int deepest = 0;
+    for (size_t i = 0; i < entryCount(); ++i)
+    {
+        // (step / 2^L)^2 <= accuracy^2 * t_dyn^2, compared in squares to avoid a sqrt per entry
+        const double limit2 = accuracy2 * dynamicalTime2[i];
+        double sub = stepSeconds;
+        int level = 0;
+        while (level < maxLevel && sub * sub > limit2)
+        {
+            sub *= 0.5;
+            ++level;
+        }
+        levels[i] = static_cast<std::uint8_t>(level);
+        deepest = std::max(deepest, level);
+    }
+    lastStats.deepestLevel = std::max(lastStats.deepestLevel, deepest);
+    return deepest;
+}
+
+/**
+ * @brief One block step of length @p h (any sign), as kick-drift-kick at 2^deepest fine steps.
+ * An entry at level L has steps of h / 2^L, i.e. it opens (half kick) and closes (force
+ * evaluation + half kick) every 2^(deepest - L) fine steps; everyone drifts every fine step.
+ * The last fine step closes every entry, so all of them leave synchronized with fresh forces.
+ */
+void NBodySystem::blockStep(double h, int deepest, double &offset, bool withPotential, ThreadPool *pool)
+{
+    const size_t fineSteps = size_t(1) << deepest;
+    const double fine = h / static_cast<double>(fineSteps);
+    const size_t count = entryCount();
+    auto period = [&](size_t i)
+    { return fineSteps >> levels[i]; }; // Fine steps per step of entry i
+
+    for (size_t s = 0; s < fineSteps; ++s)
+    {
+        // Opening half kicks of the entries whose step starts now, then everyone drifts
+        forRange(pool, 0, count, ENTRY_GRAIN, [&](size_t first, size_t last)
+                 {
+                     for (size_t i = first; i < last; ++i)
+                     {
+                         if (s % period(i) == 0)
+                         {
+                             const double halfStep = 0.5 * h / static_cast<double>(size_t(1) << levels[i]);
+                             vx[i] += ax[i] * halfStep;
+                             vy[i] += ay[i] * halfStep;
+                             vz[i] += az[i] * halfStep;
+                         }
+                         x[i] += vx[i] * fine;
+                         y[i] += vy[i] * fine;
+                         z[i] += vz[i] * fine;
+                     } });
+        offset += fine;
+
+        // Closing: new forces and half kicks for the entries whose step ends now
+        const bool everyone = s + 1 == fineSteps;
+        if (!everyone)
+        {
+            for (size_t i = 0; i < count; ++i)
+                active[i] = (s + 1) % period(i) == 0;
+        }
+        computeAccelerations(offset, everyone, everyone && withPotential, pool);
+        forRange(pool, 0, count, ENTRY_GRAIN, [&](size_t first, size_t last)
+                 {
+                     for (size_t i = first; i < last; ++i)
+                     {
+                         if (everyone || active[i])
+                         {
+                             const double halfStep = 0.5 * h / static_cast<double>(size_t(1) << levels[i]);
+                             vx[i] += ax[i] * halfStep;
+                             vy[i] += ay[i] * halfStep;
+                             vz[i] += az[i] * halfStep;
+                         }
+                     } });
+    }
+}
+
+/**
+ * @brief Tree gravity between the entries (a direct sum when only a few are evaluated), plus a
+ * direct softened sum over the analytic attractors at their positions at time + @p offset
+ * seconds. Only the entries flagged in 'active' are evaluated unless @p everyone is set. Also refreshes each evaluated entry's
+ * dynamical time and accumulates the work done on the entries by the moving attractors
+ * (trapezoid rule between consecutive evaluations, from the pull of every entry).
+ */
+void NBodySystem::computeAccelerations(double offset, bool everyone, bool withPotential, ThreadPool *pool)
+{
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const size_t count = entryCount();
+    const std::uint8_t *mask = everyone ? nullptr : active.data();
+    const double softening2 = settings.softening * settings.softening;
+    const size_t activeCount = everyone ? count : static_cast<size_t>(std::count(active.begin(), active.end(), 1));
+    if (selfGravity && activeCount > DIRECT_LIMIT)
+    {
+        tree.build(x.data(), y.data(), z.data(), mass.data(), count, pool);
+        tree.accelerations(ax.data(), ay.data(), az.data(), pool, mask, withPotential ? mutualPotential.data() : nullptr);
+    }
+    else if (selfGravity)
+    {
+        // A few entries sub-stepping (close encounters): summing over all entries is cheaper than a rebuild
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!everyone && !active[i])
+                continue;
+            double sx = 0.0, sy = 0.0, sz = 0.0, phi = 0.0;
+            for (size_t j = 0; j < count; ++j)
+            {
+                const double dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+                const double r2 = dx * dx + dy * dy + dz * dz + softening2;
+                if (j == i || r2 == 0.0)
+                    continue;
+                const double inv = 1.0 / std::sqrt(r2);
+                const double f = mass[j] * inv * inv * inv;
+                sx += f * dx;
+                sy += f * dy;
+                sz += f * dz;
+                phi -= mass[j] * inv;
+            }
+            ax[i] = sx;
+            ay[i] = sy;
+            az[i] = sz;
+            if (withPotential)
+                mutualPotential[i] = phi;
+        }
+    }
+
+    // Attractor positions at this time, in double: only the attractors and their ancestors are
+    // evaluated; analytic children of simulated bodies follow the bodies
+    const size_t attractorCount = attractorNodes.size();
+    if (attractorCount > 0)
+    {
+        pushBodyPositions();
+        hierarchy.positionsAt(time + static_cast<SimClock::Ticks>(std::llround(offset * SimClock::TICKS_PER_SECOND)), attractorSelection);
+        for (size_t a = 0; a < attractorCount; ++a)
+        {
+            const glm::dvec3 &position = attractorSelection.position(a);
+            attractorPositions[a * 3 + 0] = position.x;
+            attractorPositions[a * 3 + 1] = position.y;
+            attractorPositions[a * 3 + 2] = position.z;
+        }
+    }
+
+    // Per chunk: force of all entries (evaluated or not) on each attractor, summed below in chunk order
+    const bool trackWork = attractorCount > 0;
+    const size_t chunkCount = (count + ENTRY_GRAIN - 1) / ENTRY_GRAIN;
+    std::fill(chunkForces.begin(), chunkForces.end(), 0.0);
+    forRange(pool, 0, count, ENTRY_GRAIN, [&](size_t first, size_t last)
+             {
+                 double *forces = trackWork ? &chunkForces[first / ENTRY_GRAIN * attractorCount * 3] : nullptr;
+                 for (size_t i = first; i < last; ++i)
+                 {
+                     const bool evaluate = everyone || active[i];
+                     double sx = 0.0, sy = 0.0, sz = 0.0, phi = 0.0;
+                     double minTime2 = HUGE_VAL;
+                     for (size_t a = 0; a < attractorCount; ++a)
+                     {
+                         const double dx = attractorPositions[a * 3 + 0] - x[i];
+                         const double dy = attractorPositions[a * 3 + 1] - y[i];
+                         const double dz = attractorPositions[a * 3 + 2] - z[i];
+                         const double r2 = dx * dx + dy * dy + dz * dz + softening2;
+                         const double r = std::sqrt(r2);
+                         const double f = attractorMass[a] / (r2 * r);
+                         const double w = energyWeight(i) * f; // Reaction on the attractor points towards the entry
+                         forces[a * 3 + 0] -= w * dx;
+                         forces[a * 3 + 1] -= w * dy;
+                         forces[a * 3 + 2] -= w * dz;
+                         sx += f * dx;
+                         sy += f * dy;
+                         sz += f * dz;
+                         phi -= attractorMass[a] / r;
+                         minTime2 = std::min(minTime2, r2 * r / attractorMass[a]);
+                     }
+                     if (!evaluate)
+                         continue;
+
+                     for (size_t b = 0; b < bodyCount; ++b)
+                     {
+                         if (b == i || mass[b] <= 0.0)
+                             continue;
+                         const double dx = x[b] - x[i], dy = y[b] - y[i], dz = z[b] - z[i];
+                         const double r2 = dx * dx + dy * dy + dz * dz + softening2;
+                         minTime2 = std::min(minTime2, r2 * std::sqrt(r2) / (mass[b] + mass[i]));
+                     }
+                     if (!selfGravity)
+                         ax[i] = ay[i] = az[i] = 0.0;
+                     ax[i] += sx;
+                     ay[i] += sy;
+                     az[i] += sz;
+                     dynamicalTime2[i] = minTime2;
+                     if (withPotential)
+                     {
+                         externalPotential[i] = phi;
+                         if (!selfGravity)
+                             mutualPotential[i] = 0.0;
+                     }
+                 } });
+
+    // Energy exchanged with moving attractors: dE/dt = -sum_a v_a . F_a, integrated over the
+    // interval since the previous evaluation with the trapezoid rule
+    if (trackWork)
+    {
+        for (size_t a = 0; a < attractorCount; ++a)
+        {
+            double force[3] = {0.0, 0.0, 0.0};
+            for (size_t c = 0; c < chunkCount; ++c)
+            {
+                for (int k = 0; k < 3; ++k)
+                    force[k] += chunkForces[(c * attractorCount + a) * 3 + k];
+            }
+            double *state = &attractorState[a * 6];
+            for (int k = 0; k < 3; ++k)
+            {
+                attractorWork -= (attractorPositions[a * 3 + k] - state[k]) * 0.5 * (force[k] + state[3 + k]);
+                state[k] = attractorPositions[a * 3 + k];
+                state[3 + k] = force[k];
+            }
+        }
+    }
+
+    ++lastStats.evaluations;
+    lastStats.forceMs += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+}
+
+/**
+ * @brief Kinetic plus potential energy of the entries, weighted by mass (or per unit mass when
+ * no entry has mass). Uses the potentials of the last evaluation withPotential.
+ */
+double NBodySystem::totalEnergy() const
+{
+    double energy = 0.0;
+    for (size_t i = 0; i < entryCount(); ++i)
+    {
+        const double v2 = vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i];
+        energy += energyWeight(i) * (0.5 * v2 + 0.5 * mutualPotential[i] + externalPotential[i]); // Pairs are counted twice
+    }
+    return energy;
+}
+
+/**
+ * @brief Hands the simulated bodies' positions to the hierarchy (applied by its next update()).
+ */
+void NBodySystem::pushBodyPositions()
+{
+    for (size_t k = 0; k < bodyCount; ++k)
+    {
+        hierarchy.setDynamicPosition(dynamicIndex[k], glm::dvec3(x[k], y[k], z[k]));
+    }
+}
+
+/**
+ * @brief Publishes the current state: body positions to the hierarchy, particle positions to
+ * the float render copy. The copy is taken relative to the first particle in double: any point
+ * of the belts keeps the offsets within the belts' extent, wherever they are in the scene.
+ */
+void NBodySystem::publish(ThreadPool *pool)
+{
+    pushBodyPositions();
+    if (bodyCount < entryCount())
+        particleOriginD = glm::dvec3(x[bodyCount], y[bodyCount], z[bodyCount]);
+    forRange(pool, bodyCount, entryCount(), ENTRY_GRAIN, [&](size_t first, size_t last)
+             {
+                 for (size_t i = first; i < last; ++i)
+                 {
+                     particlePositionsF[i - bodyCount] = glm::vec3(glm::dvec3(x[i], y[i], z[i]) - particleOriginD);
+                 } });
+}
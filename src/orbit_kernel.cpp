@@ -0,0 +1,138 @@
+/**
+ * @file orbit_kernel.cpp
+ * @brief Implements the SoA batch orbit/rotation kernel on top of simd_math.h.
+ */
+
+#include "orbit_kernel.h"
+#include "simd_math.h" // SIMD backend + vectorized sincos
+
+#include <cmath>   // For std::sqrt
+#include <cstring> // For std::memcpy
+
+/**
+ * @brief Resizes every array, filling new (and padding) entries with an inert body
+ * (no orbit, no spin, unit Y axis, zero scale).
+ */
+void OrbitBatch::resize(size_t n)
+{
+    size_t padded = (n + laneBlock - 1) / laneBlock * laneBlock;
+    orbitRadius.resize(padded, 0.0f);
+    orbitRate.resize(padded, 0);
+    rotationRate.resize(padded, 0);
+    axisX.resize(padded, 0.0f);
+    axisY.resize(padded, 1.0f);
+    axisZ.resize(padded, 0.0f);
+    scale.resize(padded, 0.0f);
+    count = n;
+}
+
+/**
+ * @brief Stores one body's parameters, normalizing the rotation axis once here
+ * so the kernel does not have to.
+ */
+void OrbitBatch::set(size_t i, float orbitRad, float orbitSpd, float rotationSpd,
+                     float ax, float ay, float az, float bodyScale)
+{
+    float len = std::sqrt(ax * ax + ay * ay + az * az);
+    float inv = len > 0.0f ? 1.0f / len : 0.0f;
+    orbitRadius[i] = orbitRad > 0.0f ? orbitRad : 0.0f; // Non-positive radius means "no orbit"
+    orbitRate[i] = phaseRateFromSpeed(orbitSpd);
+    rotationRate[i] = phaseRateFromSpeed(rotationSpd);
+    axisX[i] = ax * inv;
+    axisY[i] = len > 0.0f ? ay * inv : 1.0f; // Degenerate axis falls back to +Y
+    axisZ[i] = az * inv;
+    scale[i] = bodyScale;
+}
+
+/**
+ * @brief Kernel body. Each iteration evaluates Simd::width bodies: the two fixed-point phases
+ * (scalar 64-bit multiplies, already reduced to [-pi, pi)), two sincos calls
+ * (orbit angle and spin angle), the orbital offset, and the Rodrigues rotation matrix
+ * pre-multiplied by the uniform scale. Results are computed in SoA registers and then
+ * written out as AoS column-major matrices.
+ */
+void evaluateOrbitBatchRange(const OrbitBatch &batch, SimClock::Ticks simTime, float *outMatrices,
+                             size_t first, size_t last)
+{
+    using namespace simd;
+    constexpr int W = Simd::width;
+    static_assert(OrbitBatch::laneBlock % W == 0, "Lane block must be a multiple of the SIMD width");
+
+    const size_t count = last < batch.size() ? last : batch.size();
+    const Simd one = set1(1.0f);
+
+    // Scratch for the 12 non-constant matrix elements of W bodies (transposed on store)
+    alignas(32) float lanes[12][W];
+    alignas(32) float orbitAngles[W], spinAngles[W];
+
+    for (size_t base = first; base < count; base += W)
+    {
+        // --- Angles: exact fixed-point phase at this tick (no SIMD 64-bit multiply before AVX-512) ---
+        for (int l = 0; l < W; ++l)
+        {
+            orbitAngles[l] = phaseAngle(batch.orbitRate[base + l], simTime);
+            spinAngles[l] = phaseAngle(batch.rotationRate[base + l], simTime);
+        }
+
+        // --- Orbit: offset = (cos, 0, -sin) * radius (prograde, see scene_frame.h) ---
+        Simd orbitSin, orbitCos;
+        sincos(load(orbitAngles), orbitSin, orbitCos);
+        Simd radius = load(&batch.orbitRadius[base]);
+
+        // --- Spin: Rodrigues rotation about the normalized axis ---
+        Simd s, c;
+        sincos(load(spinAngles), s, c);
+        Simd x = load(&batch.axisX[base]);
+        Simd y = load(&batch.axisY[base]);
+        Simd z = load(&batch.axisZ[base]);
+        Simd k = load(&batch.scale[base]);
+        Simd oneMinusC = one - c;
+        Simd tx = oneMinusC * x, ty = oneMinusC * y, tz = oneMinusC * z;
+        Simd sx = s * x, sy = s * y, sz = s * z;
+
+        // Column 0
+        store(lanes[0], fmadd(tx, x, c) * k);
+        store(lanes[1], fmadd(tx, y, sz) * k);
+        store(lanes[2], fnmadd(one, sy, tx * z) * k);
+        // Column 1
+        store(lanes[3], fnmadd(one, sz, ty * x) * k);
+        store(lanes[4], fmadd(ty, y, c) * k);
+        store(lanes[5], fmadd(ty, z, sx) * k);
+        // Column 2
+        store(lanes[6], fmadd(tz, x, sy) * k);
+        store(lanes[7], fnmadd(one, sx, tz * y) * k);
+        store(lanes[8], fmadd(tz, z, c) * k);
+        // Column 3 (translation)
+        store(lanes[9], orbitCos * radius);
+        store(lanes[10], set1(0.0f));
+        store(lanes[11], fnmadd(orbitSin, radius, set1(0.0f)));
+
+        // --- Transpose SoA lanes into column-major 4x4 matrices ---
+        const size_t active = count - base < static_cast<size_t>(W) ? count - base : W;
+        for (size_t l = 0; l < active; ++l)
+        {
+            float m[16] = {
+                lanes[0][l], lanes[1][l], lanes[2][l], 0.0f,
+                lanes[3][l], lanes[4][l], lanes[5][l], 0.0f,
+                lanes[6][l], lanes[7][l], lanes[8][l], 0.0f,
+                lanes[9][l], lanes[10][l], lanes[11][l], 1.0f};
+            std::memcpy(outMatrices + (base + l) * 16, m, sizeof(m));
+        }
+    }
+}
+
+/**
+ * @brief Whole-batch convenience wrapper.
+ */
+void evaluateOrbitBatch(const OrbitBatch &batch, SimClock::Ticks simTime, float *outMatrices)
+{
+    evaluateOrbitBatchRange(batch, simTime, outMatrices, 0, batch.size());
+}
+
+/**
+ * @brief Reports the compiled SIMD backend.
+ */
+const char *orbitKernelBackend()
+{
+    return simd::Simd::name;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file particle_renderer.cpp
+ * @brief Implements the ParticleRenderer class: buffer setup, per-tick uploads and drawing.
+ */
+
+#include "particle_renderer.h"
+
+#include <cstring> // For std::memcpy
+
+/**
+ * @brief Constructor: Allocates the position regions (filled by upload()) and uploads the styles.
+ */
+ParticleRenderer::ParticleRenderer(const std::vector<glm::vec4> &styles)
+    : count(styles.size())
+{
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &styleVBO);
+    if (count > 0)
+        positions.allocate(2 * count * sizeof(glm::vec3));
+
+    glBindVertexArray(VAO);
+
+    // Attributes 0 and 1: positions at the previous and current tick (pointed at the latest
+    // region by draw())
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+
+    // Attribute 2: color (xyz) and point size (w), never changes
+    glBindBuffer(GL_ARRAY_BUFFER, styleVBO);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::vec4), styles.empty() ? nullptr : styles.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void *)0);
+
+    glBindVertexArray(0); // Unbind VAO to prevent accidental changes
+}
+
+/**
+ * @brief Destructor: Cleans up the OpenGL buffer objects.
+ */
+ParticleRenderer::~ParticleRenderer()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &styleVBO);
+}
+
+/**
+ * @brief Writes both ticks into the next region; the regions of earlier ticks stay intact for
+ * draws still reading them. The origins are kept for offsets().
+ */
+void ParticleRenderer::upload(const std::vector<glm::vec3> &previous, const glm::dvec3 &previousOrigin,
+                              const std::vector<glm::vec3> &current, const glm::dvec3 &currentOrigin)
+{
+    if (count == 0 || previous.size() < count || current.size() < count)
+        return;
+    glm::vec3 *region = static_cast<glm::vec3 *>(positions.map());
+    if (!region)
+        return;
+    std::memcpy(region, previous.data(), count * sizeof(glm::vec3));
+    std::memcpy(region + count, current.data(), count * sizeof(glm::vec3));
+    positions.unmap();
+    this->previousOrigin = previousOrigin;
+    this->currentOrigin = currentOrigin;
+    uploaded = true;
+}
+
+/**
+ * @brief Points attributes 0 and 1 at the latest region and draws every particle as one point.
+ */
+void ParticleRenderer::draw() const
+{
+    if (count == 0 || !uploaded)
+        return;
+    const GLintptr base = positions.offset();
+    glBindBuffer(GL_ARRAY_BUFFER, positions.buffer());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)base);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)(base + count * sizeof(glm::vec3)));
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(count));
+}
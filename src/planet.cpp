@@ -5,7 +5,8 @@
 
 #include "planet.h"
 #include <vector>
-#include <cmath> // For sin, cos
+#include <algorithm> // For std::max
+#include <cmath>     // For sin, cos
 
 /**
  * @brief Constructor: Generates vertex positions, normals, texture coordinates,
@@ -14,10 +15,52 @@
  */
 Planet::Planet(float radius, unsigned int rings, unsigned int sectors)
 {
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    appendSphere(radius, rings, sectors, data, indices);
+    upload(data, indices);
+}
+
+/**
+ * @brief Constructor: One sphere per detail, all in the same buffers.
+ */
+Planet::Planet(float radius, const std::vector<unsigned int> &details)
+{
+    std::vector<float> data;
+    std::vector<unsigned int> indices;
+    for (unsigned int detail : details)
+    {
+        appendSphere(radius, detail, detail, data, indices);
+    }
+    upload(data, indices);
+}
+
+/**
+ * @brief Doubles the detail from @p coarsest until it reaches @p finest (which is always included).
+ */
+std::vector<unsigned int> Planet::lodChain(unsigned int coarsest, unsigned int finest)
+{
+    std::vector<unsigned int> details;
+    for (unsigned int detail = std::max(coarsest, 3u); detail < finest; detail *= 2)
+    {
+        details.push_back(detail);
+    }
+    details.push_back(std::max(finest, 3u));
+    return details;
+}
+
+/**
+ * @brief Generates one UV sphere after the data already in @p data and @p indices and records
+ * it as the next Mesh. Indices are local to the sphere; Mesh::baseVertex offsets them.
+ */
+void Planet::appendSphere(float radius, unsigned int rings, unsigned int sectors,
+                          std::vector<float> &data, std::vector<unsigned int> &indices)
+{
+    const size_t firstIndex = indices.size();
+    const size_t baseVertex = data.size() / 8; // 8 floats per vertex (see below)
     std::vector<glm::vec3> vertices;
     std::vector<glm::vec2> texCoords;
     std::vector<glm::vec3> normals;
-    std::vector<unsigned int> indices;
 
     // Constants for calculating vertex positions based on spherical coordinates
     float const R = 1.0f / (float)(rings - 1);   // Inverse of the number of ring segments
@@ -52,7 +95,7 @@ Planet::Planet(float radius, unsigned int rings, unsigned int sectors)
     }
 
     // Generate indices for triangle strips (forming quadrilaterals)
-    indices.reserve((rings - 1) * (sectors - 1) * 6);
+    indices.reserve(indices.size() + (rings - 1) * (sectors - 1) * 6);
     for (unsigned int r = 0; r < rings - 1; ++r)
     {
         for (unsigned int s = 0; s < sectors - 1; ++s)
@@ -69,11 +112,10 @@ Planet::Planet(float radius, unsigned int rings, unsigned int sectors)
             indices.push_back((r + 1) * sectors + s);
         }
     }
-    indexCount = static_cast<unsigned int>(indices.size());
+    meshes.push_back({static_cast<GLsizei>(indices.size() - firstIndex), static_cast<GLuint>(firstIndex), static_cast<GLint>(baseVertex)});
 
     // Interleave vertex data (Position, Normal, TexCoord) into a single array
-    std::vector<float> data;
-    data.reserve(vertices.size() * 8); // 3 pos + 3 normal + 2 texCoord = 8 floats per vertex
+    data.reserve(data.size() + vertices.size() * 8); // 3 pos + 3 normal + 2 texCoord = 8 floats per vertex
     for (size_t i = 0; i < vertices.size(); ++i)
     {
         data.push_back(vertices[i].x);
@@ -93,7 +135,14 @@ Planet::Planet(float radius, unsigned int rings, unsigned int sectors)
             data.push_back(texCoords[i].y);
         }
     }
+}
 
+/**
+ * @brief Uploads the interleaved vertex data and indices and configures the vertex attributes
+ * within a VAO.
+ */
+void Planet::upload(const std::vector<float> &data, const std::vector<unsigned int> &indices)
+{
     // --- OpenGL Buffer Setup ---
     glGenVertexArrays(1, &VAO); // Generate VAO to store attribute configurations
     glGenBuffers(1, &VBO);      // Generate VBO for vertex data
@@ -140,12 +189,12 @@ Planet::~Planet()
 }
 
 /**
- * @brief Renders the sphere by binding its VAO and issuing a draw call.
+ * @brief Renders several copies of one sphere in one draw call. The VAO is left bound, so
+ * consecutive draws from the same buffers need no rebinding.
  */
-void Planet::draw()
+void Planet::drawInstanced(GLsizei instanceCount, size_t mesh) const
 {
-    glBindVertexArray(VAO); // Bind the VAO containing the mesh data and attribute configuration
-    // Draw the triangles using the indices stored in the EBO
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0); // Unbind the VAO
+    const Mesh &m = meshes[mesh];
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m.indexCount, GL_UNSIGNED_INT,
+                                      (void *)(m.firstIndex * sizeof(unsigned int)), instanceCount, m.baseVertex);
 }
@@ -0,0 +1,130 @@
+/**
+ * @file render_queue.cpp
+ * @brief Implements the RenderQueue class: key packing, sorting, state filtering and counting.
+ */
+
+#include "render_queue.h"
+
+#include <algorithm> // For std::stable_sort, std::find_if, std::min, std::max
+#include <utility>   // For std::pair
+
+namespace
+{
+const int DEPTH_BITS = 24, MESH_BITS = 14, TEXTURE_BITS = 12, PROGRAM_BITS = 10, PASS_BITS = 4;
+const std::uint64_t DEPTH_MAX = (std::uint64_t(1) << DEPTH_BITS) - 1;
+
+/** @brief The low @p bits bits of @p value. */
+std::uint64_t field(std::uint64_t value, int bits)
+{
+    return value & ((std::uint64_t(1) << bits) - 1);
+}
+} // namespace
+
+/**
+ * @brief Clears the items, keeping their storage for the next frame.
+ */
+void RenderQueue::begin(float farDistance)
+{
+    items.clear();
+    depthScale = farDistance > 0.0f ? static_cast<float>(DEPTH_MAX) / farDistance : 0.0f;
+}
+
+/**
+ * @brief Packs the key and stores the item. The mesh field holds the vertex array's low bits
+ * above the range index, so draws from one vertex array stay adjacent.
+ */
+void RenderQueue::submit(RenderPass pass, unsigned int program, GLenum textureTarget, unsigned int texture,
+                         unsigned int vertexArray, unsigned int mesh, float depth, std::function<void()> draw)
+{
+    const std::uint64_t depthKey = static_cast<std::uint64_t>(std::min(std::max(depth, 0.0f) * depthScale, static_cast<float>(DEPTH_MAX)));
+    const std::uint64_t meshKey = (field(vertexArray, 8) << 6) | field(mesh, 6);
+    std::uint64_t key = field(static_cast<std::uint64_t>(pass), PASS_BITS);
+    key = (key << PROGRAM_BITS) | field(program, PROGRAM_BITS);
+    key = (key << TEXTURE_BITS) | field(texture, TEXTURE_BITS);
+    key = (key << MESH_BITS) | meshKey;
+    key = (key << DEPTH_BITS) | depthKey;
+    items.push_back({key, program, textureTarget, texture, vertexArray, std::move(draw)});
+}
+
+/**
+ * @brief Tracks the bound program, vertex array and one texture per target, as execute() does.
+ */
+void RenderQueue::countChanges(const std::vector<const Item *> &items, size_t &programs, size_t &textures, size_t &vertexArrays)
+{
+    programs = textures = vertexArrays = 0;
+    unsigned int program = 0, vertexArray = 0;
+    bool first = true;
+    std::vector<std::pair<GLenum, unsigned int>> bound; // Texture per target
+    for (const Item *item : items)
+    {
+        if (first || item->program != program)
+            ++programs;
+        if (first || item->vertexArray != vertexArray)
+            ++vertexArrays;
+        program = item->program;
+        vertexArray = item->vertexArray;
+        first = false;
+        if (item->textureTarget == 0)
+            continue;
+        auto it = std::find_if(bound.begin(), bound.end(), [&](const std::pair<GLenum, unsigned int> &b)
+                               { return b.first == item->textureTarget; });
+        if (it == bound.end())
+        {
+            bound.push_back({item->textureTarget, item->texture});
+            ++textures;
+        }
+        else if (it->second != item->texture)
+        {
+            it->second = item->texture;
+            ++textures;
+        }
+    }
+}
+
+/**
+ * @brief Sorts, then issues every item. Nothing about the GL state is assumed at the start
+ * (the overlay changes it between frames), so the first item binds everything it needs.
+ */
+void RenderQueue::execute()
+{
+    lastStats = RenderStats();
+    lastStats.items = items.size();
+
+    ordered.clear();
+    for (const Item &item : items)
+        ordered.push_back(&item);
+    countChanges(ordered, lastStats.unsortedProgramChanges, lastStats.unsortedTextureBinds, lastStats.unsortedVertexArrayBinds);
+    std::stable_sort(ordered.begin(), ordered.end(), [](const Item *a, const Item *b)
+                     { return a->key < b->key; });
+    countChanges(ordered, lastStats.programChanges, lastStats.textureBinds, lastStats.vertexArrayBinds);
+
+    glActiveTexture(GL_TEXTURE0);
+    unsigned int program = 0, vertexArray = 0;
+    bool first = true;
+    std::vector<std::pair<GLenum, unsigned int>> bound; // Texture per target, as in countChanges()
+    for (const Item *item : ordered)
+    {
+        if (first || item->program != program)
+            glUseProgram(item->program);
+        if (first || item->vertexArray != vertexArray)
+            glBindVertexArray(item->vertexArray);
+        program = item->program;
+        vertexArray = item->vertexArray;
+        first = false;
+        if (item->textureTarget != 0)
+        {
+            auto it = std::find_if(bound.begin(), bound.end(), [&](const std::pair<GLenum, unsigned int> &b)
+                                   { return b.first == item->textureTarget; });
+            if (it == bound.end() || it->second != item->texture)
+            {
+                glBindTexture(item->textureTarget, item->texture);
+                if (it == bound.end())
+                    bound.push_back({item->textureTarget, item->texture});
+                else
+                    it->second = item->texture;
+            }
+        }
+        item->draw();
+    }
+    glBindVertexArray(0);
+}
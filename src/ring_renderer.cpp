@@ -0,0 +1,85 @@
+/**
+ * @file ring_renderer.cpp
+ * @brief Implements the RingRenderer class: ring frame and rate setup, and the instanced draw.
+ */
+
+#include "ring_renderer.h"
+#include "scenario.h" // For ParticleRing
+
+#include <cmath> // For std::pow, std::fabs
+
+/**
+ * @brief Constructor: Builds the ring frame from @p normal and the base rate from the ring's speeds.
+ */
+RingRenderer::RingRenderer(const ParticleRing &ring, const glm::vec3 &normal)
+    : count(ring.count), innerRadius(ring.innerRadius), outerRadius(ring.outerRadius),
+      thickness(ring.thickness), seed(ring.seed), color(ring.color), pointSize(ring.pointSize)
+{
+    // Frame: Y along the normal; for the usual +Y axis this is the identity, matching the
+    // (cos, 0, sin) orbits of the bodies
+    glm::vec3 n = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 reference = std::fabs(n.z) < 0.9f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    glm::vec3 u = glm::normalize(glm::cross(n, reference));
+    glm::vec3 w = glm::cross(u, n);
+    basis = glm::mat3(u, n, w);
+
+    // Keplerian speed at the outer edge, split into RATE_STEPS base-rate steps; a particle at
+    // radius r then moves at round(RATE_STEPS * (outer / r)^1.5) base rates
+    double outerSpeed = ring.innerSpeed * std::pow(static_cast<double>(ring.innerRadius) / ring.outerRadius, 1.5);
+    baseRate = phaseRateFromSpeed(outerSpeed / RATE_STEPS);
+
+    glGenVertexArrays(1, &VAO); // No attributes: everything comes from gl_VertexID / gl_InstanceID
+}
+
+/**
+ * @brief Looks the per-ring uniforms up once.
+ */
+RingRenderer::Uniforms::Uniforms(const Shader &shader)
+    : center(shader.uniform<glm::vec3>("center")),
+      basis(shader.uniform<glm::mat3>("basis")),
+      innerRadius(shader.uniform<float>("innerRadius")),
+      outerRadius(shader.uniform<float>("outerRadius")),
+      thickness(shader.uniform<float>("thickness")),
+      rateSteps(shader.uniform<float>("rateSteps")),
+      basePhase(shader.uniform<unsigned int>("basePhase")),
+      seed(shader.uniform<unsigned int>("seed")),
+      count(shader.uniform<unsigned int>("count")),
+      color(shader.uniform<glm::vec3>("color")),
+      pointSize(shader.uniform<float>("pointSize"))
+{
+}
+
+/**
+ * @brief Destructor: Cleans up the OpenGL vertex array.
+ */
+RingRenderer::~RingRenderer()
+{
+    glDeleteVertexArrays(1, &VAO);
+}
+
+/**
+ * @brief Sets the ring uniforms and draws ceil(count / BATCH) instances of BATCH points.
+ * Only the top 32 bits of the base phase are passed. The dropped bits are less than
+ * 2*pi / 2^32 (1.46 nrad) per base rate, times the particle's multiple: about 1.5 microradians
+ * at the outer edge (RATE_STEPS) and 3.7 at the inner edge of Saturn's rings (multiple ~2540).
+ */
+void RingRenderer::draw(const Shader &shader, const Uniforms &uniforms, const glm::vec3 &center, SimClock::Ticks simTime) const
+{
+    if (count == 0 || outerRadius <= innerRadius)
+        return;
+    const std::uint64_t phase = baseRate * static_cast<std::uint64_t>(simTime); // Wraps once per revolution
+    shader.set(uniforms.center, center);
+    shader.set(uniforms.basis, basis);
+    shader.set(uniforms.innerRadius, innerRadius);
+    shader.set(uniforms.outerRadius, outerRadius);
+    shader.set(uniforms.thickness, thickness);
+    shader.set(uniforms.rateSteps, static_cast<float>(RATE_STEPS));
+    shader.set(uniforms.basePhase, static_cast<unsigned int>(phase >> 32));
+    shader.set(uniforms.seed, seed);
+    shader.set(uniforms.count, static_cast<unsigned int>(count));
+    shader.set(uniforms.color, color);
+    shader.set(uniforms.pointSize, pointSize);
+
+    const GLsizei instances = static_cast<GLsizei>((count + BATCH - 1) / BATCH);
+    glDrawArraysInstanced(GL_POINTS, 0, BATCH, instances);
+}
@@ -1,20 +1,18 @@
 /**
  * @file scenario.cpp
- * @brief Implements the function to load the basic solar system scenario definition.
+ * @brief Implements the functions that load the scenario definitions.
  */
 #include "scenario.h"
-#include "planet.h" // Include the full definition for unique_ptr destructor
+#include "spk_file.h" // For the ephemeris scenario
+#include <iostream>   // For warnings (std::cerr)
 #include <vector>
 #include <string>
 #include <optional>
-#include <memory> // For std::make_unique
+#include <memory> // For std::make_shared
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp> // For glm::pi
 #include <cmath>                 // For basic math
 
-// Destructor implementation (required because unique_ptr<Planet> needs full Planet definition here)
-CelestialBody::~CelestialBody() = default;
-
 /**
  * @brief Creates and returns a Scenario object containing the Sun and planets up to Neptune.
  * Defines relative sizes, compressed orbital distances, and relative speeds.
@@ -43,8 +41,7 @@ Scenario loadScenario_SolarSystemBasic()
         0.0f, 0.0f, 0.1f, glm::vec3(0.0f, 1.0f, 0.0f), // Orbit params (none), slow rotation
         std::nullopt                                   // No parent
     );
-    sun.mesh = std::make_unique<Planet>(1.0f, 64, 64); // High detail mesh (radius 1.0, scaled later)
-    scenario.bodies.push_back(std::move(sun));         // Add to scenario (use std::move for unique_ptr)
+    scenario.bodies.push_back(std::move(sun)); // Add to scenario
 
     // Mercury
     CelestialBody mercury(
@@ -52,7 +49,17 @@ Scenario loadScenario_SolarSystemBasic()
         4.0f, earthOrbitSpeed * 1.61f, earthRotationSpeed * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f),
         "Sun" // Parent
     );
-    mercury.mesh = std::make_unique<Planet>(1.0f, 32, 32); // Lower detail mesh
+    // Mercury's orbit is visibly eccentric and inclined, so it uses full orbital elements
+    // (real e, i, Omega, omega, M0; compressed a and relative speed like the other planets)
+    KeplerElements mercuryOrbit;
+    mercuryOrbit.semiMajorAxis = 4.0f;
+    mercuryOrbit.eccentricity = 0.2056f;
+    mercuryOrbit.inclination = glm::radians(7.0f);
+    mercuryOrbit.ascendingNode = glm::radians(48.33f);
+    mercuryOrbit.argumentOfPeriapsis = glm::radians(29.12f);
+    mercuryOrbit.meanAnomalyAtEpoch = glm::radians(174.8f);
+    mercuryOrbit.meanMotion = earthOrbitSpeed * 1.61f;
+    mercury.orbitElements = mercuryOrbit;
     scenario.bodies.push_back(std::move(mercury));
 
     // Venus
@@ -60,7 +67,6 @@ Scenario loadScenario_SolarSystemBasic()
         "Venus", earthRadius * 0.95f, "textures/venus.jpg", false,
         7.0f, earthOrbitSpeed * 1.18f, earthRotationSpeed * -0.004f, glm::vec3(0.0f, 1.0f, 0.0f), // Retrograde rotation
         "Sun");
-    venus.mesh = std::make_unique<Planet>(1.0f, 48, 48);
     scenario.bodies.push_back(std::move(venus));
 
     // Earth
@@ -68,7 +74,6 @@ Scenario loadScenario_SolarSystemBasic()
         "Earth", earthRadius, "textures/earth.jpg", false,
         earthOrbitRadius, earthOrbitSpeed, earthRotationSpeed, glm::vec3(0.0f, 1.0f, 0.0f),
         "Sun");
-    earth.mesh = std::make_unique<Planet>(1.0f, 64, 64); // High detail mesh
     scenario.bodies.push_back(std::move(earth));
 
     // Moon
@@ -77,7 +82,6 @@ Scenario loadScenario_SolarSystemBasic()
         earthRadius * 2.0f + 0.5f, earthOrbitSpeed * 2.0f, earthRotationSpeed * 0.1f, glm::vec3(0.0f, 1.0f, 0.0f),
         "Earth" // Orbits Earth
     );
-    moon.mesh = std::make_unique<Planet>(1.0f, 32, 32);
     scenario.bodies.push_back(std::move(moon));
 
     // Mars
@@ -85,7 +89,6 @@ Scenario loadScenario_SolarSystemBasic()
         "Mars", earthRadius * 0.53f, "textures/mars.jpg", false,
         15.0f, earthOrbitSpeed * 0.81f, earthRotationSpeed * 0.97f, glm::vec3(0.0f, 1.0f, 0.0f),
         "Sun");
-    mars.mesh = std::make_unique<Planet>(1.0f, 48, 48);
     scenario.bodies.push_back(std::move(mars));
 
     // Jupiter
@@ -93,7 +96,6 @@ Scenario loadScenario_SolarSystemBasic()
         "Jupiter", earthRadius * 3.0f, "textures/jupiter.jpg", false,                         // Scaled down significantly for visibility
         25.0f, earthOrbitSpeed * 0.44f, earthRotationSpeed * 2.41f, glm::vec3(0.0f, 1.0f, 0.0f), // Fast rotation
         "Sun");
-    jupiter.mesh = std::make_unique<Planet>(1.0f, 64, 64);
     scenario.bodies.push_back(std::move(jupiter));
 
     // Saturn
@@ -101,16 +103,27 @@ Scenario loadScenario_SolarSystemBasic()
         "Saturn", earthRadius * 2.5f, "textures/saturn.jpg", false,                           // Scaled down
         35.0f, earthOrbitSpeed * 0.32f, earthRotationSpeed * 2.25f, glm::vec3(0.0f, 1.0f, 0.0f), // Fast rotation
         "Sun");
-    saturn.mesh = std::make_unique<Planet>(1.0f, 64, 64);
-    // Note: Rings are not implemented in this simple version
     scenario.bodies.push_back(std::move(saturn));
 
+    // Saturn's rings: 1.24 to 2.27 Saturn radii (C ring to A ring), as GPU-generated particles.
+    // The inner edge orbits about twice per Saturn rotation, as the real C ring does
+    ParticleRing saturnRings;
+    saturnRings.parentName = "Saturn";
+    saturnRings.count = 300000;
+    saturnRings.innerRadius = earthRadius * 2.5f * 1.24f;
+    saturnRings.outerRadius = earthRadius * 2.5f * 2.27f;
+    saturnRings.thickness = 0.01f;
+    saturnRings.innerSpeed = earthRotationSpeed * 2.25f * 1.9f;
+    saturnRings.seed = 6;
+    saturnRings.color = glm::vec3(0.82f, 0.76f, 0.64f);
+    saturnRings.pointSize = 1.5f;
+    scenario.rings.push_back(saturnRings);
+
     // Uranus
     CelestialBody uranus(
         "Uranus", earthRadius * 1.5f, "textures/uranus.jpg", false,                            // Scaled down
         45.0f, earthOrbitSpeed * 0.23f, earthRotationSpeed * -1.40f, glm::vec3(1.0f, 0.0f, 0.0f), // Retrograde, Tilted axis
         "Sun");
-    uranus.mesh = std::make_unique<Planet>(1.0f, 48, 48);
     scenario.bodies.push_back(std::move(uranus));
 
     // Neptune
@@ -118,8 +131,109 @@ Scenario loadScenario_SolarSystemBasic()
         "Neptune", earthRadius * 1.4f, "textures/neptune.jpg", false, // Scaled down
         55.0f, earthOrbitSpeed * 0.18f, earthRotationSpeed * 1.49f, glm::vec3(0.0f, 1.0f, 0.0f),
         "Sun");
-    neptune.mesh = std::make_unique<Planet>(1.0f, 48, 48);
     scenario.bodies.push_back(std::move(neptune));
 
     return scenario;
 }
+
+/**
+ * @brief Creates the basic solar system with gravitational masses and an N-body asteroid belt.
+ * The Sun's G*M is chosen so a circular orbit at Earth's compressed radius has Earth's scripted
+ * speed (omega^2 * r^3 = 0.5^2 * 10^3 = 250); the planets use their real mass ratios to the Sun.
+ */
+Scenario loadScenario_AsteroidBelt(size_t particleCount)
+{
+    Scenario scenario = loadScenario_SolarSystemBasic();
+
+    const float sunMass = 250.0f;
+    const struct
+    {
+        const char *name;
+        float massRatio; // Mass relative to the Sun
+    } masses[] = {
+        {"Sun", 1.0f},
+        {"Mercury", 1.66e-7f},
+        {"Venus", 2.45e-6f},
+        {"Earth", 3.0e-6f},
+        {"Moon", 3.7e-8f},
+        {"Mars", 3.2e-7f},
+        {"Jupiter", 9.55e-4f},
+        {"Saturn", 2.86e-4f},
+        {"Uranus", 4.37e-5f},
+        {"Neptune", 5.15e-5f},
+    };
+    for (CelestialBody &body : scenario.bodies)
+    {
+        for (const auto &entry : masses)
+        {
+            if (body.name == entry.name)
+                body.mass = sunMass * entry.massRatio;
+        }
+    }
+
+    // Main belt between Mars (15) and Jupiter (25); the total mass is a few times the real belt's
+    // share of the Sun's mass, so the belt's self-gravity is small but not zero
+    ParticleBelt belt;
+    belt.parentName = "Sun";
+    belt.count = particleCount;
+    belt.innerRadius = 17.0f;
+    belt.outerRadius = 22.0f;
+    belt.maxEccentricity = 0.15f;
+    belt.maxInclination = 0.15f;
+    belt.totalMass = sunMass * 1e-6f;
+    belt.seed = 1;
+    belt.color = glm::vec3(0.6f, 0.55f, 0.5f);
+    belt.pointSize = 2.0f;
+    scenario.belts.push_back(belt);
+
+    scenario.initialCameraPos = glm::vec3(0.0f, 20.0f, 40.0f); // Far enough out to see the whole belt
+    return scenario;
+}
+
+/**
+ * @brief Creates the basic solar system with the bodies' relative positions taken from an SPK file.
+ * DE files give the Sun, Mercury, Venus, Earth and Moon individually, and the outer planets as
+ * their system barycenters, which is what is used for them here.
+ */
+Scenario loadScenario_Ephemeris(const std::string &path, double epochDays, double daysPerSecond)
+{
+    Scenario scenario = loadScenario_SolarSystemBasic();
+
+    auto file = std::make_shared<const SpkFile>(path);
+    if (!file->isOpen())
+    {
+        std::cerr << "Warning: Ephemeris '" << path << "' could not be used, keeping the scripted orbits." << std::endl;
+        return scenario;
+    }
+
+    const struct
+    {
+        const char *name;
+        int naifId;
+    } ids[] = {
+        {"Sun", 10},
+        {"Mercury", 199},
+        {"Venus", 299},
+        {"Earth", 399},
+        {"Moon", 301},
+        {"Mars", 4}, // Barycenters: Mars and the outer planets' satellites are not in the small DE files
+        {"Jupiter", 5},
+        {"Saturn", 6},
+        {"Uranus", 7},
+        {"Neptune", 8},
+    };
+    for (CelestialBody &body : scenario.bodies)
+    {
+        for (const auto &entry : ids)
+        {
+            if (body.name == entry.name)
+                body.ephemerisId = entry.naifId;
+        }
+    }
+
+    const double secondsPerDay = 86400.0;
+    scenario.ephemeris = std::move(file);
+    scenario.ephemerisEpoch = epochDays * secondsPerDay;
+    scenario.ephemerisTimeScale = daysPerSecond * secondsPerDay;
+    return scenario;
+}
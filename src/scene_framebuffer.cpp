@@ -0,0 +1,117 @@
+/**
+ * @file scene_framebuffer.cpp
+ * @brief Implements the SceneFramebuffer class: attachment setup, resizing, the copy to the window and image readback.
+ */
+
+#include "scene_framebuffer.h"
+
+#include <cstdio>   // For writing the image
+#include <iostream> // For error output
+#include <vector>   // For the pixel readback
+
+/**
+ * @brief Destructor: Cleans up the OpenGL objects.
+ */
+SceneFramebuffer::~SceneFramebuffer()
+{
+    release();
+}
+
+/**
+ * @brief Deletes whatever exists and resets the size.
+ */
+void SceneFramebuffer::release()
+{
+    if (FBO != 0)
+        glDeleteFramebuffers(1, &FBO);
+    if (colorRBO != 0)
+        glDeleteRenderbuffers(1, &colorRBO);
+    if (depthRBO != 0)
+        glDeleteRenderbuffers(1, &depthRBO);
+    FBO = colorRBO = depthRBO = 0;
+    width = height = 0;
+    complete = false;
+}
+
+/**
+ * @brief Renderbuffers cannot be resized in place, so a new size gets new ones.
+ */
+bool SceneFramebuffer::resize(int newWidth, int newHeight)
+{
+    if (newWidth == width && newHeight == height)
+        return complete;
+    release();
+    if (newWidth <= 0 || newHeight <= 0)
+        return false;
+    width = newWidth;
+    height = newHeight;
+
+    glGenFramebuffers(1, &FBO);
+    glGenRenderbuffers(1, &colorRBO);
+    glGenRenderbuffers(1, &depthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+    complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+        std::cerr << "ERROR::SCENE_FRAMEBUFFER: Framebuffer is not complete (" << width << "x" << height << ")" << std::endl;
+    return complete;
+}
+
+/**
+ * @brief Binds the framebuffer for reading and drawing.
+ */
+void SceneFramebuffer::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+}
+
+/**
+ * @brief Blits the color attachment 1:1 (same size, so nearest filtering is exact).
+ */
+void SceneFramebuffer::present() const
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/**
+ * @brief Reads the pixels back (a full pipeline flush) and flips the rows: OpenGL's first row
+ * is the bottom one, PPM's the top one.
+ */
+bool SceneFramebuffer::writePPM(const std::string &path) const
+{
+    if (!complete)
+        return false;
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1); // RGB rows are not necessarily 4-byte aligned
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4); // Back to the default
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cerr << "ERROR::SCENE_FRAMEBUFFER: Cannot write " << path << std::endl;
+        return false;
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    const size_t rowBytes = static_cast<size_t>(width) * 3;
+    bool ok = true;
+    for (int y = height - 1; y >= 0 && ok; --y)
+        ok = std::fwrite(pixels.data() + y * rowBytes, 1, rowBytes, file) == rowBytes;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+        std::cerr << "ERROR::SCENE_FRAMEBUFFER: Failed writing " << path << std::endl;
+    return ok;
+}
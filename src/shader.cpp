@@ -5,11 +5,13 @@
 
 #include "shader.h"
 
+#include <algorithm> // For std::max
+
 /**
- * @brief Constructor: Loads vertex and fragment shader source code from files,
- * compiles the shaders, and links them into a shader program.
+ * @brief Constructor: Loads vertex and fragment shader source code from files, adds the
+ * variant's defines, compiles the shaders, and links them into a shader program.
  */
-Shader::Shader(const char *vertexPath, const char *fragmentPath)
+Shader::Shader(const char *vertexPath, const char *fragmentPath, const std::string &defines)
 {
     // 1. Retrieve the vertex/fragment source code from filePath
     std::string vertexCode;
@@ -40,6 +42,15 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
     {
         std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << " (" << vertexPath << " or " << fragmentPath << ")" << std::endl;
     }
+    if (!defines.empty())
+    {
+        // #version must stay the first line, so the defines go right after it
+        for (std::string *code : {&vertexCode, &fragmentCode})
+        {
+            const size_t lineEnd = code->find('\n');
+            code->insert(lineEnd == std::string::npos ? code->size() : lineEnd + 1, defines);
+        }
+    }
     const char *vShaderCode = vertexCode.c_str();
     const char *fShaderCode = fragmentCode.c_str();
 
@@ -68,6 +79,57 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
     // Delete the shaders as they're now linked into our program and no longer necessary
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    // Look every uniform location up once, so no setter has to ask the driver
+    reflectUniforms();
+}
+
+/**
+ * @brief Enumerates the program's active uniforms. Arrays are reported as "name[0]"; they are
+ * cached under that name and the bare "name", as glGetUniformLocation accepts both.
+ */
+void Shader::reflectUniforms()
+{
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string name(static_cast<size_t>(std::max(maxLength, 1)), '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, &name[0]);
+        const std::string uniformName(name.data(), static_cast<size_t>(length));
+        const GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location < 0)
+            continue; // Block members have no location (set through their buffer)
+        uniforms[uniformName] = {location, type};
+        const size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos)
+            uniforms[uniformName.substr(0, bracket)] = {location, type};
+    }
+}
+
+/**
+ * @brief Looks the block up by name and assigns it the binding point.
+ */
+bool Shader::bindUniformBlock(const char *blockName, GLuint binding) const
+{
+    const GLuint index = glGetUniformBlockIndex(ID, blockName);
+    if (index == GL_INVALID_INDEX)
+        return false;
+    glUniformBlockBinding(ID, index, binding);
+    return true;
+}
+
+/**
+ * @brief Looks a location up in the cache filled by reflectUniforms().
+ */
+GLint Shader::locationOf(const std::string &name) const
+{
+    auto it = uniforms.find(name);
+    return it != uniforms.end() ? it->second.location : -1;
 }
 
 /**
@@ -83,7 +145,7 @@ void Shader::use()
  */
 void Shader::setBool(const std::string &name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(locationOf(name), (int)value);
 }
 
 /**
@@ -91,7 +153,15 @@ void Shader::setBool(const std::string &name, bool value) const
  */
 void Shader::setInt(const std::string &name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(locationOf(name), value);
+}
+
+/**
+ * @brief Sets an unsigned integer uniform variable in the shader program.
+ */
+void Shader::setUint(const std::string &name, unsigned int value) const
+{
+    glUniform1ui(locationOf(name), value);
 }
 
 /**
@@ -99,7 +169,7 @@ void Shader::setInt(const std::string &name, int value) const
  */
 void Shader::setFloat(const std::string &name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(locationOf(name), value);
 }
 
 /**
@@ -107,7 +177,7 @@ void Shader::setFloat(const std::string &name, float value) const
  */
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    glUniform3fv(locationOf(name), 1, &value[0]);
 }
 
 /**
@@ -115,7 +185,7 @@ void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
  */
 void Shader::setVec3(const std::string &name, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(locationOf(name), x, y, z);
 }
 
 /**
@@ -123,7 +193,7 @@ void Shader::setVec3(const std::string &name, float x, float y, float z) const
  */
 void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(locationOf(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 /**
@@ -131,7 +201,7 @@ void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
  */
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(locationOf(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 /**
@@ -0,0 +1,93 @@
+/**
+ * @file sim_clock.cpp
+ * @brief Implements the SimClock class and the fixed-point phase rate conversion.
+ */
+
+#include "sim_clock.h"
+
+#include <algorithm> // For std::clamp
+#include <cmath>     // For std::floor, std::llround
+
+/**
+ * @brief Constructor: Starts at the given time with a warp of 1x.
+ */
+SimClock::SimClock(double startSeconds)
+    : now(toTicks(startSeconds))
+{
+}
+
+/**
+ * @brief Adds the warped interval in ticks; the fractional tick is kept in 'carry'.
+ */
+void SimClock::advance(double wallSeconds)
+{
+    double delta = wallSeconds * warpFactor * static_cast<double>(TICKS_PER_SECOND) + carry;
+    double whole = std::floor(delta); // floor (not truncation) keeps carry in [0, 1) when running backwards
+    carry = delta - whole;
+    now += static_cast<Ticks>(whole);
+}
+
+/**
+ * @brief Jumps to an absolute time and clears the sub-tick carry.
+ */
+void SimClock::seek(double simSeconds)
+{
+    now = toTicks(simSeconds);
+    carry = 0.0;
+}
+
+/**
+ * @brief Stores the warp factor, clamped to the supported range.
+ */
+void SimClock::setWarp(double factor)
+{
+    warpFactor = std::clamp(factor, -MAX_WARP, MAX_WARP);
+}
+
+/**
+ * @brief Current time in seconds (whole seconds and remainder converted separately to keep precision).
+ */
+double SimClock::seconds() const
+{
+    Ticks wholeSeconds = now / TICKS_PER_SECOND;
+    Ticks remainder = now % TICKS_PER_SECOND;
+    return static_cast<double>(wholeSeconds) +
+           (static_cast<double>(remainder) + carry) / static_cast<double>(TICKS_PER_SECOND);
+}
+
+/**
+ * @brief Seconds -> ticks, saturating far outside the clock's range.
+ */
+SimClock::Ticks SimClock::toTicks(double seconds)
+{
+    const double limit = 9.0e18; // Just below INT64_MAX
+    double ticks = std::clamp(seconds * static_cast<double>(TICKS_PER_SECOND), -limit, limit);
+    return static_cast<Ticks>(std::llround(ticks));
+}
+
+/**
+ * @brief radians/second -> 2^-64 revolutions/tick, computed as a signed value and then
+ * reinterpreted as unsigned so negative rates wrap the right way.
+ */
+PhaseRate phaseRateFromSpeed(double radiansPerSecond)
+{
+    const double revolutionsPerTick = radiansPerSecond / (2.0 * 3.14159265358979323846) / static_cast<double>(SimClock::TICKS_PER_SECOND);
+    const double scale = 18446744073709551616.0; // 2^64
+    // Clamp to what fits in int64 (~3e6 rad/s), far beyond any animation speed
+    double fixed = std::clamp(revolutionsPerTick * scale, -9.0e18, 9.0e18);
+    return static_cast<PhaseRate>(static_cast<std::int64_t>(std::llround(fixed)));
+}
+
+/**
+ * @brief radians -> 2^-64 revolutions. The angle is wrapped to [-pi, pi) in double first,
+ * so the fixed-point conversion never overflows.
+ */
+std::uint64_t phaseFromAngle(double radians)
+{
+    const double twoPi = 2.0 * 3.14159265358979323846;
+    double revolutions = radians / twoPi;
+    revolutions -= std::floor(revolutions + 0.5); // [-0.5, 0.5)
+    const double scale = 18446744073709551616.0;  // 2^64
+    double fixed = std::clamp(revolutions * scale, -9.2e18, 9.2e18); // Guard the +0.5 rounding edge
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(std::llround(fixed)));
+}
@@ -0,0 +1,299 @@
+/**
+ * @file sim_thread.cpp
+ * @brief Implements the fixed-timestep SimulationThread and snapshot interpolation.
+ */
+
+#include "sim_thread.h"
+#include "simulation.h" // For Simulation::step / seek
+
+#include <glm/gtc/constants.hpp>  // For glm::pi
+#include <glm/gtc/quaternion.hpp> // For blending rotations
+
+#include <algorithm> // For std::clamp, std::max
+#include <chrono>    // For the steady clock and sleep_until
+#include <cmath>     // For std::llround, std::cos, std::abs
+
+// If the simulation falls this many ticks behind (e.g. a debugger pause), skip ahead
+// instead of trying to catch up, so a stall does not turn into a burst of ticks.
+static const int MAX_CATCH_UP_TICKS = 8;
+
+// Largest turn of a body between two ticks that interpolate() blends. Beyond it (high time
+// warps) neither the direction nor the number of turns can be told from the two orientations,
+// so the newer one is shown.
+static const float MAX_BLEND_ANGLE = glm::pi<float>() / 4.0f;
+
+/**
+ * @brief How far @p now is past the time 'current' was due, in ticks, clamped to one tick.
+ */
+float SimSnapshot::blendFactor(double now) const
+{
+    if (tickInterval <= 0.0)
+        return 1.0f;
+    return static_cast<float>(std::clamp((now - tickTime) / tickInterval, 0.0, 1.0));
+}
+
+/**
+ * @brief Same blend as interpolate(), applied to the tick times (rounded to a whole tick).
+ */
+SimClock::Ticks SimSnapshot::interpolatedTicks(double now) const
+{
+    const double span = static_cast<double>(currentTicks - previousTicks);
+    return previousTicks + static_cast<SimClock::Ticks>(std::llround(span * blendFactor(now)));
+}
+
+/**
+ * @brief Splits the upper 3x3 of @p world into a rotation and the column lengths (@p scale).
+ */
+static glm::quat splitRotation(const glm::mat4 &world, glm::vec3 &scale)
+{
+    glm::mat3 rotation;
+    for (int c = 0; c < 3; ++c)
+    {
+        scale[c] = glm::length(glm::vec3(world[c]));
+        rotation[c] = glm::vec3(world[c]) / std::max(scale[c], 1e-30f);
+    }
+    return glm::quat_cast(rotation);
+}
+
+/**
+ * @brief A world matrix is translate * rotate * scale (scale and rotation are not inherited, see
+ * hierarchy.cpp), so its first three columns are the rotation's scaled by the column lengths.
+ * Positions and translations are blended linearly (the positions with a double factor, so the
+ * blend adds no float rounding to far-away positions), column lengths linearly and rotations by
+ * slerp. A linear blend of the rotation columns would shrink and skew the matrix, down to zero
+ * at half a turn, and with it the bounding radii and level of detail derived from it.
+ */
+void SimSnapshot::interpolate(double now, std::vector<glm::mat4> &out, std::vector<glm::dvec3> &positions) const
+{
+    out.resize(current.size());
+    positions.resize(currentPositions.size());
+    const float alpha = blendFactor(now);
+    for (size_t i = 0; i < currentPositions.size(); ++i)
+    {
+        positions[i] = previousPositions[i] + (currentPositions[i] - previousPositions[i]) * static_cast<double>(alpha);
+    }
+    const float minDot = std::cos(MAX_BLEND_ANGLE * 0.5f); // |dot| of two unit quaternions MAX_BLEND_ANGLE apart
+    for (size_t i = 0; i < current.size(); ++i)
+    {
+        const glm::mat4 &a = previous[i];
+        const glm::mat4 &b = current[i];
+        if (a == b)
+        {
+            out[i] = b; // Not moving (most nodes while paused, fixed bodies always)
+            continue;
+        }
+        glm::vec3 scaleA, scaleB;
+        const glm::quat rotationA = splitRotation(a, scaleA);
+        const glm::quat rotationB = splitRotation(b, scaleB);
+        glm::mat4 &m = out[i];
+        if (std::abs(glm::dot(rotationA, rotationB)) < minDot)
+        {
+            m = b; // Turned too far within one tick to blend: alpha = 1 for the orientation
+        }
+        else
+        {
+            const glm::mat3 rotation = glm::mat3_cast(glm::slerp(rotationA, rotationB, alpha)); // Shortest arc
+            const glm::vec3 scale = scaleA + (scaleB - scaleA) * alpha;
+            for (int c = 0; c < 3; ++c)
+                m[c] = glm::vec4(rotation[c] * scale[c], 0.0f);
+        }
+        m[3] = a[3] + (b[3] - a[3]) * alpha;
+    }
+}
+
+/**
+ * @brief Builds the snapshot every slot starts with: the current state, with previous == current.
+ */
+static SimSnapshot makeInitialSnapshot(const Simulation &simulation, double tickInterval)
+{
+    SimSnapshot snapshot;
+    snapshot.simTime = simulation.time();
+    snapshot.currentTicks = simulation.ticks();
+    snapshot.previousTicks = snapshot.currentTicks;
+    snapshot.warp = simulation.warp();
+    snapshot.tickTime = SimulationThread::clockSeconds();
+    snapshot.tickInterval = tickInterval;
+    snapshot.current = simulation.worldMatrices();
+    snapshot.previous = snapshot.current;
+    snapshot.currentPositions = simulation.worldPositions();
+    snapshot.previousPositions = snapshot.currentPositions;
+    snapshot.transformsRecomputed = simulation.hierarchy().recomputedCount();
+    if (simulation.hasNBody())
+    {
+        snapshot.particles = simulation.particlePositions();
+        snapshot.particlesPrevious = snapshot.particles;
+        snapshot.particleOrigin = simulation.particleOrigin();
+        snapshot.particleOriginPrevious = snapshot.particleOrigin;
+        snapshot.nbodyStats = simulation.nbodyStats();
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Constructor: Publishes the current state so the renderer has data before the first tick.
+ */
+SimulationThread::SimulationThread(Simulation &simulation, double tickRate)
+    : simulation(simulation),
+      tickInterval(1.0 / std::max(tickRate, 1.0)),
+      snapshots(makeInitialSnapshot(simulation, 1.0 / std::max(tickRate, 1.0)))
+{
+    lastTick = simulation.worldMatrices();
+    lastPositions = simulation.worldPositions();
+    lastTicks = simulation.ticks();
+    if (simulation.hasNBody())
+    {
+        lastParticles = simulation.particlePositions();
+        lastParticleOrigin = simulation.particleOrigin();
+    }
+}
+
+/**
+ * @brief Destructor: Makes sure the thread does not outlive the objects it references.
+ */
+SimulationThread::~SimulationThread()
+{
+    stop();
+}
+
+/**
+ * @brief Starts the simulation thread (no-op if already running).
+ */
+void SimulationThread::start()
+{
+    if (running.exchange(true))
+        return;
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+/**
+ * @brief Signals the thread to finish its current tick and joins it.
+ */
+void SimulationThread::stop()
+{
+    running.store(false);
+    if (thread.joinable())
+        thread.join();
+}
+
+/**
+ * @brief Stores the target time; the simulation thread picks it up at its next tick.
+ */
+void SimulationThread::seek(double simSeconds)
+{
+    seekTarget.store(simSeconds, std::memory_order_relaxed);
+    seekPending.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Seconds on the steady (monotonic) clock.
+ */
+double SimulationThread::clockSeconds()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Thread body: advance, publish, sleep until the next tick is due.
+ */
+void SimulationThread::run()
+{
+    double nextTickTime = clockSeconds() + tickInterval;
+    unsigned long long tick = snapshots.writeBuffer().tick;
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        // Sleep until the tick is due (the render thread is never blocked by this)
+        double now = clockSeconds();
+        if (now < nextTickTime)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(nextTickTime - now));
+            continue; // Re-check the stop flag and the clock
+        }
+        if (now - nextTickTime > MAX_CATCH_UP_TICKS * tickInterval)
+        {
+            nextTickTime = now; // Too far behind: drop the missed ticks
+        }
+
+        // --- Advance one fixed step (or jump) ---
+        // Either way every analytic body is evaluated directly at the new time, so the cost of
+        // a tick is the same at 1x, at 1e7x, and after a seek. N-body state has to be integrated
+        // (capped at NBodySettings::maxSubsteps steps) or, after a seek, restarted.
+        bool jumped = seekPending.exchange(false, std::memory_order_acquire);
+        simulation.setWarp(warpFactor.load(std::memory_order_relaxed));
+        if (jumped)
+            simulation.seek(seekTarget.load(std::memory_order_relaxed));
+        else
+            simulation.step(tickInterval);
+        const bool timeMoved = jumped || simulation.ticks() != lastTicks;
+        const bool nbody = simulation.hasNBody();
+        const TransformHierarchy &hierarchy = simulation.hierarchy();
+        ++tick;
+
+        // New content versions. While paused nothing is recomputed, the versions stay put, and
+        // the copies below are skipped for every slot that already holds the same data.
+        const unsigned long long lastTransformVersion = transformVersion;
+        const unsigned long long lastParticleVersion = particleVersion;
+        if (jumped || hierarchy.recomputedCount() > 0)
+            ++transformVersion;
+        if (nbody && timeMoved)
+            ++particleVersion;
+
+        // --- Publish the last two ticks ---
+        SimSnapshot &snapshot = snapshots.writeBuffer();
+        snapshot.tick = tick;
+        snapshot.simTime = simulation.time();
+        snapshot.currentTicks = simulation.ticks();
+        snapshot.previousTicks = jumped ? snapshot.currentTicks : lastTicks;
+        lastTicks = snapshot.currentTicks;
+        snapshot.warp = simulation.warp();
+        snapshot.tickTime = nextTickTime;
+        snapshot.tickInterval = tickInterval;
+        snapshot.transformsRecomputed = hierarchy.recomputedCount();
+
+        // Same size every tick, so these copies do not reallocate. Never blend across a jump.
+        const unsigned long long previousTransformVersion = jumped ? transformVersion : lastTransformVersion;
+        if (snapshot.transformVersion != transformVersion)
+        {
+            snapshot.current = hierarchy.worldMatrices();
+            snapshot.currentPositions = hierarchy.worldPositions();
+        }
+        if (snapshot.previousTransformVersion != previousTransformVersion)
+        {
+            snapshot.previous = jumped ? snapshot.current : lastTick;
+            snapshot.previousPositions = jumped ? snapshot.currentPositions : lastPositions;
+        }
+        snapshot.transformVersion = transformVersion;
+        snapshot.previousTransformVersion = previousTransformVersion;
+        if (transformVersion != lastTransformVersion)
+        {
+            lastTick = snapshot.current;
+            lastPositions = snapshot.currentPositions;
+        }
+        if (nbody)
+        {
+            const unsigned long long previousParticleVersion = jumped ? particleVersion : lastParticleVersion;
+            if (snapshot.particleVersion != particleVersion)
+            {
+                snapshot.particles = simulation.particlePositions();
+                snapshot.particleOrigin = simulation.particleOrigin();
+            }
+            if (snapshot.previousParticleVersion != previousParticleVersion)
+            {
+                snapshot.particlesPrevious = jumped ? snapshot.particles : lastParticles;
+                snapshot.particleOriginPrevious = jumped ? snapshot.particleOrigin : lastParticleOrigin;
+            }
+            snapshot.particleVersion = particleVersion;
+            snapshot.previousParticleVersion = previousParticleVersion;
+            snapshot.nbodyStats = simulation.nbodyStats();
+            if (particleVersion != lastParticleVersion)
+            {
+                lastParticles = snapshot.particles;
+                lastParticleOrigin = snapshot.particleOrigin;
+            }
+        }
+        snapshots.publish();
+
+        nextTickTime += tickInterval;
+    }
+}
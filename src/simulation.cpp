@@ -0,0 +1,42 @@
+/**
+ * @file simulation.cpp
+ * @brief Implements the Simulation class: clock handling around the hierarchy and N-body updates.
+ */
+
+#include "simulation.h"
+#include "scenario.h" // For Scenario
+
+/**
+ * @brief Constructor: Compiles the scenario and evaluates the initial state.
+ */
+Simulation::Simulation(const Scenario &scenario, const SimulationSettings &settings)
+    : pool(settings.workerThreads),
+      transforms(scenario),
+      nbodySystem(scenario, transforms, settings.nbody),
+      clock(settings.startTime)
+{
+    seek(settings.startTime);
+}
+
+/**
+ * @brief One fixed step: N-body bodies first, so the hierarchy sees their new positions.
+ */
+void Simulation::step(double dt)
+{
+    clock.advance(dt);
+    if (hasNBody())
+        nbodySystem.advanceTo(clock.ticks(), &pool);
+    transforms.update(clock.ticks(), &pool);
+}
+
+/**
+ * @brief Jump: analytic bodies are evaluated directly at the new time; N-body state cannot be
+ * integrated across an arbitrary jump, so it restarts from the scenario's orbits there.
+ */
+void Simulation::seek(double simSeconds)
+{
+    clock.seek(simSeconds);
+    if (hasNBody())
+        nbodySystem.reset(clock.ticks(), &pool);
+    transforms.update(clock.ticks(), &pool);
+}
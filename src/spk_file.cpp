@@ -0,0 +1,216 @@
+/**
+ * @file spk_file.cpp
+ * @brief Implements the SpkFile class: file mapping and DAF summary parsing.
+ */
+
+#include "spk_file.h"
+
+#include <cstdint>  // For std::int32_t
+#include <cstring>  // For std::memcmp, std::memcpy
+#include <iostream> // For errors and warnings (std::cerr)
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h> // For CreateFileMapping / MapViewOfFile
+#else
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#endif
+
+static const size_t RECORD_BYTES = 1024; // DAF physical record size (128 doubles)
+static const size_t SUMMARY_DOUBLES = 5; // SPK summary: 2 doubles + 6 ints packed into 3 doubles
+
+/**
+ * @brief Constructor: Maps the file and indexes its segments.
+ */
+SpkFile::SpkFile(const std::string &path)
+{
+    if (!map(path))
+        return;
+    if (!readSummaries(path))
+    {
+        segmentList.clear();
+        unmap();
+        return;
+    }
+    if (segmentList.empty())
+    {
+        std::cerr << "Error: SPK file '" << path << "' has no type 2 or 3 segments." << std::endl;
+        unmap();
+    }
+}
+
+/**
+ * @brief Destructor: Releases the mapping.
+ */
+SpkFile::~SpkFile()
+{
+    unmap();
+}
+
+/**
+ * @brief Maps the whole file read-only.
+ */
+bool SpkFile::map(const std::string &path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER length;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &length) || length.QuadPart == 0)
+    {
+        std::cerr << "Error: Cannot open SPK file '" << path << "'." << std::endl;
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        std::cerr << "Error: Cannot map SPK file '" << path << "'." << std::endl;
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char *>(view);
+    size = static_cast<size_t>(length.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        std::cerr << "Error: Cannot open SPK file '" << path << "'." << std::endl;
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file referenced
+    if (view == MAP_FAILED)
+    {
+        std::cerr << "Error: Cannot map SPK file '" << path << "'." << std::endl;
+        return false;
+    }
+    data = static_cast<const unsigned char *>(view);
+    size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+/**
+ * @brief Releases the mapping (no-op if nothing is mapped).
+ */
+void SpkFile::unmap()
+{
+    if (!data)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char *>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+/**
+ * @brief Walks the DAF summary record chain and records every type 2/3 segment.
+ *
+ * File record: "DAF/SPK " id, ND (doubles per summary) and NI (ints per summary) at bytes 8
+ * and 12, the first summary record number at byte 76 and the byte order at byte 88. Each
+ * summary record holds (next, previous, count) followed by count summaries; a segment's data
+ * ends with (initial time, interval length, record size, record count).
+ */
+bool SpkFile::readSummaries(const std::string &path)
+{
+    if (size < RECORD_BYTES || (std::memcmp(data, "DAF/SPK ", 8) != 0 && std::memcmp(data, "NAIF/DAF", 8) != 0))
+    {
+        std::cerr << "Error: '" << path << "' is not an SPK file." << std::endl;
+        return false;
+    }
+    std::int32_t nd = 0, ni = 0, forward = 0;
+    std::memcpy(&nd, data + 8, 4);
+    std::memcpy(&ni, data + 12, 4);
+    std::memcpy(&forward, data + 76, 4);
+
+    const std::uint16_t probe = 1;
+    const bool littleEndian = *reinterpret_cast<const unsigned char *>(&probe) == 1;
+    const bool fileLittle = std::memcmp(data + 88, "LTL-IEEE", 8) == 0;
+    const bool fileBig = std::memcmp(data + 88, "BIG-IEEE", 8) == 0;
+    if ((fileLittle && !littleEndian) || (fileBig && littleEndian) || nd != 2 || ni != 6)
+    {
+        std::cerr << "Error: SPK file '" << path << "' is in another byte order or layout"
+                  << " (convert it with NAIF's toxfr/tobin)." << std::endl;
+        return false;
+    }
+
+    const double *words = reinterpret_cast<const double *>(data); // The mapping is page aligned
+    const size_t wordCount = size / sizeof(double);
+    size_t visited = 0;
+    for (std::int32_t record = forward; record > 0; ++visited)
+    {
+        const size_t offset = static_cast<size_t>(record - 1) * RECORD_BYTES;
+        if (offset + RECORD_BYTES > size || visited > size / RECORD_BYTES)
+        {
+            std::cerr << "Error: SPK file '" << path << "' has a broken summary chain." << std::endl;
+            return false;
+        }
+        const double *summaries = words + offset / sizeof(double);
+        const size_t count = static_cast<size_t>(summaries[2]);
+        for (size_t s = 0; s < count && 3 + (s + 1) * SUMMARY_DOUBLES <= RECORD_BYTES / sizeof(double); ++s)
+        {
+            const double *summary = summaries + 3 + s * SUMMARY_DOUBLES;
+            std::int32_t ints[6];
+            std::memcpy(ints, summary + 2, sizeof(ints));
+
+            Segment segment;
+            segment.startTime = summary[0];
+            segment.endTime = summary[1];
+            segment.target = ints[0];
+            segment.center = ints[1];
+            segment.frame = ints[2];
+            segment.type = ints[3];
+            if (segment.type != 2 && segment.type != 3)
+            {
+                std::cerr << "Warning: Skipping SPK segment of type " << segment.type << " (target " << segment.target
+                          << ") in '" << path << "'." << std::endl;
+                continue;
+            }
+
+            // Addresses are 1-based, inclusive double-word indices
+            const size_t begin = static_cast<size_t>(ints[4]), end = static_cast<size_t>(ints[5]);
+            if (begin < 1 || end > wordCount || end < begin + 4)
+            {
+                std::cerr << "Warning: Skipping a malformed SPK segment (target " << segment.target << ")." << std::endl;
+                continue;
+            }
+            const double *trailer = words + end - 4;
+            const size_t components = segment.type == 2 ? 3 : 6;
+            segment.records = words + begin - 1;
+            segment.initialTime = trailer[0];
+            segment.intervalLength = trailer[1];
+            segment.recordSize = static_cast<size_t>(trailer[2]);
+            segment.recordCount = static_cast<size_t>(trailer[3]);
+            segment.coefficientCount = segment.recordSize > 2 ? (segment.recordSize - 2) / components : 0;
+            if (segment.coefficientCount == 0 || segment.recordCount == 0 || !(segment.intervalLength > 0.0) ||
+                segment.recordCount * segment.recordSize + 4 > end - begin + 1)
+            {
+                std::cerr << "Warning: Skipping a malformed SPK segment (target " << segment.target << ")." << std::endl;
+                continue;
+            }
+            segmentList.push_back(segment);
+        }
+        record = static_cast<std::int32_t>(summaries[0]);
+    }
+    return true;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file stream_buffer.cpp
+ * @brief Implements the StreamBuffer class and loads the GL 4.4 buffer storage entry point.
+ */
+
+#include "stream_buffer.h"
+
+#include <algorithm> // For std::max
+#include <chrono>    // For timing stalls
+#include <cstring>   // For std::strcmp
+
+PFNGLBUFFERSTORAGEPROC solar_glBufferStorage = nullptr;
+StreamStats StreamBuffer::stats;
+
+/**
+ * @brief Checks the version GLAD found, then the extension list, before looking the function
+ * up (drivers may return a non-null pointer for functions they do not support).
+ */
+bool loadBufferStorage(GLADloadproc load)
+{
+    solar_glBufferStorage = nullptr;
+    bool supported = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 4);
+    GLint extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (GLint i = 0; i < extensions && !supported; ++i)
+    {
+        const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        supported = name && std::strcmp(name, "GL_ARB_buffer_storage") == 0;
+    }
+    if (supported)
+        solar_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+    return solar_glBufferStorage != nullptr;
+}
+
+/**
+ * @brief Destructor: Cleans up the buffer and fences.
+ */
+StreamBuffer::~StreamBuffer()
+{
+    release();
+}
+
+/**
+ * @brief Unmaps the persistent mapping (an active GL 3.3 mapping is ended too) and deletes everything.
+ */
+void StreamBuffer::release()
+{
+    if (id != 0 && (persistentBase || mapped))
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    for (GLsync &fence : fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (id != 0)
+        glDeleteBuffers(1, &id);
+    id = 0;
+    regionBytes = stride = 0;
+    current = REGIONS - 1;
+    pending = mapped = false;
+    persistentBase = nullptr;
+}
+
+/**
+ * @brief Regions start at multiples of the uniform buffer offset alignment (256 bytes or less
+ * on current hardware), which satisfies vertex and indirect buffers as well. Buffer storage is
+ * immutable, so a new size always means a new buffer; if the persistent mapping fails, the
+ * buffer is recreated for the GL 3.3 path.
+ */
+void StreamBuffer::allocate(GLsizeiptr bytes)
+{
+    release();
+    if (bytes <= 0)
+        return;
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const GLsizeiptr align = std::max<GLsizeiptr>(alignment, 16);
+    regionBytes = bytes;
+    stride = (bytes + align - 1) / align * align;
+
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+    if (glBufferStorage)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, stride * REGIONS, nullptr, flags);
+        persistentBase = static_cast<char *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, stride * REGIONS, flags));
+        if (!persistentBase)
+        {
+            glDeleteBuffers(1, &id);
+            glGenBuffers(1, &id);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        }
+    }
+    if (!persistentBase)
+        glBufferData(GL_COPY_WRITE_BUFFER, stride * REGIONS, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+/**
+ * @brief Fences the region written last, moves on, and (persistent path) waits until the GPU
+ * is done with the new region: first a zero-timeout poll, then, counted as a stall, blocking
+ * waits that flush the command queue.
+ */
+void *StreamBuffer::map()
+{
+    if (id == 0)
+        return nullptr;
+    if (persistentBase)
+    {
+        if (pending)
+        {
+            fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            pending = false;
+        }
+        current = (current + 1) % REGIONS;
+        if (GLsync fence = fences[current])
+        {
+            if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) // 1 ms steps
+                {
+                }
+                ++stats.stalls;
+                stats.stallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            }
+            glDeleteSync(fence);
+            fences[current] = nullptr;
+        }
+        pending = true;
+        ++stats.writes;
+        return persistentBase + offset();
+    }
+
+    current = (current + 1) % REGIONS;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+    if (current == 0)
+        glBufferData(GL_COPY_WRITE_BUFFER, stride * REGIONS, nullptr, GL_STREAM_DRAW); // Orphan: pending draws keep the old storage
+    void *region = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset(), regionBytes,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    mapped = region != nullptr;
+    if (!mapped)
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    ++stats.writes;
+    return region;
+}
+
+/**
+ * @brief Nothing to do for the coherent persistent mapping; ends the GL 3.3 mapping.
+ */
+void StreamBuffer::unmap()
+{
+    if (!mapped)
+        return;
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    mapped = false;
+}
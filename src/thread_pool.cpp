@@ -0,0 +1,126 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implements the ThreadPool class.
+ */
+
+#include "thread_pool.h"
+
+/**
+ * @brief Constructor: Spawns threadCount - 1 workers that sleep until a loop is submitted.
+ */
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0)
+            threadCount = 1; // hardware_concurrency() may not be computable
+    }
+    workers.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Destructor: Wakes all workers with the stop flag set and joins them.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Publishes the job, helps run it on the calling thread, then waits for stragglers.
+ */
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)> &fn)
+{
+    if (end <= begin)
+        return;
+    if (grain == 0)
+        grain = 1;
+    // Small loops (or no workers): not worth waking anyone
+    if (workers.empty() || end - begin <= grain)
+    {
+        for (size_t first = begin; first < end; first += grain)
+            fn(first, first + grain < end ? first + grain : end);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobFn = &fn;
+        jobBegin = begin;
+        jobEnd = end;
+        jobGrain = grain;
+        jobChunks = (end - begin + grain - 1) / grain;
+        nextChunk.store(0, std::memory_order_relaxed);
+        chunksDone.store(0, std::memory_order_relaxed);
+        ++jobGeneration;
+    }
+    wakeCondition.notify_all();
+
+    runChunks(); // The caller works too
+
+    // Wait until every chunk has finished and every worker has left runChunks(),
+    // so the next job can safely overwrite the job fields (and fn can go out of scope)
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this]
+                       { return chunksDone.load(std::memory_order_acquire) == jobChunks && busyWorkers == 0; });
+    jobFn = nullptr;
+}
+
+/**
+ * @brief Claims and runs chunks of the current job until none are left.
+ */
+void ThreadPool::runChunks()
+{
+    size_t chunk;
+    while ((chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < jobChunks)
+    {
+        size_t first = jobBegin + chunk * jobGrain;
+        size_t last = first + jobGrain < jobEnd ? first + jobGrain : jobEnd;
+        (*jobFn)(first, last);
+        if (chunksDone.fetch_add(1, std::memory_order_acq_rel) + 1 == jobChunks)
+        {
+            // Last chunk: wake the submitting thread (lock so the wakeup cannot be missed)
+            std::lock_guard<std::mutex> lock(mutex);
+            doneCondition.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Worker body: sleeps until a new job generation (or shutdown) is published.
+ */
+void ThreadPool::workerLoop()
+{
+    unsigned long long seenGeneration = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&]
+                               { return stopping || (jobGeneration != seenGeneration && jobFn != nullptr); });
+            if (stopping)
+                return;
+            seenGeneration = jobGeneration;
+            ++busyWorkers;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        doneCondition.notify_one();
+    }
+}